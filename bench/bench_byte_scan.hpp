@@ -0,0 +1,86 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef bench_byte_scan_hpp
+#define bench_byte_scan_hpp
+
+#include "bench_common.hpp"
+
+#include "byte_scan.hpp"
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <iostream>
+
+namespace bench_byte_scan_internal{
+	inline void bench_find_first_of(const std::string& task_file, const byte_scan::Kernel kernel){
+		const char* const first = task_file.data();
+		const char* const last = task_file.data() + task_file.size();
+		
+		//Separating lines only, like task_io_internal::buffer_to_line_views().
+		std::size_t line_count = 0;
+		const double line_seconds = bench::measure_seconds([&](){
+			line_count = 0;
+			for(const char* line_start = first; line_start < last; ){
+				const char* const line_end = byte_scan::find_first_of(kernel, line_start, last, '\n');
+				line_count++;
+				line_start = line_end + 1;
+			}
+			bench::do_not_optimize(line_count);
+		});
+		
+		//Separating lines, then the due date and name of each line, like TaskFileParser.
+		std::size_t comma_count = 0;
+		const double field_seconds = bench::measure_seconds([&](){
+			comma_count = 0;
+			for(const char* line_start = first; line_start < last; ){
+				const char* const line_end = byte_scan::find_first_of(kernel, line_start, last, '\n');
+				comma_count += byte_scan::find_first_of(kernel, line_start, line_end, ',') != line_end;
+				line_start = line_end + 1;
+			}
+			bench::do_not_optimize(comma_count);
+		});
+		
+		//Every delimiter of the task file.
+		std::size_t delimiter_count = 0;
+		const double delimiter_seconds = bench::measure_seconds([&](){
+			delimiter_count = 0;
+			for(const char* c = first; c < last; ++c){
+				c = byte_scan::find_first_of(kernel, c, last, {'\n', ',', '{', '}'});
+				delimiter_count++;
+			}
+			bench::do_not_optimize(delimiter_count);
+		});
+		
+		std::cout << "[byte_scan] " << byte_scan::kernel_name(kernel) << ":\t"
+				<< "lines " << bench::gigabytes_per_second(task_file.size(), line_seconds) << " GB/s,\t"
+				<< "lines and fields " << bench::gigabytes_per_second(task_file.size(), field_seconds) << " GB/s,\t"
+				<< "all delimiters " << bench::gigabytes_per_second(task_file.size(), delimiter_seconds) << " GB/s"
+				<< " (" << line_count << " lines)\n";
+	}
+}
+
+inline void bench_suite_byte_scan(){
+	constexpr std::size_t task_file_size = 100 * 1000 * 1000;
+	const std::string task_file = bench::generate_task_file(task_file_size);
+	
+	std::cout << "[byte_scan] synthetic task file: " << task_file.size() / 1e6 << " MB, active kernel: " 
+			<< byte_scan::kernel_name(byte_scan::active_kernel()) << '\n';
+	
+	for(const byte_scan::Kernel kernel : {byte_scan::Kernel::Scalar, byte_scan::Kernel::SSE2, byte_scan::Kernel::AVX2}){
+		if(byte_scan::kernel_supported(kernel))
+			bench_byte_scan_internal::bench_find_first_of(task_file, kernel);
+	}
+}
+
+#endif
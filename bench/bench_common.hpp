@@ -0,0 +1,151 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef bench_common_hpp
+#define bench_common_hpp
+
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <random>
+#include <string>
+#include <cstddef>
+#include <algorithm>
+
+/**
+\file bench_common.hpp
+Utilities shared by the benchmarks.
+*/
+
+namespace bench{
+	///The count of calls to the global operator new, which bench_main.cpp replaces for counting the allocations of a benchmark.
+	inline std::atomic<std::size_t> allocation_count = 0;
+	
+	///Returns the allocations made by running the function once.
+	template<typename Function>
+	std::size_t count_allocations(Function&& function){
+		const std::size_t allocation_count_before = allocation_count.load(std::memory_order_relaxed);
+		function();
+		return allocation_count.load(std::memory_order_relaxed) - allocation_count_before;
+	}
+	
+	///Runs the function the given amount of times and returns the fastest run in seconds.
+	///The fastest run is the one least disturbed by the rest of the system.
+	template<typename Function>
+	double measure_seconds(Function&& function, const int repetitions = 3){
+		double fastest_seconds = std::numeric_limits<double>::max();
+		
+		for(int i = 0; i < repetitions; ++i){
+			const auto start = std::chrono::steady_clock::now();
+			function();
+			const auto end = std::chrono::steady_clock::now();
+			
+			const double seconds = std::chrono::duration<double>(end - start).count();
+			if(seconds < fastest_seconds) fastest_seconds = seconds;
+		}
+		
+		return fastest_seconds;
+	}
+	
+	///Returns the throughput of processing the given amount of bytes in the given seconds, in GB/s.
+	inline double gigabytes_per_second(const std::size_t bytes, const double seconds){
+		return double(bytes) / seconds / 1e9;
+	}
+	
+	///Generates a task file of roughly the given size, with a group of 2 to 9 tasks every 10 lines or so.
+	inline std::string generate_task_file(const std::size_t size){
+		std::string task_file;
+		task_file.reserve(size + 64);
+		
+		std::mt19937 rng(12345);
+		std::uniform_int_distribution<int> month(1, 12), day(1, 28), name_length(4, 40), group_chance(0, 9), group_size(2, 9);
+		
+		const auto append_task = [&](){
+			task_file += "2025/" + std::to_string(month(rng)) + '/' + std::to_string(day(rng)) + ", ";
+			task_file.append(name_length(rng), 'a' + rng() % 26);
+			task_file += '\n';
+		};
+		
+		while(task_file.size() < size){
+			if(group_chance(rng) == 0){
+				task_file += "group " + std::to_string(task_file.size()) + "{\n";
+				for(int i = group_size(rng); i > 0; --i) append_task();
+				task_file += "}\n";
+			}
+			else append_task();
+		}
+		
+		return task_file;
+	}
+	
+	///The shape of a task file generated by generate_task_file().
+	struct TaskFileShape{
+		std::size_t task_count;
+		///The tasks of each group, 1 for single tasks only. Groups cannot be nested in the task file, so a deep task file is one of large groups.
+		std::size_t group_size = 1;
+		std::size_t name_length = 16;
+		///The percentage of tasks with an invalid due date, either month 13 or February 30.
+		unsigned invalid_due_date_percent = 0;
+	};
+	
+	///Returns the shape as text for the reports, such as "100000 tasks, groups of 50, 16 character names, 10% invalid due dates".
+	inline std::string describe(const TaskFileShape& shape){
+		std::string description = std::to_string(shape.task_count) + " tasks, ";
+		description += (shape.group_size == 1) ? std::string("single tasks") : "groups of " + std::to_string(shape.group_size);
+		description += ", " + std::to_string(shape.name_length) + " character names";
+		if(shape.invalid_due_date_percent != 0) description += ", " + std::to_string(shape.invalid_due_date_percent) + "% invalid due dates";
+		return description;
+	}
+	
+	///Generates a task file of the shape. The random numbers are seeded the same every time, so a shape always generates the same task file.
+	inline std::string generate_task_file(const TaskFileShape& shape){
+		std::string task_file;
+		//the due date, its comma and space and the newline are at most 13 characters.
+		task_file.reserve(shape.task_count * (shape.name_length + 13) + (shape.task_count / shape.group_size + 1) * 24);
+		
+		std::mt19937 rng(12345);
+		std::uniform_int_distribution<int> year(2024, 2026), month(1, 12), day(1, 28), percent(0, 99), letter('a', 'z');
+		
+		const auto append_task = [&](){
+			if(percent(rng) < int(shape.invalid_due_date_percent))
+				task_file += (percent(rng) % 2 == 0) ? "2025/13/" + std::to_string(day(rng)) : std::string("2025/2/30");
+			else
+				task_file += std::to_string(year(rng)) + '/' + std::to_string(month(rng)) + '/' + std::to_string(day(rng));
+			
+			task_file += ", ";
+			for(std::size_t i = 0; i < shape.name_length; ++i) task_file += char(letter(rng));
+			task_file += '\n';
+		};
+		
+		for(std::size_t task_index = 0; task_index < shape.task_count; ){
+			const std::size_t group_task_count = std::min(shape.group_size, shape.task_count - task_index);
+			if(group_task_count == 1){
+				append_task();
+			}else{
+				task_file += "group " + std::to_string(task_index) + "{\n";
+				for(std::size_t i = 0; i < group_task_count; ++i) append_task();
+				task_file += "}\n";
+			}
+			task_index += group_task_count;
+		}
+		
+		return task_file;
+	}
+	
+	///Stops the compiler from optimising away a result which is otherwise unused.
+	template<typename T>
+	void do_not_optimize(const T& value){
+		asm volatile("" : : "r,m"(value) : "memory");
+	}
+}
+
+#endif
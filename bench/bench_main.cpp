@@ -0,0 +1,58 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "bench_byte_scan.hpp"
+#include "bench_task_io.hpp"
+#include "bench_task_exchange.hpp"
+#include "bench_task_io_stages.hpp"
+
+#include <new>
+#include <string>
+#include <cstdlib>
+#include <iostream>
+
+//Counts every allocation for bench::count_allocations(). The array and aligned forms of operator new call these by default.
+void* operator new(const std::size_t size){
+	bench::allocation_count.fetch_add(1, std::memory_order_relaxed);
+	if(void* const memory = std::malloc(size == 0 ? 1 : size)) return memory;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* const memory) noexcept{
+	std::free(memory);
+}
+
+void operator delete(void* const memory, const std::size_t) noexcept{
+	std::free(memory);
+}
+
+///bench.exe [max task count], the largest task file of bench_suite_task_io_stages(), a million tasks by default.
+int main(const int argc, const char* const* const argv){
+	try{
+		const std::size_t max_task_count = (argc > 1) ? std::stoull(argv[1]) : 1000 * 1000;
+		
+		std::clog << "Running benchmarks. Build with make bench, which compiles with optimisations, for meaningful numbers.\n";
+		bench_suite_byte_scan();
+		bench_suite_task_io();
+		bench_suite_task_exchange();
+		bench_suite_task_io_stages(max_task_count);
+		return 0;
+	}
+	catch(const std::exception& excp){
+		std::cerr << "[Benchmark Failed]: caught an unspecified exception.\n";
+		std::cerr << "\tMessage of the exception: " << excp.what() << '\n';
+	}
+	catch(...){
+		std::cerr << "[Benchmark Failed]: caught an unspecified throw.\n";
+	}
+	return -1;
+}
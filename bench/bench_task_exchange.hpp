@@ -0,0 +1,94 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef bench_task_exchange_hpp
+#define bench_task_exchange_hpp
+
+#include "bench_common.hpp"
+
+#include "task_io.hpp"
+#include "task_exchange.hpp"
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+
+namespace bench_task_exchange_internal{
+	///Reads the characters with a Reader fed 64 KiB at a time, as task_exchange::read() reads a file.
+	inline std::vector<TaskGroup> read_in_chunks(const std::string& buffer, const task_exchange::Format format){
+		constexpr std::size_t chunk_size = 64 * 1024;
+		
+		std::vector<TaskGroup> taskgroups;
+		task_exchange::Reader reader(format, [&](TaskGroup&& taskgroup){taskgroups.push_back(std::move(taskgroup));});
+		for(std::size_t i = 0; i < buffer.size(); i += chunk_size)
+			reader.feed(buffer.data() + i, std::min(chunk_size, buffer.size() - i));
+		reader.finish();
+		return taskgroups;
+	}
+	
+	///Writes and reads the groups in the format, reporting the throughput and the allocations per task of both.
+	inline void bench_format(const std::vector<TaskGroup>& taskgroups, const std::size_t task_count, const task_exchange::Format format, const char* const name){
+		std::string buffer;
+		const double write_seconds = bench::measure_seconds([&](){
+			std::ostringstream stream;
+			task_exchange::write(stream, format, taskgroups);
+			buffer = std::move(stream).str();
+			bench::do_not_optimize(buffer.data());
+		});
+		//the allocations of the stream itself are counted too, which are few as it grows geometrically.
+		const std::size_t write_allocations = bench::count_allocations([&](){
+			std::ostringstream stream;
+			task_exchange::write(stream, format, taskgroups);
+			bench::do_not_optimize(stream.tellp());
+		});
+		
+		std::vector<TaskGroup> read_taskgroups;
+		const double read_seconds = bench::measure_seconds([&](){
+			read_taskgroups = read_in_chunks(buffer, format);
+			bench::do_not_optimize(read_taskgroups.size());
+		});
+		const std::size_t read_allocations = bench::count_allocations([&](){
+			bench::do_not_optimize(read_in_chunks(buffer, format).size());
+		});
+		
+		if(read_taskgroups != taskgroups)
+			throw std::logic_error(std::string("bench_task_exchange.hpp: the groups read from ") + name + " are not the groups written.");
+		
+		std::cout << "[task_exchange] " << name << ", " << buffer.size() / 1e6 << " MB:\t"
+				<< "write " << double(buffer.size()) / write_seconds / 1e6 << " MB/s, " << double(write_allocations) / double(task_count) << " allocations per task,\t"
+				<< "read " << double(buffer.size()) / read_seconds / 1e6 << " MB/s, " << double(read_allocations) / double(task_count) << " allocations per task\n";
+	}
+}
+
+inline void bench_suite_task_exchange(){
+	constexpr std::size_t task_file_size = 20 * 1000 * 1000;
+	const std::string task_file = bench::generate_task_file(task_file_size);
+	
+	TaskFileParser parser;
+	parser.feed(task_file.data(), task_file.size());
+	const std::vector<TaskGroup> taskgroups = parser.finish();
+	
+	std::size_t task_count = 0;
+	for(const TaskGroup& taskgroup : taskgroups) task_count += taskgroup.tasks.size();
+	std::cout << "[task_exchange] " << task_count << " tasks from a " << task_file.size() / 1e6 << " MB task file\n";
+	
+	bench_task_exchange_internal::bench_format(taskgroups, task_count, task_exchange::Format::Csv, "CSV");
+	bench_task_exchange_internal::bench_format(taskgroups, task_count, task_exchange::Format::JsonLines, "JSON Lines");
+}
+
+#endif
@@ -0,0 +1,169 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef bench_task_io_hpp
+#define bench_task_io_hpp
+
+#include "bench_common.hpp"
+
+#include "task_io.hpp"
+#include "time_calc.hpp"
+#include "task_snapshot.hpp"
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <optional>
+#include <iostream>
+#include <stdexcept>
+
+namespace bench_task_io_internal{
+	///Parses the task file with TaskFileParser on the calling thread, the reference for parse_tasks_parallel().
+	inline double bench_serial_parse(const std::string& task_file, std::vector<TaskGroup>& taskgroups){
+		return bench::measure_seconds([&](){
+			TaskFileParser parser;
+			parser.feed(task_file.data(), task_file.size());
+			taskgroups = parser.finish();
+			bench::do_not_optimize(taskgroups.size());
+		});
+	}
+	
+	inline double bench_parallel_parse(const std::string& task_file, const unsigned thread_count, std::vector<TaskGroup>& taskgroups){
+		return bench::measure_seconds([&](){
+			taskgroups = parse_tasks_parallel(task_file, thread_count);
+			bench::do_not_optimize(taskgroups.size());
+		});
+	}
+	///The serializer taskgroups_to_str() replaced, which concatenated temporary strings for each task. Kept as the reference for the benchmark.
+	inline std::string concatenating_taskgroups_to_str(const std::vector<TaskGroup>& taskgroups){
+		const auto int_to_2char = [](const unsigned num){
+			const std::string num_str = std::to_string(num);
+			if(num < 10) return "0" + num_str;
+			else return num_str;
+		};
+		const auto task_to_str = [&](const Task& task){
+			const std::string year_str = std::to_string(int(task.due_date().year()));
+			const std::string month_str = int_to_2char(unsigned(task.due_date().month()));
+			const std::string day_str = int_to_2char(unsigned(task.due_date().day()));
+			const std::string ymd_str = year_str + "/" + month_str + "/" + day_str;
+			return ymd_str + ", " + std::string(task.name());
+		};
+		
+		std::string buffer;
+		buffer.reserve(400);
+		for(const TaskGroup& taskgroup : taskgroups){
+			if(taskgroup.tasks.size() == 1){
+				buffer += task_to_str(taskgroup.tasks[0]) + '\n';
+			}
+			else{
+				buffer += taskgroup.group_name + "{\n";
+				for(const Task& task : taskgroup.tasks) buffer += task_to_str(task) + '\n';
+				buffer += "}\n";
+			}
+		}
+		return buffer;
+	}
+	
+	///Serializes the groups with taskgroups_to_str(), against the concatenating serializer it replaced.
+	inline void bench_serialize(const std::vector<TaskGroup>& taskgroups){
+		std::size_t task_count = 0;
+		for(const TaskGroup& taskgroup : taskgroups) task_count += taskgroup.tasks.size();
+		
+		const auto report = [&](const char* const name, std::string(*serialize)(const std::vector<TaskGroup>&)){
+			std::string buffer;
+			const double seconds = bench::measure_seconds([&](){
+				buffer = serialize(taskgroups);
+				bench::do_not_optimize(buffer.data());
+			});
+			const std::size_t allocations = bench::count_allocations([&](){
+				bench::do_not_optimize(serialize(taskgroups).data());
+			});
+			
+			std::cout << "[task_io] " << name << ":\t" << double(buffer.size()) / seconds / 1e6 << " MB/s,\t"
+					<< double(allocations) / double(task_count) << " allocations per task\n";
+			return buffer;
+		};
+		
+		const std::string buffer = report("taskgroups_to_str", taskgroups_to_str);
+		const std::string concatenated_buffer = report("concatenating serializer", concatenating_taskgroups_to_str);
+		
+		if(buffer != concatenated_buffer)
+			throw std::logic_error("bench_task_io.hpp: taskgroups_to_str() did not write the same task file as the concatenating serializer.");
+	}
+	
+	///Loads the snapshot of the groups, against copying the bytes of the snapshot and copying the groups themselves.
+	///Copying the groups is the least a load could cost, as every name of the groups and tasks is allocated either way.
+	inline void bench_snapshot(const std::vector<TaskGroup>& taskgroups, const double text_parse_seconds){
+		const task_snapshot::SourceStamp stamp = {0, 0};
+		const std::string snapshot = task_snapshot::serialize(taskgroups, stamp);
+		const auto current_date = get_current_ymd();
+		
+		std::size_t task_count = 0;
+		const double load_seconds = bench::measure_seconds([&](){
+			const std::optional<std::vector<TaskGroup>> loaded_taskgroups = task_snapshot::deserialize(snapshot, stamp, current_date);
+			task_count = 0;
+			for(const TaskGroup& taskgroup : *loaded_taskgroups) task_count += taskgroup.tasks.size();
+			bench::do_not_optimize(task_count);
+		});
+		
+		std::string copied_snapshot;
+		const double memcpy_seconds = bench::measure_seconds([&](){
+			copied_snapshot.assign(snapshot);
+			bench::do_not_optimize(copied_snapshot.data());
+		});
+		
+		const double group_copy_seconds = bench::measure_seconds([&](){
+			const std::vector<TaskGroup> copied_taskgroups(taskgroups);
+			bench::do_not_optimize(copied_taskgroups.data());
+		});
+		
+		std::cout << "[task_io] snapshot of " << task_count << " tasks, " << snapshot.size() / 1e6 << " MB:\t"
+				<< "load " << load_seconds * 1e3 << " ms (" << text_parse_seconds / load_seconds << "x faster than parsing),\t"
+				<< "memcpy " << memcpy_seconds * 1e3 << " ms,\t"
+				<< "copying the groups " << group_copy_seconds * 1e3 << " ms\n";
+	}
+}
+
+inline void bench_suite_task_io(){
+	constexpr std::size_t task_file_size = 100 * 1000 * 1000;
+	const std::string task_file = bench::generate_task_file(task_file_size);
+	
+	std::vector<TaskGroup> serial_taskgroups;
+	const double serial_seconds = bench_task_io_internal::bench_serial_parse(task_file, serial_taskgroups);
+	
+	std::cout << "[task_io] synthetic task file: " << task_file.size() / 1e6 << " MB, " << serial_taskgroups.size() << " groups, "
+			<< default_parse_thread_count() << " hardware threads\n";
+	std::cout << "[task_io] TaskFileParser:\t" << bench::gigabytes_per_second(task_file.size(), serial_seconds) << " GB/s\n";
+	
+	//doubling the threads up to the hardware threads, and the hardware threads themselves if it is not a power of 2.
+	std::vector<unsigned> thread_counts;
+	for(unsigned thread_count = 1; thread_count < default_parse_thread_count(); thread_count *= 2)
+		thread_counts.push_back(thread_count);
+	thread_counts.push_back(default_parse_thread_count());
+	
+	for(const unsigned thread_count : thread_counts){
+		std::vector<TaskGroup> parallel_taskgroups;
+		const double parallel_seconds = bench_task_io_internal::bench_parallel_parse(task_file, thread_count, parallel_taskgroups);
+		
+		if(parallel_taskgroups != serial_taskgroups)
+			throw std::logic_error("bench_task_io.hpp: parse_tasks_parallel() did not return the same groups as TaskFileParser.");
+		
+		std::cout << "[task_io] parse_tasks_parallel, " << thread_count << " threads:\t" 
+				<< bench::gigabytes_per_second(task_file.size(), parallel_seconds) << " GB/s,\t"
+				<< "speedup " << serial_seconds / parallel_seconds << "x\n";
+	}
+	
+	bench_task_io_internal::bench_snapshot(serial_taskgroups, serial_seconds);
+	bench_task_io_internal::bench_serialize(serial_taskgroups);
+}
+
+#endif
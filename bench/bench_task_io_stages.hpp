@@ -0,0 +1,185 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef bench_task_io_stages_hpp
+#define bench_task_io_stages_hpp
+
+#include "bench_common.hpp"
+
+#include "Task.hpp"
+#include "task_io.hpp"
+#include "parse_diagnostics.hpp"
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <system_error>
+#include <stdexcept>
+#include <exception>
+#include <filesystem>
+#include <string_view>
+
+/**
+\file bench_task_io_stages.hpp
+Benchmarks each stage of loading and saving the task file on its own, over generated task files of different shapes:
+the size from a thousand tasks up to the maximum given to bench.exe, then groups, long names and invalid due dates at a fixed size.
+
+Every stage reports the time per task (ns/op), the throughput over the characters of the task file, and the allocations per task,
+so the stages and the shapes can be compared with each other, and against the numbers of a baseline before a change.
+The files are written to a temporary directory, as overwrite_taskfile() writes tasks.txt and its snapshot in the current directory.
+*/
+namespace bench_task_io_stages_internal{
+	///The task count of the shapes compared at a fixed size.
+	constexpr std::size_t shape_task_count = 100 * 1000;
+	
+	///Runs the benchmarks in a temporary directory, which is removed afterwards along with the files written there.
+	class TemporaryDirectory{
+		public:
+		TemporaryDirectory()
+		:	previous_path(std::filesystem::current_path()),
+			path(std::filesystem::temp_directory_path() / "worktable_bench")
+		{
+			std::filesystem::create_directories(this->path);
+			std::filesystem::current_path(this->path);
+		}
+		
+		~TemporaryDirectory() noexcept{
+			std::error_code error;
+			std::filesystem::current_path(this->previous_path, error);
+			std::filesystem::remove_all(this->path, error);
+		}
+		
+		TemporaryDirectory(const TemporaryDirectory&) = delete;
+		TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+		
+		private:
+		std::filesystem::path previous_path;
+		std::filesystem::path path;
+	};
+	
+	///Runs small task files more times, so the fastest run is not just noise. Each shape is measured for about the same time.
+	inline int repetitions_for(const std::size_t task_count){
+		return int(std::clamp<std::size_t>(1000 * 1000 / task_count, 3, 200));
+	}
+	
+	///Measures the function and prints the time per task, the throughput over the bytes and the allocations per task.
+	template<typename Function>
+	void report(const char* const stage, const std::size_t task_count, const std::size_t bytes, const int repetitions, Function&& function){
+		const double seconds = bench::measure_seconds(function, repetitions);
+		const std::size_t allocations = bench::count_allocations(function);
+		
+		const std::ios::fmtflags flags = std::cout.flags();
+		const std::streamsize precision = std::cout.precision();
+		std::cout << "[stages]   " << std::left << std::setw(28) << stage << std::right << std::fixed << std::setprecision(1)
+				<< std::setw(10) << seconds * 1e9 / double(task_count) << " ns/op"
+				<< std::setw(10) << double(bytes) / seconds / 1e6 << " MB/s"
+				<< std::setprecision(3) << std::setw(10) << double(allocations) / double(task_count) << " allocations/op\n";
+		std::cout.flags(flags);
+		std::cout.precision(precision);
+	}
+	
+	inline void bench_shape(const bench::TaskFileShape& shape){
+		const std::string task_file = bench::generate_task_file(shape);
+		const int repetitions = repetitions_for(shape.task_count);
+		std::cout << "[stages] " << bench::describe(shape) << ", " << task_file.size() / 1e6 << " MB:\n";
+		
+		//the invalid due dates are recorded rather than written to std::cerr for every task.
+		parse_diagnostics::Collector collector;
+		TaskFileParser parser(task_io_internal::default_nested_group_callback, &collector);
+		parser.feed(task_file.data(), task_file.size());
+		const std::vector<TaskGroup> taskgroups = parser.finish();
+		
+		//the task file written by overwrite_taskfile() is the one read by get_raw_file(), which is the generated file without its invalid due dates.
+		const std::size_t written_size = taskgroups_to_str(taskgroups).size();
+		report("overwrite_taskfile", shape.task_count, written_size, repetitions, [&](){
+			overwrite_taskfile(taskgroups);
+		});
+		
+		task_io_internal::file_buffer buffer;
+		report("get_raw_file", shape.task_count, written_size, repetitions, [&](){
+			buffer = task_io_internal::get_raw_file("tasks.txt");
+			bench::do_not_optimize(buffer.first.get());
+		});
+		
+		//the stages after reading the file are measured over the generated file, so the invalid due dates go through them.
+		buffer.first.reset(new char[task_file.size()]);
+		buffer.second = task_file.size();
+		std::copy(task_file.begin(), task_file.end(), buffer.first.get());
+		
+		std::vector<std::string> lines;
+		report("buffer_to_separated_lines", shape.task_count, task_file.size(), repetitions, [&](){
+			lines = task_io_internal::buffer_to_separated_lines(buffer);
+			bench::do_not_optimize(lines.data());
+		});
+		
+		std::vector<task_io_internal::TaskStrGroup> taskstr_groups;
+		report("lines_to_TaskStrGroup", shape.task_count, task_file.size(), repetitions, [&](){
+			taskstr_groups = task_io_internal::lines_to_TaskStrGroup(lines, task_io_internal::default_nested_group_callback, &collector);
+			bench::do_not_optimize(taskstr_groups.data());
+		});
+		
+		std::vector<TaskGroup> converted_taskgroups;
+		report("TaskStrGroups_to_TaskGroups", shape.task_count, task_file.size(), repetitions, [&](){
+			converted_taskgroups = task_io_internal::TaskStrGroups_to_TaskGroups(taskstr_groups, &collector);
+			bench::do_not_optimize(converted_taskgroups.data());
+		});
+		
+		//str_to_ymd() is only given the valid due dates, as the invalid ones throw, which costs far more than parsing them.
+		std::vector<std::string_view> due_date_strs;
+		std::size_t due_date_bytes = 0;
+		for(const task_io_internal::TaskStrGroup& taskstr_group : taskstr_groups){
+			for(const task_io_internal::TaskStr& taskstr : taskstr_group.taskstrs){
+				if(!parse_ymd(taskstr.due_date).ok()) continue;
+				due_date_strs.push_back(taskstr.due_date);
+				due_date_bytes += taskstr.due_date.size();
+			}
+		}
+		report("str_to_ymd", due_date_strs.size(), due_date_bytes, repetitions, [&](){
+			for(const std::string_view due_date_str : due_date_strs) bench::do_not_optimize(str_to_ymd(due_date_str));
+		});
+		
+		std::size_t task_str_bytes = 0;
+		for(const TaskGroup& taskgroup : taskgroups){
+			for(const Task& task : taskgroup.tasks) task_str_bytes += task_to_str(task).size();
+		}
+		std::size_t valid_task_count = 0;
+		for(const TaskGroup& taskgroup : taskgroups) valid_task_count += taskgroup.tasks.size();
+		report("task_to_str", valid_task_count, task_str_bytes, repetitions, [&](){
+			for(const TaskGroup& taskgroup : taskgroups){
+				for(const Task& task : taskgroup.tasks) bench::do_not_optimize(task_to_str(task).data());
+			}
+		});
+		
+		if(converted_taskgroups != taskgroups)
+			throw std::logic_error("bench_task_io_stages.hpp: the stages did not return the same groups as TaskFileParser.");
+	}
+}
+
+///Benchmarks the stages over task files from a thousand tasks up to max_task_count, growing tenfold, then over the other shapes.
+inline void bench_suite_task_io_stages(const std::size_t max_task_count){
+	using bench_task_io_stages_internal::shape_task_count;
+	const bench_task_io_stages_internal::TemporaryDirectory temporary_directory;
+	
+	for(std::size_t task_count = 1000; task_count <= max_task_count; task_count *= 10)
+		bench_task_io_stages_internal::bench_shape({task_count});
+	
+	bench_task_io_stages_internal::bench_shape({shape_task_count, 50});
+	bench_task_io_stages_internal::bench_shape({shape_task_count, 5000});
+	bench_task_io_stages_internal::bench_shape({shape_task_count, 1, 200});
+	bench_task_io_stages_internal::bench_shape({shape_task_count, 1, 16, 10});
+}
+
+#endif
@@ -0,0 +1,133 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "Task.hpp"
+#include "task_io.hpp"
+#include "time_calc.hpp"
+#include "task_batch.hpp"
+#include "task_journal.hpp"
+#include "parse_diagnostics.hpp"
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <utility>
+#include <iostream>
+#include <exception>
+#include <stdexcept>
+#include <filesystem>
+
+/**
+\file cli_main.cpp
+The command-line interface of WorkTable, which runs the commands of task_batch.hpp over tasks.txt in the directory it is called from, without a display.
+
+    cli.exe <command> [arguments...]    runs a single command.
+    cli.exe -                           runs a command from each line of the standard input, skipping empty lines and lines starting with #.
+
+The task file is loaded once and written once after every command has run, only if a command changed it.
+If any command fails, nothing is written, so a batch is applied either entirely or not at all.
+Loading never writes either: a journal which could not be replayed entirely is left as is, 
+and only started over as WorkTable does once loaded if a command changed the task file.
+*/
+
+namespace{
+	constexpr const char* usage = 
+		"Usage: cli.exe <command> [arguments...], or cli.exe - for a command on each line of the standard input.\n"
+		"Commands:\n"
+		"  list [--due-within <N>d|<N>w] [--group <group name>]\n"
+		"  add [--group <group name>] <yyyy/m/d> <task name>\n"
+		"  import [--format tasks|csv|jsonl] <filename>\n"
+		"  export [--format tasks|csv|jsonl] <filename>|-\n"
+		"  group [--from <group name>] <group name> <task name>\n";
+	
+	///Loads tasks.txt, or no groups if there is no task file yet. Any error of loading an existing task file is thrown, so it is not overwritten.
+	///Nothing is written while loading, the status of replaying the journal is stored to replay_status for writing the task file afterwards.
+	std::vector<TaskGroup> load_task_file(parse_diagnostics::Collector& diagnostics, task_journal::ReplayStatus& replay_status){
+		replay_status = task_journal::ReplayStatus::NoJournal;
+		if(!std::filesystem::exists("tasks.txt")) return {};
+		
+		try{
+			return get_tasks_parallel(default_parse_thread_count(), task_io_internal::default_nested_group_callback, &diagnostics, &replay_status);
+		}
+		catch(const std::ios_base::failure& file_io_error) {throw;}
+		catch(const std::runtime_error& file_not_opened) {throw;}
+	}
+	
+	void report_diagnostics(parse_diagnostics::Collector& diagnostics){
+		if(diagnostics.empty()) return;
+		std::cerr << parse_diagnostics::summary(diagnostics) << '\n';
+		diagnostics.clear();
+	}
+}
+
+int main(const int argc, const char* const* const argv){
+	if(argc < 2){
+		std::cerr << usage;
+		return 2;
+	}
+	
+	try{
+		std::ios::sync_with_stdio(false);
+		
+		parse_diagnostics::Collector diagnostics;
+		task_journal::ReplayStatus replay_status;
+		task_batch::Batch batch(load_task_file(diagnostics, replay_status), get_current_ymd(), &diagnostics);
+		report_diagnostics(diagnostics);
+		
+		std::string output;
+		if(std::string(argv[1]) == "-"){
+			std::string line;
+			for(std::size_t line_number = 1; std::getline(std::cin, line); ++line_number){
+				try{
+					const std::vector<std::string> arguments = task_batch::split_arguments(line);
+					if(arguments.empty() || arguments.front().starts_with('#')) continue;
+					batch.run(arguments, output);
+				}
+				catch(const std::exception& command_error){
+					std::cerr << "line " << line_number << ": " << command_error.what() << "\nNothing was written to tasks.txt.\n";
+					return 1;
+				}
+			}
+		}else{
+			try{
+				batch.run(std::vector<std::string>(argv + 1, argv + argc), output);
+			}
+			catch(const std::invalid_argument& invalid_command){
+				std::cerr << invalid_command.what() << '\n' << usage;
+				return 1;
+			}
+		}
+		report_diagnostics(diagnostics);
+		
+		std::fwrite(output.data(), 1, output.size(), stdout);
+		
+		const bool journal_replayed = (replay_status == task_journal::ReplayStatus::NoJournal) || (replay_status == task_journal::ReplayStatus::Replayed);
+		if(batch.modified()){
+			//writing the task file starts the journal over, as loading it in WorkTable does, a stale journal is kept aside first.
+			if(replay_status == task_journal::ReplayStatus::StaleJournal) task_journal::reject(task_journal_filename);
+			write_taskfile(batch.taskgroups());
+			if(!journal_replayed) std::cerr << task_journal::replay_status_message(replay_status) << '\n';
+		}
+		else if(!journal_replayed){
+			std::cerr << "The journal of saved changes could not be replayed entirely, it is left as is since nothing was written to tasks.txt.\n";
+		}
+		return 0;
+	}
+	catch(const std::exception& excp){
+		std::cerr << "Error: " << excp.what() << "\nNothing was written to tasks.txt.\n";
+	}
+	catch(...){
+		std::cerr << "Caught an unspecified throw. Nothing was written to tasks.txt.\n";
+	}
+	return 1;
+}
@@ -0,0 +1,111 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "fuzz_task_io.hpp"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+#include <string_view>
+
+/**
+\file fuzz_main.cpp
+The entry points of the differential fuzzer of the task file parsers, see fuzz_task_io.hpp for what is compared.
+
+Built with clang's -fsanitize=fuzzer and WORKTABLE_LIBFUZZER defined (make fuzz), libFuzzer calls LLVMFuzzerTestOneInput() with the inputs it generates,
+and a difference aborts so libFuzzer saves the input.
+Built without them (make fuzz_replay), it is a plain program which replays the files and directories of inputs given as arguments,
+or the standard input without arguments, which is how the corpus and the inputs saved by libFuzzer are checked without clang.
+*/
+
+namespace{
+	///Prints the differences of the input, returns true if there are none.
+	///An exception other than the std::out_of_range of the parsers is a difference too.
+	bool check_input(const std::string_view input, const std::string& input_name){
+		std::vector<std::string> differences;
+		try{
+			differences = fuzz_task_io::check(input);
+		}
+		catch(const std::exception& excp){
+			differences.push_back(std::string("a parser threw an unexpected exception: ") + excp.what());
+		}
+		
+		for(const std::string& difference : differences)
+			std::cerr << "[fuzz] " << input_name << ": " << difference << '\n';
+		return differences.empty();
+	}
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* const data, const std::size_t size){
+	if(!check_input(std::string_view(reinterpret_cast<const char*>(data), size), "input")) std::abort();
+	return 0;
+}
+
+#ifndef WORKTABLE_LIBFUZZER
+namespace{
+	std::string read_file(const std::filesystem::path& path){
+		std::ifstream file(path, std::ios::binary);
+		if(!file.is_open())
+			throw std::runtime_error("fuzz_main.cpp: read_file(): " + path.string() + " cannot be opened.");
+		return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+	
+	///Returns the files of the argument, the files of a directory in the order of their names so the replay is the same every time.
+	std::vector<std::filesystem::path> input_files(const std::filesystem::path& argument){
+		if(!std::filesystem::is_directory(argument)) return {argument};
+		
+		std::vector<std::filesystem::path> files;
+		for(const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(argument)){
+			if(entry.is_regular_file()) files.push_back(entry.path());
+		}
+		std::sort(files.begin(), files.end());
+		return files;
+	}
+}
+
+int main(const int argc, const char* const* const argv){
+	try{
+		std::size_t input_count = 0;
+		std::size_t failed_input_count = 0;
+		
+		if(argc < 2){
+			const std::string input(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+			input_count = 1;
+			failed_input_count = check_input(input, "standard input") ? 0 : 1;
+		}
+		
+		for(int i = 1; i < argc; ++i){
+			for(const std::filesystem::path& file : input_files(argv[i])){
+				++input_count;
+				if(!check_input(read_file(file), file.string())) ++failed_input_count;
+			}
+		}
+		
+		std::clog << "[fuzz] replayed " << input_count << " inputs, " << failed_input_count << " differ from the reference parser.\n";
+		return (failed_input_count == 0) ? 0 : 1;
+	}
+	catch(const std::exception& excp){
+		std::cerr << "[fuzz] caught an unspecified exception.\n";
+		std::cerr << "\tMessage of the exception: " << excp.what() << '\n';
+	}
+	return -1;
+}
+#endif
@@ -0,0 +1,249 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+
+#ifndef fuzz_reference_hpp
+#define fuzz_reference_hpp
+
+#include "Task.hpp"
+#include "time_calc.hpp"
+#include "parse_diagnostics.hpp"
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+
+/**
+\file fuzz_reference.hpp
+The parser the task file was read with before it was rewritten, which fuzz_task_io.hpp checks the rewritten parsers against.
+
+buffer_to_separated_lines(), line_to_TaskStr(), lines_to_TaskStrGroup(), TaskStrGroups_to_TaskGroups() and str_to_ymd() are copied as they were, 
+with std::stoi() and the loops over the characters, rather than calling the task_io_internal functions of the same names, which now share their code with the rewrite.
+The only changes are that the errors are recorded to a collector instead of displayed in a window, and that the lines are taken as a std::string_view.
+
+The rewrite differs from them on purpose in two ways, which reference_ymd() allows:
+- A day above 255 wraps around in the 8 bits of std::chrono::day with str_to_ymd(), so 2025/01/257 was January 1st. It is an invalid due date since parse_ymd().
+- A day too large for an int threw std::out_of_range from std::stoi(), which was not caught and stopped loading the task file. It is an invalid due date since parse_ymd().
+*/
+namespace fuzz_task_io::reference{
+	struct TaskStr{
+		std::string due_date;
+		std::string name;
+	};
+	
+	struct TaskStrGroup{
+		std::string group_name;
+		std::vector<TaskStr> taskstrs;
+	};
+	
+	inline std::vector<std::string> buffer_to_separated_lines(const std::string_view buffer){
+		const char* const data = buffer.data();
+		const int character_count = buffer.size();
+		
+		std::vector<std::string> lines;
+		lines.reserve(20);
+		std::string fetch_line;
+
+		for(auto i = 0; i < character_count; ++i){
+			const char c = data[i];
+			
+			if(c != '\n') fetch_line += c;
+			
+			const bool end_of_file = ((i+1) == character_count);
+			
+			if((c == '\n' || end_of_file) && !fetch_line.empty()){
+				lines.emplace_back(fetch_line);
+				fetch_line.clear();
+			}
+		}
+		
+		lines.shrink_to_fit();
+		return lines;
+	}
+	
+	inline TaskStr line_to_TaskStr(const std::string& line){
+		std::string date_str; date_str.reserve(10);
+		std::string name_str; name_str.reserve(20);
+		
+		const auto line_length = line.size();
+		auto date_str_end_index = line_length;
+		
+		for(std::size_t i = 0; i < line_length; ++i){
+			if(line[i] == ','){
+				date_str_end_index = i;
+				break;
+			}
+			else date_str += line[i];
+		}
+		
+		//+2 for skipping the comma then space. starts at the first character of the task name.
+		name_str += line.substr(date_str_end_index+2, line_length);	
+		return {date_str, name_str};
+	}
+	
+	inline std::vector<TaskStrGroup> lines_to_TaskStrGroup(const std::vector<std::string>& lines, parse_diagnostics::Collector& collector){
+		std::vector<TaskStrGroup> task_str_groups; 
+		task_str_groups.reserve(lines.size());
+		
+		TaskStrGroup fetching_taskstr_group;
+		
+		bool fetching_group = false;
+		const std::size_t line_count = lines.size();
+		for(std::size_t line_i = 0; line_i < line_count; line_i++){
+			const std::string& line = lines[line_i];
+			
+			const bool nested_group = (line.back() == '{') && fetching_group;
+			if(nested_group){
+				const std::string nested_group_name = line.substr(0, line.size() - 1);;
+				collector.record(parse_diagnostics::Kind::NestedGroup, line_i, 0, nested_group_name);
+				continue;
+			}
+			
+			if(line.back() == '{'){
+				fetching_group = true;
+				fetching_taskstr_group.group_name = line.substr(0, line.size() - 1);
+				continue;
+			}
+			
+			if(line == "}") fetching_group = false;
+			else fetching_taskstr_group.taskstrs.push_back(line_to_TaskStr(line));
+			
+			const bool last_line = line_i + 1 == line_count;
+			if(!fetching_group || last_line){
+				if(fetching_taskstr_group.taskstrs.size() > 0){
+					task_str_groups.push_back(fetching_taskstr_group);
+					fetching_taskstr_group.taskstrs.clear();
+					fetching_taskstr_group.group_name.clear();
+				}
+			}
+		}
+
+		task_str_groups.shrink_to_fit();
+		return task_str_groups;
+	}
+	
+	inline std::chrono::year_month_day str_to_ymd(const std::string& str){
+		const auto str_length = str.size();
+		std::string buffer; 
+		
+		buffer.reserve(5);
+		
+		//includes 4 characters for yyyy, 2 for slashes, 1 for month and 1 for day.
+		constexpr decltype(str_length) min_str_length = 8;
+		if(str_length < min_str_length) throw std::invalid_argument("string of ymd is too short. Minimum is 8 characters.");
+		
+		decltype(str.size()) i = 0;
+		
+		//fetching year
+		for(; i < 4; ++i){
+			const char& c = str[i];
+			
+			if(char_is_number(c)) buffer += c;
+			else throw std::invalid_argument("ymd must only contain numbers or forward slash '/'.");
+		}
+		const auto year = std::chrono::year(std::stoi(buffer));
+		buffer.clear();	
+		
+		
+		//+1 to skip '/' between year and month
+		for(i += 1; i < 7; ++i){
+			const char c = str[i];
+			
+			if(char_is_number(c)) buffer += c;
+			else if(c == '/') break;
+			else throw std::invalid_argument("ymd must only contain numbers or forward slash '/'.");
+		}
+		if(buffer.empty()) throw std::invalid_argument("Month section not provided.");
+		const auto month = std::chrono::month(std::stoi(buffer));
+		buffer.clear();	
+		
+		
+		//+1 to skip '/' between month and day
+		for(i += 1; i < str_length; ++i){
+			const char c = str[i];
+			
+			if(char_is_number(c)) buffer += c;
+			else throw std::invalid_argument("Days must only contain numbers.");
+		}
+		const auto day = std::chrono::day(std::stoi(buffer));
+		buffer.clear();
+		
+		
+		const auto ymd = std::chrono::year_month_day(year, month, day);
+		if(ymd.ok()) return ymd;
+		else throw std::invalid_argument("Invalid ymd.");
+	}
+	
+	///Returns true if the day of a due date accepted by str_to_ymd() is above 31, the day is read from where str_to_ymd() reads it.
+	inline bool day_wrapped_around(const std::string& str){
+		std::size_t month_end = 5;
+		while(month_end < 7 && str[month_end] != '/') month_end++;
+		
+		unsigned day = 0;
+		for(std::size_t i = month_end + 1; i < str.size(); ++i){
+			day = day * 10 + unsigned(str[i] - '0');
+			if(day > 31) return true;
+		}
+		return false;
+	}
+	
+	///str_to_ymd() with the divergences of the rewrite allowed: a day above 31 is an invalid due date rather than wrapping around,
+	///and a day too large for std::stoi() is an invalid due date rather than a std::out_of_range.
+	inline std::chrono::year_month_day reference_ymd(const std::string& str){
+		std::chrono::year_month_day ymd;
+		try{
+			ymd = str_to_ymd(str);
+		}
+		catch(const std::out_of_range& day_too_large){
+			throw std::invalid_argument("Day too large for std::stoi().");
+		}
+		
+		if(day_wrapped_around(str)) throw std::invalid_argument("Day wrapped around in std::chrono::day.");
+		return ymd;
+	}
+	
+	inline std::vector<TaskGroup> TaskStrGroups_to_TaskGroups(const std::vector<TaskStrGroup>& taskstr_groups, parse_diagnostics::Collector& collector){
+		std::vector<TaskGroup> taskgroups; 
+		taskgroups.reserve(taskstr_groups.size());
+		
+		const std::chrono::year_month_day current_date = get_current_ymd();
+		
+		for(const TaskStrGroup& current_taskstr_group : taskstr_groups){
+			TaskGroup fetching_taskgroup;
+			fetching_taskgroup.group_name = current_taskstr_group.group_name;
+			
+			for(const TaskStr& current_taskstr : current_taskstr_group.taskstrs){
+				try{
+					const std::chrono::year_month_day due_date = reference_ymd(current_taskstr.due_date);
+					fetching_taskgroup.tasks.emplace_back(due_date, current_taskstr.name, current_date);
+				}
+				catch(std::invalid_argument& invalid_ymd){
+					collector.record(parse_diagnostics::Kind::InvalidDueDate, 0, 0, current_taskstr.name);
+				}
+			}
+			
+			taskgroups.push_back(fetching_taskgroup);
+		}
+
+		return taskgroups;
+	}
+	
+	///Parses the entire task file as it was read before the rewrite. Throws std::out_of_range from a task line without the comma and space after its due date.
+	inline std::vector<TaskGroup> parse(const std::string_view task_file, parse_diagnostics::Collector& collector){
+		return TaskStrGroups_to_TaskGroups(lines_to_TaskStrGroup(buffer_to_separated_lines(task_file), collector), collector);
+	}
+}
+
+#endif
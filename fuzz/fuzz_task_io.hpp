@@ -0,0 +1,184 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef fuzz_task_io_hpp
+#define fuzz_task_io_hpp
+
+#include "Task.hpp"
+#include "task_io.hpp"
+#include "task_index.hpp"
+#include "parse_diagnostics.hpp"
+#include "fuzz_reference.hpp"
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <functional>
+#include <string_view>
+
+/**
+\file fuzz_task_io.hpp
+The differential check of the task file parsers, run by fuzz_main.cpp on every input.
+
+The reference is the parser the task file was first read with, copied into fuzz_reference.hpp as it was before the rewrite, 
+with only the divergences made on purpose allowed. Every optimized parser must return the same groups, record the same kinds of errors, 
+and throw std::out_of_range for the same inputs as the reference:
+- TaskFileParser fed the entire input, then fed a character at a time and in chunks of 7, which split the lines at every position.
+- task_io_internal::parse_chunks_parallel() on 2 to 4 chunks, as parse_tasks_parallel() only splits inputs far larger than the fuzzer makes.
+- task_index::build() then task_index::load() of every span, which only has the errors of the lines in the spans.
+The due date before the comma of every line is also parsed with both reference::str_to_ymd() and parse_ymd(), which must agree on whether it is valid and on the date.
+
+Only the count of each kind of error is compared. The reference records the nested groups while separating the groups and the invalid due dates afterwards,
+while the others record them in the order of the lines. The reference also records an invalid due date by the name of its task only, and the others by the line.
+*/
+namespace fuzz_task_io{
+	///What a parser did with an input, which must be the same for every parser.
+	struct Outcome{
+		bool threw_out_of_range = false;
+		std::vector<TaskGroup> taskgroups;
+		std::size_t nested_group_count = 0;
+		std::size_t invalid_due_date_count = 0;
+	};
+	
+	namespace fuzz_task_io_internal{
+		///Runs the parser with a collector, so no window is displayed and no callback is called.
+		inline Outcome run(const std::function<std::vector<TaskGroup>(parse_diagnostics::Collector&)>& parse){
+			Outcome outcome;
+			parse_diagnostics::Collector collector;
+			try{
+				outcome.taskgroups = parse(collector);
+			}
+			catch(const std::out_of_range& no_comma){
+				outcome.threw_out_of_range = true;
+			}
+			
+			//the groups parsed before the exception are discarded by every caller, so they are not compared.
+			if(outcome.threw_out_of_range){
+				outcome.taskgroups.clear();
+				return outcome;
+			}
+			
+			outcome.nested_group_count = collector.count(parse_diagnostics::Kind::NestedGroup);
+			outcome.invalid_due_date_count = collector.count(parse_diagnostics::Kind::InvalidDueDate);
+			return outcome;
+		}
+		
+		///Describes the first difference of the outcome from the reference, or std::nullopt if there is none.
+		inline std::optional<std::string> describe_difference(const Outcome& reference, const Outcome& outcome){
+			if(outcome.threw_out_of_range != reference.threw_out_of_range)
+				return std::string(reference.threw_out_of_range ? "did not throw" : "threw") + " std::out_of_range unlike the reference";
+			
+			if(outcome.taskgroups.size() != reference.taskgroups.size())
+				return std::to_string(outcome.taskgroups.size()) + " groups, the reference has " + std::to_string(reference.taskgroups.size());
+			for(std::size_t i = 0; i < reference.taskgroups.size(); ++i){
+				if(outcome.taskgroups[i] != reference.taskgroups[i])
+					return "group " + std::to_string(i) + " (" + outcome.taskgroups[i].group_name + ") differs from the reference (" + reference.taskgroups[i].group_name + ")";
+			}
+			
+			if(outcome.nested_group_count != reference.nested_group_count)
+				return std::to_string(outcome.nested_group_count) + " nested groups recorded, the reference has " + std::to_string(reference.nested_group_count);
+			if(outcome.invalid_due_date_count != reference.invalid_due_date_count)
+				return std::to_string(outcome.invalid_due_date_count) + " invalid due dates recorded, the reference has " + std::to_string(reference.invalid_due_date_count);
+			
+			return std::nullopt;
+		}
+		
+		inline Outcome run_reference(const std::string_view input){
+			return run([&](parse_diagnostics::Collector& collector){
+				return reference::parse(input, collector);
+			});
+		}
+		
+		inline Outcome run_task_file_parser(const std::string_view input, const std::size_t chunk_size){
+			return run([&](parse_diagnostics::Collector& collector){
+				TaskFileParser parser(task_io_internal::default_nested_group_callback, &collector);
+				for(std::size_t i = 0; i < input.size(); i += chunk_size)
+					parser.feed(input.data() + i, std::min(chunk_size, input.size() - i));
+				return parser.finish();
+			});
+		}
+		
+		inline Outcome run_parse_chunks_parallel(const std::string_view input, const unsigned chunk_count){
+			return run([&](parse_diagnostics::Collector& collector){
+				return task_io_internal::parse_chunks_parallel(task_io_internal::split_at_lines(input, chunk_count), chunk_count, 
+																task_io_internal::default_nested_group_callback, &collector);
+			});
+		}
+		
+		///indexed_size is set to the characters of the input which are in the spans, the lines after them are never loaded.
+		inline Outcome run_task_index(const std::string_view input, std::size_t& indexed_size){
+			indexed_size = 0;
+			return run([&](parse_diagnostics::Collector& collector){
+				std::vector<TaskGroup> taskgroups;
+				for(const task_index::Span& span : task_index::build(input)){
+					taskgroups.push_back(task_index::load(input, span, task_io_internal::default_nested_group_callback, &collector));
+					indexed_size = span.offset + span.size;
+				}
+				return taskgroups;
+			});
+		}
+		
+		///Returns the difference of reference::str_to_ymd() and parse_ymd() for the due date of any line, or std::nullopt if they agree on every line.
+		///The messages are not compared, as the reference throws its own.
+		inline std::optional<std::string> compare_ymd_parsers(const std::string_view input){
+			for(const std::string& line : reference::buffer_to_separated_lines(input)){
+				const std::string due_date_str = line.substr(0, line.find(','));
+				const YmdParseResult result = parse_ymd(due_date_str);
+				
+				try{
+					const std::chrono::year_month_day ymd = reference::reference_ymd(due_date_str);
+					if(!result.ok() || ymd != result.ymd) return "reference str_to_ymd() and parse_ymd() differ for " + std::string(due_date_str);
+				}
+				catch(const std::invalid_argument& invalid_ymd){
+					if(result.ok()) return "reference str_to_ymd() threw unlike parse_ymd() for " + std::string(due_date_str);
+				}
+			}
+			return std::nullopt;
+		}
+	}
+	
+	///Runs every parser over the input, and returns the description of each one which differs from the reference. An empty vector means they all agree.
+	inline std::vector<std::string> check(const std::string_view input){
+		using namespace fuzz_task_io_internal;
+		std::vector<std::string> differences;
+		const Outcome reference = run_reference(input);
+		
+		const auto compare = [&](const std::string& parser_name, const Outcome& outcome){
+			if(const std::optional<std::string> difference = describe_difference(reference, outcome))
+				differences.push_back(parser_name + ": " + *difference);
+		};
+		
+		compare("TaskFileParser", run_task_file_parser(input, input.size() + 1));
+		compare("TaskFileParser fed a character at a time", run_task_file_parser(input, 1));
+		compare("TaskFileParser fed 7 characters at a time", run_task_file_parser(input, 7));
+		for(unsigned chunk_count = 2; chunk_count <= 4; ++chunk_count)
+			compare("parse_chunks_parallel() of " + std::to_string(chunk_count) + " chunks", run_parse_chunks_parallel(input, chunk_count));
+		
+		//the errors after the last group are never displayed by task_index, as the lines after it are not in any span and are not loaded.
+		//So its reference is the reference of the lines in the spans, which has the same groups as the entire input.
+		std::size_t indexed_size = 0;
+		const Outcome index_outcome = run_task_index(input, indexed_size);
+		const Outcome indexed_reference = index_outcome.threw_out_of_range ? reference : run_reference(input.substr(0, indexed_size));
+		if(const std::optional<std::string> difference = describe_difference(indexed_reference, index_outcome))
+			differences.push_back("task_index: " + *difference);
+		if(indexed_reference.taskgroups != reference.taskgroups)
+			differences.push_back("task_index: the lines after the last span have groups in the reference");
+		
+		if(const std::optional<std::string> difference = compare_ymd_parsers(input)) differences.push_back(*difference);
+		return differences;
+	}
+}
+
+#endif
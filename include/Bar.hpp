@@ -13,11 +13,12 @@ You should have received a copy of the GNU General Public License along with Wor
 #ifndef bar_hpp
 #define bar_hpp
 
-#include "Task.hpp"
+#include "task_store.hpp"
 
 #include <FL/Fl.H>
 #include <FL/Fl_Button.H>
 
+#include <span>
 #include <string>
 #include <chrono>
 #include <memory>
@@ -25,79 +26,65 @@ You should have received a copy of the GNU General Public License along with Wor
 struct BarConstructorArgs;
 
 /**
-A variant of TaskGroup for Bar. It provides sorted tasks from nearest due date to furthest,
-ease of access to nearest and furthest due date tasks,
-and methods for mutation which guarantee the tasks be in sorted order.
-
-\note When attempting to add or delete a task, or merge with another TaskGroup, one should use the methods provided in the class,
-  in order to ensure the tasks are sorted.
-  If you just want to iterate over the tasks without mutating the due dates or the order of the tasks, you can access the tasks directly like TaskGroup.
+The tasks which a Bar represents, referred to by their IDs in the TaskStore of BarGroup: 
+either every task of a group in root view, or a single task of the group being viewed in group view.
+The tasks are from nearest due date to furthest, as kept by TaskStore.
 */
-class Bar_TaskGroup : public TaskGroup{	
-	private:
-	Task _nearest_due_date_task;
-	Task _furthest_due_date_task;
-	///Sort the underlying TaskGroup::tasks and reassign this->_nearest_due_date_task and this->furthest_due_date_task.
-	void sort_and_reassign();
-
-	public:
-	///Constructs the object from its base class, sort its task from nearest due date to furthest, 
-	///then assign this->nearest_due_date_task and this->furthest_due_date_task.
-	Bar_TaskGroup(const TaskGroup& taskgroup);
-	const Task& nearest_due_date_task() const {return _nearest_due_date_task;}
-	const Task& furthest_due_date_task() const {return _furthest_due_date_task;}
+struct BarTasks{
+	const TaskStore* store;
+	///The group of the Bar in root view, or the group being viewed in group view.
+	TaskStore::GroupId group;
+	///The task of the Bar in group view, TaskStore::no_id in root view.
+	TaskStore::TaskId task;
 	
-	///Adds the provided task to the underlying TaskGroup::tasks, re-sort it, and reassign the nearest and furthest tasks. 
-	void add_task(const Task& task);
-	///Merge other.tasks to this->tasks, re-sort this->tasks, and ressign the nearest and furthest tasks.
-	///The group name is of the object being called, this->name.
-	void merge_taskgroup(const TaskGroup& other);
-	///Deletes the task at the given index. Returns true if the index is valid, else false and does nothing to the container.
-	bool delete_task_at(const std::size_t index);
-	///Sets the value of Task at given index to of the provided argument.
-	///Returns true if index is valid, else false and does nothing to the container.
-	bool set_task_at(const std::size_t index, const Task& other);
+	std::span<const TaskStore::TaskId> task_ids() const noexcept{
+		if(this->task != TaskStore::no_id) return std::span<const TaskStore::TaskId>(&this->task, 1);
+		return this->store->group_tasks(this->group);
+	}
 	
-	///Equivalent to this->tasks[index].
-	const Task& operator[] (const std::size_t index) const{return this->tasks[index];}
+	std::chrono::days nearest_days_remaining() const noexcept {return this->store->days_remaining(this->task_ids().front());}
+	std::chrono::days furthest_days_remaining() const noexcept {return this->store->days_remaining(this->task_ids().back());}
+	
+	bool operator==(const BarTasks&) const = default;
+};
+
+///The horizontal position and width of a Bar, which depend on its tasks and the timescale. See Bar::calc_span().
+struct BarSpan{
+	int xpos;
+	int width;
 };
 
 /**
 An Fl_Button which represents and keeps track of either a single task or a group of tasks.
+
+BarGroup only constructs bars for the rows in view, a Bar is bound to another row with Bar::rebind() as the rows are scrolled.
+The static functions which lay out and draw a Bar from its tasks are shared with BarCanvas, which draws the rows without a Bar for each.
 */
 class Bar : public Fl_Button{
 	public:
 	///The preferred constructor.
 	Bar(const BarConstructorArgs& args);
 	///Constructor for the one with BarConstructorArgs as parameter to call, no reason to use this.
-	Bar(const int xpos, const int ypos, const int width, const int height, const Bar_TaskGroup& taskgroup, const std::chrono::days& days_from_interval);
-	
-	///Merges its Bar_TaskGroup with the provided group, updates its width to of the task with furthest due date, and updates its text.
-	void merge_taskgroup(const TaskGroup& taskgroup);
-	
-	///Updates its group name. This does not affect the label of a Bar which represent a single task.
-	void update_group_name(const char* const group_name);
-	///Update the properties of its task, then its width, color, and label. 
-	///This is from a chain of requests where the task edit window, which the Bar has requested if it represents a single task, requests the same Bar to modify its contents.
-	///If somehow this is called and the Bar represents a group, it modifies the first task.
-	void update_task(const char* const task_name, const std::chrono::year_month_day& due_date, const std::chrono::days& days_from_interval, const int parent_xpos);
-	/**
-	Updates both xpos and width of the Bar according to its Bar_TaskGroup.
-	There are 3 cases which result in different xpos and width:
-	- The Bar represents a single task and is overdue, or a group with all the tasks overdue: xpos = parent_xpos, width = BarGroup::overdue_bar_width.
-	- The Bar represents a single task and is not overdue, or a group with no overdue tasks: xpos = parent_xpos + BarGroup::bar_xoffset;  width = Bar::calc_bar_width().
-	- The Bar represents a group with intermixed overdue and non-overdue tasks: xpos = parent_xpos + BarGroup::bar_xoffset; width = BarGroup::overdue_bar_width + Bar::calc_bar_width().
+	Bar(const int xpos, const int ypos, const int width, const int height, const BarTasks& tasks, const std::chrono::days& days_from_interval);
 	
-	xpos at parent_xpos means it is behind the current date line (the left line), with BarGroup::bar_xoffset added makes the Bar to start exactly at the line.
-	*/
+	///Updates its width, color and label after BarGroup changed its tasks or group name in TaskStore.
+	void refresh(const std::chrono::days& days_from_interval, const int parent_xpos);
+	///Makes the Bar represent the tasks of another row, and updates its width, color and label for them.
+	void rebind(const BarTasks& tasks, const std::size_t item_index, const std::chrono::days& days_from_interval, const int parent_xpos);
+	///Updates both xpos and width of the Bar according to its tasks, see Bar::calc_span().
 	void update_width(const std::chrono::days& days_from_interval, const int parent_xpos);
 	
 	///Returns true if it represents a single task, false for a group.
-	bool is_single_task() const {return this->taskgroup.tasks.size() == 1;}
-	///Gets the task which the Bar represent. If the Bar represents a group, it returns the first Task in its Bar_TaskGroup.
-	Task get_single_task() const {return this->taskgroup.tasks[0];}
-	///Returns an upcasted copy of its Bar_TaskGroup.
-	TaskGroup get_taskgroup() const {return this->taskgroup;}
+	bool is_single_task() const {return this->tasks.task_ids().size() == 1;}
+	///Gets the ID of the task which the Bar represent. If the Bar represents a group, it returns the task with the nearest due date.
+	TaskStore::TaskId get_single_task() const {return this->tasks.task_ids().front();}
+	///Gets the ID of the group which the Bar represents in root view, or of the group being viewed in group view.
+	TaskStore::GroupId get_group() const {return this->tasks.group;}
+	///Returns the tasks which the Bar represents.
+	const BarTasks& get_tasks() const {return this->tasks;}
+	
+	///Returns the index of the row of BarGroup which the Bar represents, as set by BarGroup.
+	std::size_t get_item_index() const {return this->item_index;}
 	
 	///Calculates the Bar's height, from the given height of a Bar with yspacing between the Bar below it included.
 	static int calc_height(const int height_with_yspacing) noexcept;
@@ -105,11 +92,25 @@ class Bar : public Fl_Button{
 	static int calc_height(const int bargroup_height, const int bar_count) noexcept;
 	///Calculates the Bar's height with its spacing between other bars, with BarGroup's height and the bar count in BarGroup.
 	static int calc_height_with_yspacing(const int bargroup_height, const int bar_count) noexcept;
-	///Calculates the Bar's ypos from BarGroup's ypos, value for the height of a Bar with yspacing between the Bar below included, and the index of the Bar in BarGroup's container of bars.
+	///Calculates the Bar's ypos from BarGroup's ypos, value for the height of a Bar with yspacing between the Bar below included, and the index of the row of the Bar.
 	static int calc_ypos(const int parent_ypos, const int height_with_yspacing, const int item_index) noexcept;
 	///Calculates width of the Bar, if days_remaining is not positive, the return value is clamped to 0 pixels.
 	///If the return is 0, the task is overdue. You should use BarGroup::overdue_bar_width as the width and move the Bar's xpos to overdue position.
 	static int calc_bar_width(const std::chrono::days& days_remaining, const std::chrono::days& days_from_interval) noexcept;
+	/**
+	Calculates both xpos and width of a Bar representing the tasks.
+	There are 3 cases which result in different xpos and width:
+	- The Bar represents a single task and is overdue, or a group with all the tasks overdue: xpos = parent_xpos, width = BarGroup::overdue_bar_width.
+	- The Bar represents a single task and is not overdue, or a group with no overdue tasks: xpos = parent_xpos + BarGroup::bar_xoffset;  width = Bar::calc_bar_width().
+	- The Bar represents a group with intermixed overdue and non-overdue tasks: xpos = parent_xpos + BarGroup::bar_xoffset; width = BarGroup::overdue_bar_width + Bar::calc_bar_width().
+	
+	xpos at parent_xpos means it is behind the current date line (the left line), with BarGroup::bar_xoffset added makes the Bar to start exactly at the line.
+	*/
+	static BarSpan calc_span(const BarTasks& tasks, const std::chrono::days& days_from_interval, const int parent_xpos) noexcept;
+	///Draws the colors of the tasks of a Bar at the provided xpos, ypos and height, without its label.
+	static void draw_tasks(const BarTasks& tasks, const std::chrono::days& days_from_interval, const int xpos, const int ypos, const int height);
+	///Returns the label (text) of a Bar representing the tasks.
+	static std::string make_label(const BarTasks& tasks);
 
 	protected:
 	///Overrides Fl_Button::draw() to draw multiple colors in same button.
@@ -123,8 +124,10 @@ class Bar : public Fl_Button{
 	int handle(const int event) override;
 
 	private:
-	///A container for a task or multiple tasks, the Bar has to behave based on if this has a single task or multiple tasks (group).
-	Bar_TaskGroup taskgroup;
+	///A task or multiple tasks (group), the Bar has to behave based on if this has a single task or multiple tasks.
+	BarTasks tasks;
+	///The index of the row of BarGroup which the Bar represents, so BarGroup finds the row of a Bar without searching for it.
+	std::size_t item_index;
 	///Days from interval, the interval is just the date timescale ahead of current date.
 	///Which just means how many days are in the selected timescale.
 	std::chrono::days days_from_interval;	
@@ -157,11 +160,11 @@ A struct which simplifies the initialisation of the Bar constructor parameters.
 struct BarConstructorArgs{
 	/**
 	\param parent The pointer of its parent, BarGroup.
-	\param taskgroup A TaskGroup which the Bar will represent.
-	\param task_count The amount of bars in BarGroup, including the Bar which the constructor is about to construct its parameters.
-	\param item_index The index of this Bar in BarGroup's Bar container, which its parameters are being constructed.
+	\param tasks The tasks which the Bar will represent.
+	\param task_count The amount of rows in BarGroup, including the row of the Bar which the constructor is about to construct its parameters.
+	\param item_index The index of the row of this Bar in BarGroup, which its parameters are being constructed.
 	*/
-	BarConstructorArgs(const BarGroup* const parent, const TaskGroup& taskgroup, 
+	BarConstructorArgs(const BarGroup* const parent, const BarTasks& tasks, 
 						const int task_count, const int item_index);
 	
 	int xpos;
@@ -169,7 +172,7 @@ struct BarConstructorArgs{
 	int width;
 	int height;
 	std::chrono::days days_from_interval;
-	Bar_TaskGroup taskgroup;
+	BarTasks tasks;
 };
 
 Fl_Color get_bar_color(const int days_until_deadline) noexcept;
@@ -0,0 +1,54 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef barcanvas_hpp
+#define barcanvas_hpp
+
+#include <FL/Fl.H>
+#include <FL/Fl_Widget.H>
+
+#include <cstdint>
+
+/**
+A single widget which draws the rows of BarGroup in view, for BarGroup::RenderMode::Canvas.
+
+The rows are drawn from the TaskStore of BarGroup in a single draw() pass, as Bar::draw() would draw each of them, without a Bar for each row.
+The row under the mouse is found from the vertical layout and scroll position of BarGroup and the span of the row,
+so clicking, right clicking and dragging a row behaves as Bar::handle() does for a Bar.
+
+BarCanvas does not draw a background, so BarGroup is redrawn rather than BarCanvas alone once the rows change.
+*/
+class BarCanvas : public Fl_Widget{
+	public:
+	BarCanvas(const int xpos, const int ypos, const int width, const int height);
+
+	protected:
+	///Draws every row of BarGroup in view, with its colors and label.
+	void draw() override;
+	///Overrided to handle click, drag and release of mouse controls on the rows, see Bar::handle().
+	int handle(const int event) override;
+
+	private:
+	///Will either request a window for a task or shift to group view, depending on if the row represents a task or a group respectively.
+	///
+	///This function catches throws from requesting a window for editing a task or requesting shifting to group view, and will display a window if an error occurred.
+	void left_mouse_click_callback(const std::size_t item_index);
+	///Will either request a window for a task or for a group, depending on if the row represents a task or a group respectively.
+	///
+	///This function catches throws from requesting windows and will display a window if an error occurred.
+	void right_mouse_click_callback(const std::size_t item_index);
+
+	///The index of the row the mouse button was pushed on, -1 if it was not pushed on a row.
+	std::int_least64_t pushed_item_index;
+};
+
+#endif
@@ -15,15 +15,25 @@ You should have received a copy of the GNU General Public License along with Wor
 
 #include "Bar.hpp"
 #include "Task.hpp"
-#include "Timescale.hpp"
+#include "BarCanvas.hpp"
+#include "timescale.hpp"
+#include "task_index.hpp"
+#include "task_store.hpp"
+#include "task_journal.hpp"
+#include "task_snapshot.hpp"
+#include "background_saver.hpp"
+#include "parse_diagnostics.hpp"
 
 #include <FL/Fl.H>
 #include <FL/Fl_Box.H>
 #include <FL/Fl_Group.H>
+#include <FL/Fl_Scrollbar.H>
 
+#include <string>
 #include <vector>
 #include <memory>
 #include <cstdint>
+#include <optional>
 
 /**
 A container and drawing area for bars. It is responsible for:
@@ -31,56 +41,98 @@ A container and drawing area for bars. It is responsible for:
 - Keeping track of current timescale and requesting the bars to render accordingly.
 - Keeping track of the view mode, request and act accordingly.
 - Keeping track of unsaved changes made to tasks, once its deconstructor is called, it is responsible for giving the user the chance to save their tasks.
+
+Each group in root view, or each task in group view, is a row. The rows share the height of BarGroup down to BarGroup::min_row_height,
+past that they are scrolled, and only the rows in view have a Bar. The bars are kept and bound to other rows as the rows are scrolled,
+so drawing and laying out depends on the height of BarGroup rather than the count of rows.
+
+The rows in view are drawn either by the bars, or by a single BarCanvas without a Bar for each row, see BarGroup::RenderMode.
 */
 class BarGroup : public Fl_Group{
+	//BarCanvas draws and hit-tests the rows in view from the layout of BarGroup.
+	friend class BarCanvas;
+	
 	public:
+	///The ways of drawing the rows in view.
+	enum class RenderMode{
+		///A Bar for each row in view, which is a widget of its own.
+		Widgets,
+		///A single BarCanvas drawing every row in view.
+		Canvas
+	};
+	
+
 	///Initialises its members, but most importantly: constructs the bars from the task file.
 	///
 	///Catches exceptions and display an error window when error occurs while loading tasks to bars.
 	BarGroup(const int xpos, const int ypos, const int width, const int height);
 	
 	///Check if there are any unsaved changes when the program is exiting. If there is, show a window for the user to save.
+	///The journal is then folded into tasks.txt with compact_task_file(), so tasks.txt is current for the programs reading it.
 	///
 	///Catches exceptions and display an error window if errors occurred while displaying an option window or saving tasks to file.
 	virtual ~BarGroup();
 	
 	///Constucts a new Bar which represent the provided task, readjust vertical scale, and redraw BarGroup.
 	void add_task(const Task& task);
-	/**
-	Deletes the Bar at given index, readjust vertical scale, and redraw BarGroup. 
-	The Bar may either represent a task or a group.
-	
-	If the index refers to an invalid Bar or the index is invalid for this->paged_taskgroups, it does nothing and returns false. Else returns true.
-	*/
-	bool delete_bar(const int item_index);
-	///Request the Bar at the provided index to change its task properties accordingly. This redraws BarGroup.
+	///Deletes the task and its Bar, readjust vertical scale, and redraw BarGroup. A task with a Bar of its own in root view is deleted with its group.
+	///\returns false if no Bar represents the task alone, or the task was erased since the handle was taken.
+	bool delete_task(const TaskStore::TaskHandle& task);
+	///Deletes the group, its tasks and its Bar, readjust vertical scale, and redraw BarGroup.
+	///\returns false if no Bar represents the group, or the group was erased since the handle was taken.
+	bool delete_group(const TaskStore::GroupHandle& group);
+	///Changes the properties of the task, and requests its Bar to display them. This redraws BarGroup.
 	///
-	///Throws std::invalid_argument if the index refers to an invalid Bar.
-	void modify_task(const char* const task_name, const std::chrono::year_month_day& due_date, const int item_index);
-	///Request the Bar at the provided index to change its group name. This redraws BarGroup.
-	///\returns false if the index refers to an invalid Bar.
-	bool modify_group(const char* const group_name, const int item_index);
+	///Throws std::invalid_argument if no Bar represents the task alone, or the task was erased since the handle was taken.
+	void modify_task(const char* const task_name, const std::chrono::year_month_day& due_date, const TaskStore::TaskHandle& task);
+	///Changes the name of the group, and requests its Bar to display it. This redraws BarGroup.
+	///\returns false if no Bar represents the group, or the group was erased since the handle was taken.
+	bool modify_group(const char* const group_name, const TaskStore::GroupHandle& group);
 
 	///Passes request for showing a window for editing task, from Bar to MainWindow.
 	///\returns false if the Bar is not a member of BarGroup.
 	bool request_window_for_editing_task(const Bar* const bar);
+	///Passes request for showing a window for editing the task of the row, from BarCanvas to MainWindow.
+	///\returns false if there is no row at the index.
+	bool request_window_for_editing_task(const std::size_t item_index);
 	///Passes request for showing a window for editing group, from a Bar to MainWindow.	
 	///\returns false if the Bar is not a member of BarGroup.	
 	bool request_window_for_editing_group(const Bar* const bar);
+	///Passes request for showing a window for editing the group of the row, from BarCanvas to MainWindow.
+	///\returns false if there is no row at the index.
+	bool request_window_for_editing_group(const std::size_t item_index);
 	
-	///Save the bars in root view to this->paged_taskgroups and shift from root view to group view.
+	///Shift from root view to group view, displaying the tasks of the group of the Bar.
 	///
 	///Throws std::invalid_argument if the pointer is not a member of BarGroup.
 	///This redraws BarGroup.
 	void display_tasks_in_task_group(const Bar* const bar);
+	///Shift from root view to group view, displaying the tasks of the group of the row.
+	///
+	///Throws std::invalid_argument if there is no row at the index.
+	///This redraws BarGroup.
+	void display_tasks_in_task_group(const std::size_t item_index);
 	///Shift from group view back to root view. This redraws BarGroup.
 	void show_taskgroups();
 	
 	///Saves the current state of all tasks and groups to task file. 
 	///The function is able to be called while in root view and group view as well.
+	///
+	///Only the changes made since the last save are appended to the journal of the task file, unless the journal is large enough to be folded into the task file,
+	///or the journal cannot represent the changes; the entire task file is rewritten then.
+	///May throw std::ios_base::failure if the task file or journal could not be written, or the journal would be appended to a task file changed since it was loaded,
+	///the changes are kept as unsaved then.
 	void save_tasks_to_file();
+	///Saves as in save_tasks_to_file(), but only copies the tasks and groups here and writes them on the worker thread of the saver.
+	///The changes count as saved once submitted, handle_failed_save() must be called if the saver reports the save failed or was cancelled.
+	void save_tasks_to_file(BackgroundSaver& saver);
+	///Marks the changes as unsaved again after a save submitted to BackgroundSaver failed, and makes the next save rewrite the entire task file.
+	void handle_failed_save();
+	///Makes the next save rewrite the entire task file, after the task file was changed outside of WorkTable and the changes here are kept over it.
+	void handle_task_file_changed();
 	///Reverts the current state of all tasks and groups back to of the task file.
-	///The function is able to be called while in root view and group view as well.	
+	///Only the bars of the groups which differ from the task file are replaced, unless the task file is loaded lazily.
+	///Must be called in root view, see show_taskgroups().
 	///
 	///May throw std::ios_base::failure for unspecified IO error or std::runtime_error when the file cannot be opened.
 	void revert_to_tasks_from_file();
@@ -89,6 +141,8 @@ class BarGroup : public Fl_Group{
 	///
 	///This function will either: move the task out of the task group and hide the root group box of MainWindow, merge the bar with another bar, or do nothing if the bar was released elsewhere.
 	void handle_bar_mouse_button_release(const Bar* const clicked_bar);
+	///As handle_bar_mouse_button_release() for a Bar, called by BarCanvas with the row the mouse button was pushed on.
+	void handle_bar_mouse_button_release(const std::size_t clicked_item_index);
 	///This function will request MainWindow to show the root group box if the current view mode is in group view.
 	///Else do nothing.
 	void signal_bar_being_dragged();
@@ -113,6 +167,12 @@ class BarGroup : public Fl_Group{
 	///\returns the current timescale after being widen.	
 	Timescale zoomout_timescale();
 	
+	///Changes how the rows in view are drawn. This redraws BarGroup.
+	void set_render_mode(const RenderMode render_mode);
+	RenderMode get_render_mode() const {return this->render_mode;}
+	///Returns the name of the render mode, for displaying.
+	static const char* render_mode_name(const RenderMode render_mode) noexcept;
+	
 	static constexpr int width = 1400;	///< Value for width argument for the caller constructing this object.
 	static constexpr int height = 700;	///< Value for height argument for the caller constructing this object.
 	static constexpr int bar_xoffset = 50;	///< Horizontal offset for bars which do not have overdue tasks.
@@ -128,38 +188,109 @@ class BarGroup : public Fl_Group{
 	The other [bar_xoffset] pixels are for non-overdue bars which have [bar_xoffset] pixels of xoffset because the current date line (left line) is drawn [bar_xoffset] pixels after the xpos of BarGroup and that is where non-overdues start.
 	*/
 	static constexpr int bar_max_width = width - (2*bar_xoffset);
+	///The least height of a row, which is the height of a Bar with the spacing below it. BarGroup scrolls once its rows do not fit at this height.
+	static constexpr int min_row_height = 20;
+	///Width of the scrollbar, which is in the space right of the interval line.
+	static constexpr int scrollbar_width = 15;
 	
 	protected:
 	///Overrided Fl_Group::draw() to draw the left and right lines.
 	void draw() override;
+	///Overrided Fl_Group::handle() to scroll the rows with the mouse wheel anywhere in BarGroup, as the bars do not take the mouse wheel.
+	int handle(const int event) override;
 		
 	private:
-	///Constucts bars which represent tasks and groups in task file.
+	///Constucts bars which represent tasks and groups in task file, replacing the bars constructed before.
+	///A large task file is loaded lazily, only the groups due by this->next_interval are constructed as bars.
 	///
 	///May throw std::ios_base::failure for unspecified IO error or std::runtime_error when the file cannot be opened.	
 	void load_tasks_to_bars();
+	///Constructs the bars of the groups not loaded yet which are due by this->next_interval, in their places among the bars in root view.
+	///Does nothing in group view, or if every group is loaded.
+	void load_due_taskgroups();
+	///Returns the index of the group in the journal, which counts the groups not loaded yet, from its index in this->root_groups.
+	std::size_t get_taskgroup_index(const std::size_t item_index) const;
+	///Replaces the bars of the groups which differ from the provided groups, found with task_diff::diff(), and leaves the other bars as is.
+	///Redraws only the replaced bars, or BarGroup entirely if the count of bars changed.
+	void apply_changed_taskgroups(const std::vector<TaskGroup>& taskgroups);
+	///Returns every group in root view, loading the ones not loaded yet, for rewriting the entire task file.
+	///The errors found while loading are recorded to this->load_diagnostics, see show_load_diagnostics().
+	std::vector<TaskGroup> get_all_taskgroups() const;
+	///Displays the errors recorded to this->load_diagnostics in a single window and clears them. Does nothing if none were recorded.
+	void show_load_diagnostics();
 	
 	/**
-	Constructs a bar and takes ownership of it. It does not adjust BarGroup's vertical layout or redraw.
-	This function is used for adding multiple bars without recalculating, readjusting and redrawing for performance.
+	Appends a row to this->rows. It does not adjust BarGroup's vertical layout or redraw.
+	This function is used for adding multiple rows without recalculating, readjusting and redrawing for performance.
 	
-	The bar may either represent a single task or a group, depending on if the provided TaskGroup has a single task or multiple tasks in it, respectively.
+	The row represents the group in root view if task is TaskStore::no_id, else the task of the group being viewed in group view.
 	*/
-	void add_bar(const TaskGroup& taskgroup, const int total_items, const int item_index);
-	
+	void add_bar(const TaskStore::GroupId group, const TaskStore::TaskId task);
+	///Adds the group to this->task_store and this->root_groups at the provided index, and inserts its row there in this->rows. 
+	///It does not adjust BarGroup's vertical layout or redraw.
+	void insert_bar(const TaskGroup& taskgroup, const std::size_t item_index);
 	/**
-	Constructs a bar, takes ownership of it, readjusts vertical layout and redraws BarGroup.
-	This is convenient for adding a single bar.
+	Deletes the row at given index, readjust vertical scale, and redraw BarGroup. 
+	The row may either represent a task or a group, which is erased from this->task_store.
 	
-	The bar may either represent a single task or a group, depending on if the provided TaskGroup has a single task or multiple tasks in it, respectively.
+	If the index refers to an invalid row, it does nothing and returns false. Else returns true.
 	*/
-	void add_bar(const Task& task);
+	bool delete_bar(const int item_index);
+	///Removes the row at the given index, without changing what it represents. It does not adjust BarGroup's vertical layout or redraw.
+	void remove_bar(const std::size_t item_index);
+	///Removes every row, the bars are kept for the rows added afterwards.
+	void clear_bars();
+	///Sets the rows of this->group_rows and this->task_rows from the provided index to the end of this->rows, after rows were inserted or erased before them.
+	void renumber_bars(const std::size_t first_item_index);
+	///Updates the Bar of the row after its tasks or group name changed in this->task_store, and damages the row to draw it again. 
+	///Does nothing if the row is not in view.
+	void refresh_bar(const std::size_t item_index);
+	/**
+	Damages the area of the rows from first_item_index to before last_item_index, or to the bottom of BarGroup if last_item_index is BarGroup::no_row,
+	so FLTK only draws that area of BarGroup again, along with the parts of the date lines in it. The area out of view is left out.
+	*/
+	void damage_rows(const std::size_t first_item_index, const std::size_t last_item_index);
+	///Returns the Bar of the row, or nullptr if the row is not in view or the rows are drawn by this->canvas.
+	Bar* get_bar(const std::size_t item_index) const;
+	///Returns true if the row represents a single task, false for a group.
+	bool row_is_single_task(const std::size_t item_index) const {return this->rows[item_index].task_ids().size() == 1;}
+	
+	///Marks the tasks as having unsaved changes after an edit, and notifies MainWindow for autosaving.
+	void mark_tasks_changed();
+	
+	///Returns the job writing the changes since the last save, which owns a copy of what it writes. The changes count as saved afterwards.
+	BackgroundSaver::Job take_save_job();
 	
-	///Returns the index of the pointer in this->bars. If the pointer is not in the container, a -1 is returned.
+	///Returns the index of the row which the Bar represents in this->rows. If the pointer is not a Bar in view, a -1 is returned.
 	int_least64_t get_item_index(const Bar* const bar) const;
+	///Returns the index of the row in this->rows representing only the task. If there is none, or the task was erased since the handle was taken, a -1 is returned.
+	int_least64_t get_task_item_index(const TaskStore::TaskHandle& task) const;
+	///Returns the index of the row in this->rows representing the group in root view. If there is none, or the group was erased since the handle was taken, a -1 is returned.
+	int_least64_t get_group_item_index(const TaskStore::GroupHandle& group) const;
+	///Returns the index of the row in this->rows at the provided vertical position, from the vertical layout and the scroll position. If there is none, a -1 is returned.
+	int_least64_t get_item_index_at(const int ypos) const;
+	///Returns the index of the row in this->rows whose Bar is at the provided position, from the vertical layout, the scroll position and the span of the row. 
+	///If there is none, a -1 is returned.
+	int_least64_t get_item_index_at(const int xpos, const int ypos) const;
 	
-	///Readjusts vertical layout in order to fit all of its bars properly without calling this->redraw().
-	void adjust_vertical_layout();
+	///Returns the height of a row, which is the height of a Bar with the spacing below it.
+	int row_height() const;
+	///Returns the ypos of the Bar of the row, from the scroll position.
+	int row_ypos(const std::size_t item_index) const;
+	///Returns the position the rows are scrolled to in pixels, 0 if they are not scrolled.
+	int scroll_position() const;
+	/**
+	Readjusts the height of the rows and the scrollbar to the count of rows, then lays out the rows in view with this->layout_rows().
+	The rows stay scrolled to where they were, as far as the rows reach.
+	
+	Only the rows from first_changed_item_index are damaged to be drawn again, as the rows before it stay where they were,
+	unless the rows were resized or scrolled, which redraws BarGroup entirely.
+	*/
+	void adjust_vertical_layout(const std::size_t first_changed_item_index = 0);
+	///Binds the bars to the rows in view and places them by the scroll position, constructing bars until there are enough for the rows in view.
+	///Only the bars bound to another row are updated, the bars left without a row are hidden.
+	///Every Bar is hidden when the rows are drawn by this->canvas, which draws the rows in view instead.
+	void layout_rows();
 	/**
 	Recalculates the date timescale ahead from today, changes this->interval_date_label, and requests its bars to adjust its widths. This redraws BarGroup.
 	If the timescale requested is the same of what BarGroup has, it does nothing.
@@ -179,39 +310,96 @@ class BarGroup : public Fl_Group{
 	///Returns true if a Bar was dropped in the root group box of MainWindow.
 	bool check_mouse_released_in_root_group_box();
 	
+	///Called by this->scrollbar when the rows are scrolled, lays out the rows in view and redraws BarGroup.
+	static void scrollbar_callback(Fl_Widget* const self_ptr, void* const data);
+	
 	private:
+	///What each row represents, from top to bottom. The rows in view have a Bar of this->bars, the others have none.
+	std::vector<BarTasks> rows;
+	/**
+	The bars for the rows in view, which are constructed as needed and kept afterwards, so there are only as many as the rows which fit in view.
+	The n-th Bar represents the n-th row in view, the bars after this->visible_row_count are hidden.
+	*/
 	std::vector<std::unique_ptr<Bar>> bars;
+	///The index in this->rows of the row in view at the top.
+	std::size_t first_visible_row;
+	///The count of rows in view, which have a Bar.
+	std::size_t visible_row_count;
+	///The row of each group in root view, indexed by TaskStore::GroupId, BarGroup::no_row for the groups without one.
+	std::vector<std::size_t> group_rows;
+	///The row of each task in group view, indexed by TaskStore::TaskId, BarGroup::no_row for the tasks without one.
+	std::vector<std::size_t> task_rows;
+	///A value of this->group_rows and this->task_rows for the groups and tasks without a row.
+	static constexpr std::size_t no_row = SIZE_MAX;
+	///The scroll position of root view, which is restored when shifting back from group view.
+	int root_scroll_position;
+	///The height of the rows and the scroll position of the last this->layout_rows(), for finding whether the rows in view moved since.
+	int laid_out_row_height;
+	int laid_out_scroll_position;
 	
 	/**
-	This stores all of the TaskGroup of all the bars in root view in order to shift back from group view.
-	
-	You would iterate over each Bar in root view and store their TaskGroup before shifting to group view.
-	If a task is added, modified, deleted or moved out while in group view, 
-	it must be properly recorded to the container as in the perspective of root view as well.
-	In root view, it is not necessary to access this.
+	The groups of the rows in root view, in the order of the rows, which are kept while in group view in order to shift back from it.
+	In root view, the n-th row represents the n-th group.
 	*/
-	std::vector<TaskGroup> paged_taskgroups;
+	std::vector<TaskStore::GroupId> root_groups;
 	/**
 	This is the index of the task group being viewed in group view.
 	
 	This should be set accordingly in order to determine whether BarGroup is in root view or group view.
 	If it is set to BarGroup::not_in_any_group, then BarGroup is assumed to be in root view, else in group view.
-	It is also used for accessing and identifying the exact group in this->paged_taskgroups which is being displayed by BarGroup.
+	It is also used for accessing and identifying the exact group in this->root_groups which is being displayed by BarGroup.
 	*/
 	std::int_least64_t task_group_id;
+	
+	/**
+	The groups of a task file loaded lazily in the order of the journal, empty if every group is loaded.
+	
+	A group not loaded yet is its span in this->unloaded_task_file, and a loaded group is std::nullopt. 
+	The loaded groups are this->root_groups in the same order, so the n-th std::nullopt is the n-th group. See BarGroup::get_taskgroup_index().
+	*/
+	std::vector<std::optional<task_index::Span>> root_slots;
+	///The text of the task file loaded lazily, which the groups of this->root_slots not loaded yet are parsed from.
+	std::string unloaded_task_file;
+	///The errors of the lines skipped while loading tasks, displayed together once loading is done instead of a window for each line.
+	///Mutable as get_all_taskgroups() loads the groups not loaded yet.
+	mutable parse_diagnostics::Collector load_diagnostics;
 	///A value of this->task_group_id conveying BarGroup is not in any specific task group, i.e., BarGroup is in root view.
 	///Use this->displaying_a_taskgroup() to determine if BarGroup is displaying a specific group or not.
 	static constexpr const std::int_least64_t not_in_any_group = -1;
 	
 	Fl_Box current_date_label;
 	Fl_Box interval_date_label;
+	Fl_Scrollbar scrollbar;
+	///Draws the rows in view when this->render_mode is RenderMode::Canvas, else hidden.
+	BarCanvas canvas;
+	RenderMode render_mode;
 		
 	Timescale current_timescale;
 	
 	const std::chrono::year_month_day current_ymd;	
 	std::chrono::year_month_day next_interval;
+	
+	///The tasks and groups loaded, which the bars refer to by ID. The days remaining are counted from this->current_ymd.
+	TaskStore task_store;
 
 	bool unsaved_changes_made_to_tasks;
+	///The changes made to the groups in root view since the last save, which are appended to the journal of the task file on save.
+	std::vector<task_journal::Operation> unsaved_operations;
+	/**
+	True if loading the task file and replaying its journal results in the groups before this->unsaved_operations, 
+	so saving can append this->unsaved_operations to the journal.
+	
+	It is false if the tasks could not be loaded, or a group without tasks was saved, as it is dropped once loaded and the indices of the operations would no longer match.
+	Saving then rewrites the entire task file.
+	*/
+	bool journal_in_sync;
+	/**
+	The stamp of tasks.txt as it was last loaded or written, which saving checks tasks.txt against before appending this->unsaved_operations to the journal.
+	
+	A save rewriting tasks.txt replaces it with an empty stamp, which the save fills in on the worker thread of BackgroundSaver once it has written tasks.txt,
+	so the saves queued after it are checked against the task file it wrote. Once shared with a save, only the saves read and fill it in.
+	*/
+	std::shared_ptr<std::optional<task_snapshot::SourceStamp>> task_file_stamp;
 		
 	static constexpr int date_label_yraise = 20;
 	static constexpr int date_label_width = 70;
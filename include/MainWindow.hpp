@@ -15,6 +15,10 @@ You should have received a copy of the GNU General Public License along with Wor
 
 #include "Task.hpp"
 #include "BarGroup.hpp"
+#include "autosave.hpp"
+#include "file_watch.hpp"
+#include "task_store.hpp"
+#include "background_saver.hpp"
 
 #include "TaskGroupWindow.hpp"
 #include "TaskPropertiesWindow.hpp"
@@ -23,44 +27,53 @@ You should have received a copy of the GNU General Public License along with Wor
 #include<FL/Fl_Box.H>
 #include<FL/Fl_Button.H>
 #include<FL/Fl_Window.H>
+#include<FL/Fl_Light_Button.H>
 
 /**
 The main window of the program.
 It contains most of the upfront buttons, timescale buttons and label, BarGroup, and owns TaskPropertiesWindow and TaskGroupWindow for manipulating tasks and groups respectively.
 It also passes requests between the buttons, BarGroup, or the two windows.
+
+Saves are written on the worker thread of its BackgroundSaver, and the result is shown in a status box next to the buttons once the save finishes.
+With autosave turned on, the edits are saved by themselves on the schedule of autosave::Scheduler.
+The task file is watched with FileWatcher, so the edits made to it by other programs are shown without reverting by hand.
 */
 class MainWindow : public Fl_Window{
 	public:
 	MainWindow(const int xpos, const int ypos, const int width, const int height, const char* window_title = 0);
+	///Waits for the saves still being written, so BarGroup can offer to save the changes of a failed one before exiting.
+	virtual ~MainWindow();
 	
 	///Passes add task requests from this->task_properties_window to this->bar_group.
 	void add_task(const Task& task); 	
-	///Passes deletion requests of a Bar at given index which represents a task or a group. 
-	///Passes the request from this->task_properties_window or this->task_group_window to this->bar_group.
-	///\return false if the given index refers to an invalid Bar.	
-	bool delete_bar(const int item_index); 
+	///Passes task deletion requests from this->task_properties_window to this->bar_group.
+	///\return false if no Bar represents the task.	
+	bool delete_task(const TaskStore::TaskHandle& task); 
+	///Passes group deletion requests from this->task_group_window to this->bar_group.
+	///\return false if no Bar represents the group.	
+	bool delete_group(const TaskStore::GroupHandle& group); 
 	///Passes task edit requests from this->task_properties_window to this->bar_group.
 	///
-	///May rethrow std::invalid_argument if the provided index refers to an invalid task.
-	void modify_task(const char* const task_name, const std::chrono::year_month_day& due_date, const int item_index);
+	///May rethrow std::invalid_argument if no Bar represents the task.
+	void modify_task(const char* const task_name, const std::chrono::year_month_day& due_date, const TaskStore::TaskHandle& task);
 	///Passes task group name edit requests from this->task_group_window to this->bar_group.
-	///\return false if the given index refers to an invalid Bar.
-	bool modify_taskgroup_name(const char* const group_name, const int item_index);
+	///\return false if no Bar represents the group.
+	bool modify_taskgroup_name(const char* const group_name, const TaskStore::GroupHandle& group);
 	
 	///Passes requests from this->new_task_button to show this->task_properties_window for creating a new task.
 	void show_window_for_creating_new_task();
 	/**
 	Passes requests from this->bar_group to show this->task_properties_window for editing or deleting the task.
 	\param[in] task_properties The Task object which the Bar requesting the window represents.
-	\param[in] item_index An index of the Bar in this->bar_group::bars which requested the window. 
+	\param[in] task The handle of the task in the TaskStore of this->bar_group. 
 	*/
-	void show_window_for_editing_task(const Task& task_properties, const int item_index);
+	void show_window_for_editing_task(const Task& task_properties, const TaskStore::TaskHandle& task);
 	/**
 	Passes requests from this->bar_group to show this->task_group_window for editing or deleting task group.
 	\param[in] group_name The name of the task group which the Bar requesting the window represents.
-	\param[in] item_index An index of the Bar in this->bar_group::bars which requested the window. 
+	\param[in] group The handle of the group in the TaskStore of this->bar_group. 
 	*/	
-	void show_window_for_editing_group(const std::string& group_name, const int item_index);
+	void show_window_for_editing_group(const std::string& group_name, const TaskStore::GroupHandle& group);
 	
 	///Shows this->root_group_box. This is called from this->bar_group when in group view and a Bar is being dragged.
 	void show_root_group_box();
@@ -70,14 +83,30 @@ class MainWindow : public Fl_Window{
 	///This function catches throws and shows an error window if caught.
 	void show_taskgroups();
 	
-	///Passes save requests from MainWindow::save_button_callback() to this->bar_group.
+	///Passes save requests from MainWindow::save_button_callback() to this->bar_group, which submits the save to this->saver.
+	///The window stays responsive while the save is written, and this->save_status_box shows its progress.
 	///
 	///This function catches throws and shows an error window if caught.
 	void save_tasks_to_file();
+	///Called by this->bar_group after every edit made to the tasks. With autosave turned on, this schedules the edits to be saved.
+	///This only records the time of the edit and moves a timeout, so it is cheap enough for every edit.
+	void handle_tasks_changed();
+	///Saves the edits if autosave is turned on and they are due, or moves the timeout to when they are due. Called from the autosave timeout.
+	void autosave();
+	
+	///Takes the results of the finished saves from this->saver and shows them in this->save_status_box.
+	///The changes of a failed save are marked as unsaved in this->bar_group again, and the task file written by a save is acknowledged in this->task_file_watcher.
+	void show_save_results();
 	///Passes task revert requests from MainWindow::discard_button_callback() to this->bar_group.	
 	///
 	///This function catches throws and shows an error window if caught.	
 	void revert_to_tasks_from_file();
+	///Reloads the task file into this->bar_group if it was changed outside of WorkTable, called when this->task_file_watcher wakes the event loop.
+	///Only the bars of the changed groups are replaced. If there are unsaved changes, a window asks whether to keep them instead.
+	///The task file is not checked while this->saver is busy, but once the results of the saves are taken.
+	///
+	///This function catches throws and shows an error window if caught.
+	void reload_changed_task_file();
 
 	///Passes requests from MainWindow::zoomin_button_callback() to this->bar_group to narrow down (zoom in) the timescale. This redraws MainWindow.
 	///
@@ -88,6 +117,16 @@ class MainWindow : public Fl_Window{
 	///This function catches throws and shows an error window if caught.	
 	void zoomout_timescale();	
 	
+	///Passes requests from main() to this->bar_group to change how it draws its rows.
+	void set_bar_render_mode(const BarGroup::RenderMode render_mode);
+	/**
+	Draws this->bar_group the provided count of frames with each BarGroup::RenderMode, and shows the average time to draw a frame with each in a window.
+	The render mode of this->bar_group is restored afterwards. MainWindow must be shown.
+	
+	The time is of FLTK drawing this->bar_group, the display server may finish showing the frame afterwards.
+	*/
+	void compare_bar_render_modes(const int frame_count);
+	
 	///Activates this->task_group_button when requested by this->bar_group.
 	void enable_taskgroup_button();
 
@@ -99,6 +138,20 @@ class MainWindow : public Fl_Window{
 	static void zoomin_button_callback(Fl_Widget* const self_ptr, void* const data);
 	static void zoomout_button_callback(Fl_Widget* const self_ptr, void* const data);
 	
+	static void autosave_button_callback(Fl_Widget* const self_ptr, void* const data);
+	static void autosave_timeout_callback(void* const data);
+	
+	///Called by this->saver from its worker thread once a save finishes, wakes the event thread with Fl::awake() to call MainWindow::save_results_callback().
+	static void save_finished_callback(void* const data);
+	///Called on the event thread after MainWindow::save_finished_callback(), calls MainWindow::show_save_results(), then MainWindow::reload_changed_task_file().
+	static void save_results_callback(void* const data);
+	///Called by FLTK once the file descriptor of this->task_file_watcher is readable, calls MainWindow::reload_changed_task_file().
+	static void task_file_changed_callback(const int fd, void* const data);
+	///Called every FileWatcher::poll_interval seconds if the task file is polled, calls MainWindow::reload_changed_task_file().
+	static void task_file_poll_callback(void* const data);
+	///Called once MainWindow is shown if WorkTable was started with --compare-renderers, calls MainWindow::compare_bar_render_modes().
+	static void compare_bar_render_modes_callback(void* const data);
+	
 	static constexpr int width = 1600;	///< Value for width argument for the caller constructing this object.
 	static constexpr int height = 900;	///< Value for height argument for the caller constructing this object.
 	
@@ -116,15 +169,36 @@ class MainWindow : public Fl_Window{
 	Fl_Box timescale_text_box;
 	
 	Fl_Box root_group_box;
+	Fl_Light_Button autosave_button;
+	///Shows whether the last save is being written, saved or failed, without blocking the window as fl_alert() does.
+	Fl_Box save_status_box;
+	
+	autosave::Scheduler autosave_scheduler;
+	FileWatcher task_file_watcher;
+	///Declared last, so the saves still queued are written before the other members are destroyed.
+	BackgroundSaver saver;
 	
 	static constexpr int button_width = 25;
 	static constexpr int button_height = 25;
 	static constexpr int timescale_text_box_width = 100;
 	static constexpr int timescale_text_box_height = 25;
+	static constexpr int save_status_box_width = 400;
+	static constexpr int autosave_button_width = 90;
+	///The count of frames drawn with each BarGroup::RenderMode by MainWindow::compare_bar_render_modes_callback().
+	static constexpr int compared_frame_count = 200;
+	
+	///Submits the save of this->bar_group to this->saver and records it in this->autosave_scheduler.
+	void submit_save();
+	///Adds the autosave timeout for when the edits waiting to be saved are due, replacing the one added before.
+	void schedule_autosave();
+	///Leaves group view, then reverts this->bar_group to the task file once the saves being written are finished. Shared by reverting and reloading.
+	///
+	///May throw what BarGroup::revert_to_tasks_from_file() throws.
+	void reload_task_file();
 	
 	public:
-	///Hides this->root_group_box when requested by BarGroup.
-	void hide_root_group_box() {this->root_group_box.hide();}
+	///Hides this->root_group_box when requested by BarGroup, drawing only the area it covered again.
+	void hide_root_group_box();
 	///Returns true if a mouse drag was released in this->root_group_box.
 	bool mouse_released_in_root_group_box() const {return Fl::event_inside(&(this->root_group_box));}
 	
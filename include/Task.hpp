@@ -14,36 +14,53 @@ You should have received a copy of the GNU General Public License along with Wor
 #define Task_hpp
 
 #include "time_calc.hpp"
+#include "name_pool.hpp"
 
 #include <vector>
 #include <string>
 #include <chrono>
+#include <cstdint>
+#include <string_view>
 
+/**
+A task with a due date and a name, which is 12 bytes: the due date is stored as days since 1970/01/01,
+the days remaining are cached as of the date the due date was set, and the name is a counted reference into name_pool.
+Reading the name never allocates nor locks. Copying or destroying a Task costs an atomic increment or decrement of the count of its name,
+and destroying the last Task or name_pool::Name of a name also locks the pool to release the name. The due date must be a valid date.
+*/
 class Task{
 	public:
-	Task() :_due_date(), _days_remaining(0), _name(){};
-	Task(const std::chrono::year_month_day& due_date, const std::string& name);	
-	Task(const std::chrono::year_month_day& due_date, const std::string& name, const std::chrono::year_month_day& current_ymd);
+	Task() noexcept :_due_date(0), _days_remaining(0), _name(){};
+	Task(const std::chrono::year_month_day& due_date, const std::string_view name);	
+	Task(const std::chrono::year_month_day& due_date, const std::string_view name, const std::chrono::year_month_day& current_ymd);
+	///Constructs the task with a name interned before, without looking the name up in name_pool again.
+	Task(const std::chrono::year_month_day& due_date, const name_pool::Name& name, const std::chrono::year_month_day& current_ymd);
 	
-	std::chrono::year_month_day due_date() const;
-	std::chrono::days days_remaining() const;
+	std::chrono::year_month_day due_date() const noexcept;
+	std::chrono::days days_remaining() const noexcept;
 	
-	std::string name() const;
+	///The characters of the name are null terminated, and stay valid while the task or a copy of it keeps the name.
+	std::string_view name() const noexcept;
+	///Equal handles mean equal names, so tasks can be compared by name without comparing the characters.
+	name_pool::Handle name_handle() const noexcept {return this->_name.handle();}
+	///The reference to the name, for keeping the name without interning it again.
+	const name_pool::Name& interned_name() const noexcept {return this->_name;}
 	
 	void due_date(const std::chrono::year_month_day& new_due_date);
-	void name(const std::string& new_name);
+	void name(const std::string_view new_name);
 	
 	static bool due_date_is_earlier(const Task& lhs, const Task& rhs) noexcept;	
 	static bool due_date_is_later(const Task& lhs, const Task& rhs) noexcept;	
 	
 	private:
-	std::chrono::year_month_day _due_date;
-	std::chrono::days _days_remaining;
-	std::string _name;
+	///days since 1970/01/01.
+	std::int32_t _due_date;
+	std::int32_t _days_remaining;
+	name_pool::Name _name;
 };
 
 inline bool operator==(const Task& lhs, const Task& rhs){
-	return (lhs.name() == rhs.name()) && (lhs.due_date() == rhs.due_date());
+	return (lhs.name_handle() == rhs.name_handle()) && (lhs.due_date() == rhs.due_date());
 }
 inline bool operator!=(const Task& lhs, const Task& rhs){
 	return !(lhs == rhs);
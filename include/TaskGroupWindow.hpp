@@ -13,6 +13,8 @@ You should have received a copy of the GNU General Public License along with Wor
 #ifndef taskgroupwindow_hpp
 #define taskgroupwindow_hpp
 
+#include "task_store.hpp"
+
 #include <FL/Fl.H>
 #include <FL/Fl_Box.H>
 #include <FL/Fl_Input.H>
@@ -40,16 +42,16 @@ class TaskGroupWindow : public Fl_Window{
 	MainWindow* const main_window;
 	
 	/**
-	This stores the index of the Bar in BarGroup::bars which requested the window to be shown.
-	The index is provided when a request is passed from BarGroup.
+	This stores the handle of the group in the TaskStore of BarGroup, which the Bar requesting the window to be shown represents.
+	The handle is provided when a request is passed from BarGroup, and no longer finds the group once a reload of the task file erased it.
 	*/
-	int modifying_item_index;
+	TaskStore::GroupHandle modifying_group;
 	
 	public:
 	TaskGroupWindow(const int width, const int height, MainWindow* const main_window);
 	
 	///Sets the window label as the provided group_name, and loads group_name into this->task_name_dialog.
-	void store_group(const std::string& group_name, const int item_index);
+	void store_group(const std::string& group_name, const TaskStore::GroupHandle& group);
 	
 	///Calls this->modify_task(). This is invoked from TaskGroupWindow::save_button_callback().
 	void save_button_pressed();
@@ -64,13 +66,13 @@ class TaskGroupWindow : public Fl_Window{
 
 	private:
 	/**
-	Requests this->main_window to delete a Bar at this->modifying_item_index which represents a task group.
-	If the index is invalid or a throw was caught, a window would pop up notifying the error.
+	Requests this->main_window to delete this->modifying_group.
+	If the group is invalid or a throw was caught, a window would pop up notifying the error.
 	*/
 	void delete_group();	
 	/**
-	Requests this->main_window to edit the name of a Bar at this->modifying_item_index which represents a task group.
-	If the group name or index is invalid or a throw was caught, a window would pop up notifying the error.	
+	Requests this->main_window to edit the name of this->modifying_group.
+	If the group name or group is invalid or a throw was caught, a window would pop up notifying the error.	
 	*/
 	void modify_group_name();
 	
@@ -14,6 +14,7 @@ You should have received a copy of the GNU General Public License along with Wor
 #define taskpropertieswindow_hpp
 
 #include "Task.hpp"
+#include "task_store.hpp"
 
 #include <FL/Fl.H>
 #include <FL/Fl_Box.H>
@@ -42,9 +43,9 @@ class TaskPropertiesWindow : public Fl_Window{
 	loading the input fields with data from provided task argument, chaning button labels, 
 	and sets this->current_mode to TaskPropertiesWindow::Mode::EditTask.
 	\param[in] task A task which is represented by a Bar in BarGroup.
-	\param[in] item_index An index of the Bar in BarGroup::bars requesting this window for editing or deleting its task.
+	\param[in] task_handle The handle of the task in the TaskStore of BarGroup.
 	*/
-	void store_task(const Task& task, const int item_index);
+	void store_task(const Task& task, const TaskStore::TaskHandle& task_handle);
 	
 	/**
 	This either calls this->add_task() or this->modify_task() depending if this->current_mode is TaskPropertiesWindow::Mode::CreateNewTask or TaskPropertiesWindow::Mode::EditTask respectively.
@@ -70,17 +71,17 @@ class TaskPropertiesWindow : public Fl_Window{
 	/**
 	Send a task add request to this->main_window after validating the task name and due date field.
 	
-	If this->modifying_item_index is invalid or a throw was caught, a warning window would pop up.
+	If a throw was caught, a warning window would pop up.
 	*/
 	void add_task();
 	/**
-	Send a task deletion request for the task at this->modifying_item_index to this->main_window.
+	Send a task deletion request for this->modifying_task to this->main_window.
 	
-	If this->modifying_item_index is invalid or a throw was caught, a warning window would pop up.
+	If this->modifying_task is invalid or a throw was caught, a warning window would pop up.
 	*/
 	void delete_task();	
 	/**
-	Sends a task edit request for the task at this->modifying_item_index to this->main_window after validating the task name and due date field.
+	Sends a task edit request for this->modifying_task to this->main_window after validating the task name and due date field.
 	If either is invalid, warn with this->warning_message.
 	If throw was caught, a warning window would pop up.	
 	*/
@@ -100,10 +101,11 @@ class TaskPropertiesWindow : public Fl_Window{
 	MainWindow* const main_window;
 	
 	/**
-	This stores the index of a bar in BarGroup::bars which represent a task. 
-	A valid index will be provided by requests from this->main_window, which is provided by BarGroup.
+	This stores the handle of the task being edited in the TaskStore of BarGroup. 
+	A valid handle will be provided by requests from this->main_window, which is provided by BarGroup.
+	The task file may be reloaded while the window is shown, so the task is looked up by the handle rather than by its ID, which may be of another task by then.
 	*/
-	int modifying_item_index;
+	TaskStore::TaskHandle modifying_task;
 	
 	enum class Mode{
 		UnInit, CreateNewTask, EditTask
@@ -0,0 +1,70 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef autosave_hpp
+#define autosave_hpp
+
+#include <chrono>
+#include <optional>
+
+/**
+\file autosave.hpp
+Provides the schedule of autosaving, which decides when the edits made to the tasks are written without the user pressing save.
+
+Edits made in a burst, such as dragging and merging a few groups then renaming them, are written together once no edit is made for a quiet period.
+Saves are also written at most once per interval, so a steady stream of edits does not write the task file on every pause.
+The schedule only keeps time; MainWindow runs it with Fl::add_timeout() and writes the saves with BackgroundSaver.
+*/
+namespace autosave{
+	using Clock = std::chrono::steady_clock;
+	
+	struct Policy{
+		///The time without edits before the edits are saved.
+		Clock::duration quiet_period;
+		///The least time between two saves.
+		Clock::duration min_interval;
+	};
+	
+	constexpr Policy default_policy = {std::chrono::seconds(2), std::chrono::seconds(10)};
+	
+	/**
+	Keeps the time of the last edit and the last save, and returns when the edits waiting to be saved are due.
+	Recording an edit is a comparison and an assignment, so it is called on every edit.
+	*/
+	class Scheduler{
+		public:
+		explicit Scheduler(const Policy& policy = default_policy) noexcept;
+		
+		///Records an edit made at the time, and returns when the edits waiting to be saved are due.
+		Clock::time_point record_edit(const Clock::time_point time) noexcept;
+		///Records a save written at the time, which saves every edit recorded before it.
+		void record_save(const Clock::time_point time) noexcept;
+		
+		///Returns true if an edit was recorded after the last save.
+		bool save_pending() const noexcept {return this->last_edit.has_value();}
+		///Returns when the edits waiting to be saved are due: a quiet period after the last edit, and at least the interval after the last save.
+		///Only valid if save_pending().
+		Clock::time_point due_time() const noexcept;
+		///Returns true if an edit is waiting to be saved and it is due at the time.
+		bool save_due(const Clock::time_point time) const noexcept;
+		
+		const Policy& policy() const noexcept {return this->_policy;}
+		
+		private:
+		Policy _policy;
+		std::optional<Clock::time_point> last_edit;
+		std::optional<Clock::time_point> last_save;
+	};
+}
+
+#endif
@@ -0,0 +1,98 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef background_saver_hpp
+#define background_saver_hpp
+
+#include "task_snapshot.hpp"
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <optional>
+#include <functional>
+#include <stop_token>
+#include <condition_variable>
+
+/**
+\file background_saver.hpp
+Provides BackgroundSaver, which writes saves on a worker thread so the window does not freeze while the task file is being written.
+*/
+
+/**
+Runs save jobs on a worker thread, one at a time in the order they were submitted.
+
+The job owns a copy of everything it writes, taken on the thread submitting it, so the worker never touches the widgets.
+Once a job finishes, its result is stored and the notify function is called from the worker thread; 
+the results are then taken with take_results() from the thread submitting the jobs (the FLTK event thread, woken by Fl::awake() in the notify function).
+
+A failed job cancels the jobs queued after it, as they build on what it should have written, such as the batches of the journal.
+
+The jobs left in the queue are still run when the object is destroyed, so a save submitted right before closing the program is not lost.
+*/
+class BackgroundSaver{
+	public:
+	///Returns the stamp of the task file it wrote, or std::nullopt if it did not write the task file, such as when appending to its journal.
+	using Job = std::function<std::optional<task_snapshot::SourceStamp>()>;
+	
+	struct Result{
+		enum class Status{
+			Saved, 
+			///The job threw, the message of the exception is in Result::error_message.
+			Failed, 
+			///The job was not run, as a job before it failed.
+			Cancelled
+		};
+		
+		Status status;
+		std::string error_message;
+		///The stamp returned by the job once Status::Saved, so only the task file written by the job is acknowledged as written by WorkTable.
+		std::optional<task_snapshot::SourceStamp> written_stamp;
+	};
+	
+	///Starts the worker thread. notify is called with notify_data from the worker thread after every job, it may be nullptr.
+	///May throw std::system_error if the thread could not be started.
+	explicit BackgroundSaver(void(*notify)(void*) = nullptr, void* const notify_data = nullptr);
+	
+	BackgroundSaver(const BackgroundSaver&) = delete;
+	BackgroundSaver& operator=(const BackgroundSaver&) = delete;
+	
+	///Queues the job to be run after the jobs submitted before it.
+	void submit(Job job);
+	///Returns the results of the finished jobs since the last call, in the order they were submitted.
+	std::vector<Result> take_results();
+	///Returns true if a job is queued or running.
+	bool busy() const;
+	///Blocks until every submitted job has finished, such as before reading the task file.
+	void wait_until_idle();
+	
+	private:
+	void run(std::stop_token stop_token);
+	
+	void(*notify)(void*);
+	void* notify_data;
+	
+	mutable std::mutex mutex;
+	std::condition_variable_any job_submitted;
+	std::condition_variable_any idle;
+	std::deque<Job> jobs;
+	std::vector<Result> results;
+	bool job_running;
+	
+	///Declared last, so the thread is stopped and joined before the members it uses are destroyed.
+	std::jthread worker;
+};
+
+#endif
@@ -0,0 +1,72 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef byte_scan_hpp
+#define byte_scan_hpp
+
+#include <string_view>
+
+/**
+\file byte_scan.hpp
+Provides scanning kernels for finding delimiters in a buffer of characters, used by task_io for separating lines and fields.
+
+There are 3 kernels: Scalar which compares a character at a time, SSE2 which compares 16 characters at a time and AVX2 which compares 32 at a time.
+The widest kernel supported by the CPU is chosen at runtime, and Scalar is used on CPUs other than x86.
+*/
+namespace byte_scan{
+	enum class Kernel{
+		Scalar, SSE2, AVX2
+	};
+
+	/**
+	A set of up to 4 characters to be searched for, such as the delimiters of the task file: '\\n', ',', '{' and '}'.
+	A set with fewer characters repeats them, as the kernels always compare against 4 characters.
+	*/
+	struct ScanSet{
+		char chars[4];
+
+		constexpr ScanSet(const char a) : chars{a, a, a, a} {}
+		constexpr ScanSet(const char a, const char b) : chars{a, b, a, b} {}
+		constexpr ScanSet(const char a, const char b, const char c) : chars{a, b, c, c} {}
+		constexpr ScanSet(const char a, const char b, const char c, const char d) : chars{a, b, c, d} {}
+
+		constexpr bool contains(const char c) const noexcept{
+			return (c == chars[0]) || (c == chars[1]) || (c == chars[2]) || (c == chars[3]);
+		}
+	};
+
+	///Returns true if the CPU is able to run the kernel.
+	bool kernel_supported(const Kernel kernel) noexcept;
+	///Returns the kernel used by find_first_of() without a kernel argument, which is the widest one supported by the CPU.
+	Kernel active_kernel() noexcept;
+	///Returns the name of the kernel, for displaying.
+	const char* kernel_name(const Kernel kernel) noexcept;
+
+	///Returns the pointer to the first character in [first, last) which is in the set, or last if there is none.
+	///This uses active_kernel().
+	const char* find_first_of(const char* first, const char* const last, const ScanSet& set) noexcept;
+	///Returns the pointer to the first character in [first, last) which is in the set, or last if there is none.
+	///The kernel must be supported by the CPU, this is meant for testing and benchmarking the kernels against each other.
+	const char* find_first_of(const Kernel kernel, const char* first, const char* const last, const ScanSet& set) noexcept;
+
+	///The equivalent of std::string_view::find_first_of() using find_first_of(), returns the index of the first character from pos which is in the set,
+	///or std::string_view::npos if there is none.
+	inline std::string_view::size_type find(const std::string_view str, const ScanSet& set, const std::string_view::size_type pos = 0) noexcept{
+		if(pos >= str.size()) return std::string_view::npos;
+
+		const char* const last = str.data() + str.size();
+		const char* const found = find_first_of(str.data() + pos, last, set);
+		return (found == last) ? std::string_view::npos : std::string_view::size_type(found - str.data());
+	}
+}
+
+#endif
@@ -0,0 +1,75 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef file_watch_hpp
+#define file_watch_hpp
+
+#include "task_snapshot.hpp"
+
+#include <string>
+#include <optional>
+
+/**
+\file file_watch.hpp
+Provides FileWatcher, which tells when a file was changed by another program, such as a script editing the task file while WorkTable is open.
+*/
+
+/**
+Watches a file for changes with inotify on Linux, or by polling its size and last write time elsewhere.
+
+The directory of the file is watched rather than the file itself, so the file is still watched after being replaced by renaming another file over it,
+as editors and scripts often save files.
+A change only counts if the size or last write time of the file differs from when it was last acknowledged, 
+so writing the file from WorkTable itself is not reported once acknowledge_write() is called with the stamp of what it wrote.
+*/
+class FileWatcher{
+	public:
+	///The seconds between checking the file with FileWatcher::changed(), when FileWatcher::fd() is -1.
+	static constexpr double poll_interval = 1.0;
+	
+	///Starts watching the file, with the current version of the file acknowledged.
+	///Falls back to polling if inotify is not available, this does not throw.
+	FileWatcher(const std::string& filename);
+	~FileWatcher() noexcept;
+	
+	FileWatcher(const FileWatcher&) = delete;
+	FileWatcher& operator=(const FileWatcher&) = delete;
+	
+	///Returns the file descriptor which is readable once the file may have changed, for Fl::add_fd().
+	///Returns -1 if the file is polled instead, FileWatcher::changed() should then be called every FileWatcher::poll_interval seconds.
+	int fd() const noexcept {return this->inotify_fd;}
+	///Returns true if the file was changed since it was last acknowledged, and acknowledges the change.
+	///Reads the pending events of FileWatcher::fd() as well, so it stops being readable.
+	///A missing file does not count as a change until it is written again.
+	bool changed() noexcept;
+	///Acknowledges the current version of the file, such as after loading it again.
+	void acknowledge_change() noexcept;
+	///Acknowledges the version of the file written by WorkTable, from the stamp taken once it was written.
+	///A change made by another program since is still reported by FileWatcher::changed(), even though the pending events are read here.
+	void acknowledge_write(const task_snapshot::SourceStamp& written_stamp) noexcept;
+	///Reads the pending events of FileWatcher::fd() without checking the file, such as while WorkTable is writing it, so FileWatcher::fd() stops being readable.
+	///The file is still checked by the next call of FileWatcher::changed(), even without new events.
+	void defer_change() noexcept;
+	
+	private:
+	///Reads every pending event, returns true if one of them is for the watched file.
+	bool read_events() noexcept;
+	
+	std::string filename;
+	std::optional<task_snapshot::SourceStamp> acknowledged_stamp;
+	int inotify_fd;
+	///True if events for the file were read without checking the file, by FileWatcher::acknowledge_write() or FileWatcher::defer_change().
+	bool unchecked_events;
+};
+
+#endif
@@ -0,0 +1,78 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef mapped_file_hpp
+#define mapped_file_hpp
+
+#include <memory>
+#include <string>
+#include <cstddef>
+#include <string_view>
+
+/**
+\file mapped_file.hpp
+Provides MappedFile, a read-only view of an entire file mapped into memory.
+*/
+
+///The least size of a file mapped by MappedFile, a smaller file is read into memory instead, as copying it costs less than mapping it.
+constexpr std::size_t min_mapped_size = 256 * 1024;
+
+/**
+A read-only memory mapping of an entire file. The contents are accessed directly from the mapped pages,
+so nothing is copied when reading the file; the OS pages the file in as it is being read.
+A file smaller than min_mapped_size is read into a buffer of the object instead.
+
+The mapping is released when the object is destroyed, so any std::string_view obtained from MappedFile::view()
+must not outlive the object, and the object should only be kept for as long as the contents are read.
+An empty file is valid and results in an empty view, as empty files cannot be mapped.
+
+On POSIX systems, reading the pages of a mapped file cut short by another process since it was mapped raises SIGBUS,
+which ends the program, so a file which may be truncated while it is read must be smaller than min_mapped_size.
+On Windows, other processes may write, rename and delete the file while it is mapped, and the pages mapped stay readable.
+*/
+class MappedFile{
+	public:
+	///Constructs an empty mapping, which maps no file.
+	MappedFile() noexcept : _data(nullptr), _size(0) {}
+	///Maps the entire file of filename.
+	///May throw std::runtime_error if the file could not be opened, or std::ios_base::failure if the file could not be mapped.
+	MappedFile(const std::string& filename);
+	~MappedFile() noexcept;
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	///Returns the first character of the mapped file, or nullptr if the file is empty. The characters are not null terminated.
+	const char* data() const noexcept {return this->_data;}
+	///Returns the character count of the file.
+	std::size_t size() const noexcept {return this->_size;}
+	///Returns the entire contents of the file.
+	std::string_view view() const noexcept {return std::string_view(this->_data, this->_size);}
+	///Returns true if the file is mapped, or false if it is read into memory or empty.
+	bool is_mapped() const noexcept {return this->_data != nullptr && !this->read_buffer;}
+
+	private:
+	///Reads the characters of the file into read_buffer, up to size. The view is cut short if the file is cut short while it is read.
+	template<typename ReadFunction>
+	void read(const std::size_t size, ReadFunction&& read_some);
+	///Unmaps the file if one is mapped and resets the object to an empty mapping.
+	void unmap() noexcept;
+
+	const char* _data;
+	std::size_t _size;
+	///The contents of a file smaller than min_mapped_size, which _data points to.
+	std::unique_ptr<char[]> read_buffer;
+};
+
+#endif
@@ -0,0 +1,81 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef name_pool_hpp
+#define name_pool_hpp
+
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+/**
+\file name_pool.hpp
+Provides the interned string pool holding the names of every Task, so a Task only stores a 4 byte reference to its name.
+
+Each distinct name is stored once while a name_pool::Name refers to it, and released from the pool once the last one is destroyed,
+so renaming tasks or replacing the loaded tasks does not keep the old names.
+Interning locks the pool, and so does releasing a name once its last Name is destroyed.
+Copying or destroying any other Name only counts the reference atomically, and reading an interned name never locks nor allocates.
+*/
+namespace name_pool{
+	///Refers to an interned name. Two handles of names still interned are equal if and only if their names are equal.
+	using Handle = std::uint32_t;
+	
+	///The handle of the empty name, which is always interned.
+	inline constexpr Handle empty_name = 0;
+	
+	/**
+	A counted reference to an interned name, which keeps the name in the pool until every Name referring to it is destroyed or assigned another name.
+	Copying a Name counts the reference atomically without locking, so a Name can be copied and destroyed on any thread.
+	*/
+	class Name{
+		public:
+		///The empty name, which is never released.
+		Name() noexcept : _handle(empty_name) {}
+		Name(const Name& other) noexcept;
+		Name(Name&& other) noexcept;
+		Name& operator=(const Name& other) noexcept;
+		Name& operator=(Name&& other) noexcept;
+		~Name() noexcept;
+		
+		Handle handle() const noexcept {return this->_handle;}
+		///Returns the characters of the name, which are null terminated and stay valid while this Name refers to them.
+		std::string_view view() const noexcept;
+		
+		private:
+		///Takes over a reference already counted for handle.
+		explicit Name(const Handle handle) noexcept : _handle(handle) {}
+		friend Name intern(const std::string_view name);
+		
+		Handle _handle;
+	};
+	
+	inline bool operator==(const Name& lhs, const Name& rhs) noexcept{
+		return lhs.handle() == rhs.handle();
+	}
+	inline bool operator!=(const Name& lhs, const Name& rhs) noexcept{
+		return !(lhs == rhs);
+	}
+	
+	///Returns a reference to name, storing a copy of name in the pool if it is not interned already.
+	///May throw std::bad_alloc, or std::length_error if the pool is out of handles.
+	Name intern(const std::string_view name);
+	
+	///Returns the name of the handle. The characters are null terminated and stay valid while a Name refers to them.
+	///The handle must be of a Name which is not destroyed yet.
+	std::string_view view(const Handle handle) noexcept;
+	
+	///Returns the count of distinct names interned and not released yet, including the empty name.
+	std::size_t name_count();
+}
+
+#endif
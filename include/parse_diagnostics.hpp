@@ -0,0 +1,84 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef parse_diagnostics_hpp
+#define parse_diagnostics_hpp
+
+#include <limits>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <string_view>
+
+/**
+\file parse_diagnostics.hpp
+Provides the collector of the errors found while parsing the task file,
+so a damaged task file is loaded at full speed and its errors are shown once afterwards, rather than in a window for each line.
+*/
+namespace parse_diagnostics{
+	enum class Kind{
+		///A task line with a due date which is not a valid date. The task is skipped.
+		InvalidDueDate,
+		///A group definition inside of a group. Its tasks are fetched to the former group.
+		NestedGroup
+	};
+	
+	///The position of an error found without the lines it was in, such as by task_io_internal::TaskStrGroups_to_TaskGroups().
+	constexpr std::size_t unknown_position = std::numeric_limits<std::size_t>::max();
+	
+	struct Diagnostic{
+		Kind kind;
+		///The line of the error counted from 1, or unknown_position.
+		std::size_t line_number;
+		///The offset of the first character of the line from the start of the task file, or unknown_position.
+		std::size_t byte_offset;
+		///The line of the error.
+		std::string text;
+	};
+	
+	///Returns the name of the kind, for displaying.
+	const char* kind_name(const Kind kind) noexcept;
+	
+	/**
+	Records the errors of parsing, which are read with diagnostics() afterwards or summarised with summary().
+	
+	Only the first max_kept errors are kept with their text, the ones after them are only counted,
+	so a task file with an error on every line costs no more to parse than one without.
+	It is not thread safe, the parsers record to it from the thread fetching the lines in order.
+	*/
+	class Collector{
+		public:
+		static constexpr std::size_t default_max_kept = 1000;
+		
+		Collector(const std::size_t max_kept = default_max_kept) noexcept;
+		
+		void record(const Kind kind, const std::size_t line_number, const std::size_t byte_offset, const std::string_view text);
+		///Returns the errors kept, in the order they were recorded.
+		const std::vector<Diagnostic>& diagnostics() const noexcept {return this->kept_diagnostics;}
+		///Returns the count of every error recorded, including the ones not kept.
+		std::size_t count() const noexcept {return this->invalid_due_date_count + this->nested_group_count;}
+		std::size_t count(const Kind kind) const noexcept;
+		bool empty() const noexcept {return this->count() == 0;}
+		void clear() noexcept;
+		
+		private:
+		std::vector<Diagnostic> kept_diagnostics;
+		std::size_t max_kept;
+		std::size_t invalid_due_date_count;
+		std::size_t nested_group_count;
+	};
+	
+	///Returns the text of the window summarising the errors: the count of each kind, then the first max_listed errors, one in each line.
+	std::string summary(const Collector& collector, const std::size_t max_listed = 20);
+}
+
+#endif
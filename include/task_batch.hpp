@@ -0,0 +1,114 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef task_batch_hpp
+#define task_batch_hpp
+
+#include "Task.hpp"
+#include "parse_diagnostics.hpp"
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+#include <unordered_map>
+
+/**
+\file task_batch.hpp
+Provides the commands of the command-line interface, which query and edit the groups of a task file loaded once,
+so a batch of any size is applied in memory and the task file is written once afterwards.
+
+The commands are:
+- list [--due-within <N>d|<N>w] [--group <group name>]: lists the tasks due within N days or weeks from today, including the overdue ones, 
+  or every task without --due-within. A task is a line of its due date, group name and name separated by tabs, sorted by due date.
+- add [--group <group name>] <yyyy/m/d> <task name>: adds the task as a single task, or to the first group of the name, which is added if there is none.
+- import [--format tasks|csv|jsonl] <filename>: adds every group of the file, which is a task file, CSV or JSON Lines as in task_exchange.hpp.
+  The format is the one of the extension of the filename without --format.
+- export [--format tasks|csv|jsonl] <filename>|-: writes every group to the file, or appends them to the output for -, which is a task file without --format.
+- group [--from <group name>] <group name> <task name>: moves the first task of the name to the first group of the group name, which is added if there is none.
+  The task is searched in the group of --from only if provided. A group left without tasks is removed.
+  The task and group are found through the indices of the names of the tasks and groups, so a batch of moves does not search every group for each move.
+
+As in the task file, a group with a single task is saved as the task only, without its group name.
+*/
+namespace task_batch{
+	/**
+	Splits a command line into its arguments, which are separated by spaces or tabs.
+	An argument in double quotes may have spaces, and a double quote or backslash in it is escaped with a backslash.
+	
+	Throws std::invalid_argument if a double quote is not closed.
+	*/
+	std::vector<std::string> split_arguments(const std::string_view line);
+	
+	///Applies the commands to the groups of a task file. See task_batch.hpp for the commands.
+	class Batch{
+		public:
+		///The current date is the date the due dates of --due-within and the days remaining of the tasks added are counted from.
+		///The errors of the task files imported are recorded to diagnostics if provided, or reported as in TaskFileParser.
+		Batch(std::vector<TaskGroup>&& taskgroups, const std::chrono::year_month_day& current_date, parse_diagnostics::Collector* const diagnostics = nullptr);
+		
+		/**
+		Runs the command of the arguments, the first argument being the command. The output of list and export to - is appended to output.
+		
+		Throws std::invalid_argument with a message for the user if the command or its arguments are invalid, the groups are left as is then.
+		May throw std::runtime_error or std::ios_base::failure if the file of import or export could not be read or written.
+		*/
+		void run(const std::vector<std::string>& arguments, std::string& output);
+		
+		///Returns true if a command changed the groups, which then need to be written.
+		bool modified() const noexcept {return this->_modified;}
+		///Returns the groups, erasing the groups left without tasks by group first.
+		const std::vector<TaskGroup>& taskgroups();
+		
+		private:
+		void list(const std::vector<std::string>& arguments, std::string& output) const;
+		void add(const std::vector<std::string>& arguments);
+		void import_taskfile(const std::vector<std::string>& arguments);
+		void export_taskfile(const std::vector<std::string>& arguments, std::string& output);
+		void group(const std::vector<std::string>& arguments);
+		
+		///Returns the index of the first group of the name, adding the group if there is none.
+		std::size_t find_or_add_group(const std::string& group_name);
+		///Removes the group from the index of its name, the group is kept in place until drop_removed_groups().
+		void remove_group(const std::size_t group_index);
+		///Erases the groups removed by remove_group(), then indexes the names again for the indices of the groups left.
+		void drop_removed_groups();
+		///Maps the name of every group with a name to the indices of the groups of the name.
+		void index_group_names();
+		///Maps the name of every task to the indices of the groups with a task of the name.
+		void index_task_names();
+		///Adds the group of a task of the name to task_group_indices, if the task names are indexed.
+		void index_task(const std::string& task_name, const std::size_t group_index);
+		///Removes the group of a task of the name from task_group_indices.
+		void unindex_task(const std::string& task_name, const std::size_t group_index);
+		
+		std::vector<TaskGroup> _taskgroups;
+		///The indices of the groups of each name in ascending order, for adding to the first group of a name without searching every group.
+		std::unordered_map<std::string, std::vector<std::size_t>> group_indices;
+		///The index of the group of every task of each name in ascending order, repeated for each task of the name in the group.
+		///Only indexed by the first group command, as the other commands do not search for a task.
+		std::unordered_map<std::string, std::vector<std::size_t>> task_group_indices;
+		bool task_names_indexed;
+		/**
+		The groups left without tasks by group. They stay in _taskgroups without tasks until drop_removed_groups(),
+		as erasing a group would change the index of every group after it, in both indices.
+		*/
+		std::vector<std::size_t> removed_groups;
+		std::chrono::year_month_day current_date;
+		parse_diagnostics::Collector* diagnostics;
+		bool _modified;
+	};
+}
+
+#endif
@@ -0,0 +1,53 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef task_diff_hpp
+#define task_diff_hpp
+
+#include "Task.hpp"
+
+#include <vector>
+#include <cstddef>
+
+/**
+\file task_diff.hpp
+Provides the differences between two lists of groups, so a task file reloaded after being edited elsewhere only changes the bars of the edited groups.
+*/
+namespace task_diff{
+	struct Change{
+		enum class Type{
+			///The group at Change::index is replaced by the new group at Change::new_index.
+			Update,
+			///The new group at Change::new_index is inserted at Change::index.
+			Insert,
+			///The group at Change::index is removed.
+			Remove
+		};
+		
+		Type type;
+		///The index in the old list, with the changes before this one applied.
+		std::size_t index;
+		///The index in the new list, unused by Type::Remove.
+		std::size_t new_index;
+	};
+	
+	/**
+	Returns the changes which turn the old groups into the new groups when applied in order.
+	
+	The groups equal at the start and the end of both lists are left as is, and the ones left between them are updated in pairs, 
+	then removed or inserted for the difference in count. So an edit made in one place of the list, as a script usually makes, changes only the groups it touched.
+	*/
+	std::vector<Change> diff(const std::vector<TaskGroup>& old_taskgroups, const std::vector<TaskGroup>& new_taskgroups);
+}
+
+#endif
@@ -0,0 +1,159 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef task_exchange_hpp
+#define task_exchange_hpp
+
+#include "Task.hpp"
+#include "parse_diagnostics.hpp"
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <istream>
+#include <optional>
+#include <functional>
+#include <string_view>
+
+/**
+\file task_exchange.hpp
+Provides the import and export of groups as CSV and JSON Lines, for exchanging task lists with other tools.
+
+Both formats have a record for each task with the fields group_id, group, due_date and name:
+- CSV has a header of the field names, then a row for each task, quoted as in RFC 4180.
+- JSON Lines has an object for each task on its own line, such as {"group_id":0,"group":"chores","due_date":"2025/1/3","name":"dishes"}.
+
+The consecutive tasks of the same group_id are the tasks of a group, so a group round-trips even if it has a single task or shares its name with another group.
+Without group_id, the consecutive tasks of the same group name are a group, and a task without a group name is a single task.
+The fields other than these are ignored, and a due date may also be written as yyyy-mm-dd.
+
+The groups are read and written one at a time, so the memory used stays the same regardless of the size of the input:
+the names of the tasks are released from name_pool once the group holding them is dropped, along with the text chunks holding only released names.
+*/
+namespace task_exchange{
+	enum class Format{
+		TaskFile, Csv, JsonLines
+	};
+	
+	///Returns the format of the name, which is tasks, csv or jsonl, or std::nullopt for any other.
+	std::optional<Format> format_from_name(const std::string_view name) noexcept;
+	///Returns the format of the extension of the filename, which is .csv, or .jsonl and .ndjson, or Format::TaskFile for any other.
+	Format format_of_filename(const std::string_view filename) noexcept;
+	
+	/**
+	A parser of CSV or JSON Lines, which is fed the characters in chunks of any size, and calls the callback with each group once its last task is read.
+	It parses the records as TaskFileParser parses the lines, and only the unfinished record at the end of a chunk is copied.
+	
+	A task with an invalid due date is skipped and recorded to diagnostics, or displayed with task_io_report::alert() without diagnostics.
+	feed() and finish() throw std::invalid_argument for a record which is not valid CSV or JSON, or misses the due_date or name, with the line of the record.
+	*/
+	class Reader{
+		public:
+		Reader(const Format format, std::function<void(TaskGroup&&)> taskgroup_callback, parse_diagnostics::Collector* const diagnostics = nullptr);
+		
+		///Parses every complete record in the characters, the characters after the last record are kept until the next feed() or finish().
+		void feed(const char* const data, const std::size_t size);
+		///Parses the remaining record and calls the callback with the last group.
+		void finish();
+		
+		private:
+		///The fields of a record, which view either the record itself or this->unescaped_fields.
+		struct Record{
+			std::optional<std::string_view> group_id;
+			std::string_view group_name;
+			std::optional<std::string_view> due_date;
+			std::optional<std::string_view> name;
+		};
+		
+		///Parses a record which may be empty, the line of the record is this->record_line_number.
+		void parse_record(std::string_view record, const std::size_t offset);
+		Record parse_csv_record(const std::string_view record);
+		Record parse_json_record(const std::string_view record);
+		///Splits the CSV record into this->unescaped_fields, returning the count of the fields.
+		std::size_t split_csv_fields(const std::string_view record);
+		///Reads the header of the CSV, which maps the columns to the fields.
+		void parse_csv_header(const std::string_view record);
+		///Adds the task of the record to the group being read, or to a new group after passing the one being read to the callback.
+		void fetch_record(const Record& record, const std::string_view record_text, const std::size_t offset);
+		///Passes the group being read to the callback if it has tasks.
+		void save_fetching_taskgroup();
+		///Throws std::invalid_argument with the message and the line of the record.
+		[[noreturn]] void throw_invalid_record(const std::string& message) const;
+		
+		Format format;
+		std::function<void(TaskGroup&&)> taskgroup_callback;
+		parse_diagnostics::Collector* diagnostics;
+		std::chrono::year_month_day current_date;
+		
+		///The columns of group_id, group, due_date and name in the CSV, set by its header.
+		std::optional<std::size_t> group_id_column, group_column, due_date_column, name_column;
+		bool header_read;
+		
+		TaskGroup fetching_taskgroup;
+		std::string fetching_group_id;
+		bool fetching;
+		///Whether the group being read is identified by group_id rather than its name.
+		bool fetching_by_group_id;
+		
+		///The unfinished record, which may span lines in CSV as a quoted field may have newlines.
+		std::string unfinished_record;
+		bool record_unfinished;
+		///The count of double quotes in this->unfinished_record, the record continues to the next line while it is odd.
+		std::size_t unfinished_quote_count;
+		std::size_t record_offset;
+		std::size_t record_line_number;
+		std::size_t fed_size;
+		std::size_t line_number;
+		
+		///The fields of the record being parsed, kept for reusing their allocations.
+		std::vector<std::string> unescaped_fields;
+	};
+	
+	/**
+	Writes groups as CSV or JSON Lines to a stream, one group at a time.
+	The records are written to a buffer flushed to the stream once it is large enough, so the memory used does not grow with the groups written.
+	
+	write() and flush() throw std::ios_base::failure if the stream could not be written.
+	*/
+	class Writer{
+		public:
+		///Writes the header for CSV. format must not be Format::TaskFile, use taskgroups_to_str() for task files.
+		Writer(std::ostream& stream, const Format format);
+		///Flushes the buffer, but does not throw, call flush() before for its errors.
+		~Writer() noexcept;
+		
+		Writer(const Writer&) = delete;
+		Writer& operator=(const Writer&) = delete;
+		
+		void write(const TaskGroup& taskgroup);
+		void flush();
+		
+		private:
+		std::ostream& stream;
+		Format format;
+		std::size_t group_id;
+		std::string buffer;
+	};
+	
+	///Reads every group of the stream with Reader, calling the callback with each group. See Reader for the exceptions.
+	///May also throw std::ios_base::failure if the stream lost its integrity while reading.
+	void read(std::istream& stream, const Format format, std::function<void(TaskGroup&&)> taskgroup_callback, parse_diagnostics::Collector* const diagnostics = nullptr);
+	///Returns every group of the stream read with Reader.
+	std::vector<TaskGroup> read(std::istream& stream, const Format format, parse_diagnostics::Collector* const diagnostics = nullptr);
+	///Writes the groups to the stream with Writer.
+	void write(std::ostream& stream, const Format format, const std::vector<TaskGroup>& taskgroups);
+}
+
+#endif
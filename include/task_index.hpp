@@ -0,0 +1,102 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef task_index_hpp
+#define task_index_hpp
+
+#include "Task.hpp"
+#include "task_journal.hpp"
+#include "parse_diagnostics.hpp"
+
+#include <limits>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+/**
+\file task_index.hpp
+Provides the due date index of the task file, for loading only the groups which are visible in the current timescale.
+
+The index is the span of characters of every group in the task file and the nearest due date of its tasks, found without constructing any task.
+A group is loaded by parsing its span once it is needed, such as when the timescale is widened to include its nearest due date.
+*/
+namespace task_index{
+	///A task file smaller than this is loaded entirely, as indexing it saves less than it costs.
+	constexpr std::uint64_t lazy_load_min_size = 256 * 1024;
+	///The nearest due date of a group without a task of a valid due date, which is always loaded as it cannot be placed in any timescale.
+	constexpr std::int32_t no_due_date = std::numeric_limits<std::int32_t>::min();
+
+	///The characters of a group in the task file, which parse to the group by themselves.
+	struct Span{
+		std::size_t offset;
+		std::size_t size;
+		///The nearest due date of the tasks of the group, as the day count of std::chrono::sys_days, or no_due_date.
+		std::int32_t nearest_due_date;
+		///The line of the first character of the span counted from 0, for the positions of the errors recorded while loading the group.
+		std::size_t line_number = 0;
+	};
+
+	/**
+	Returns the span of every group of the task file, in the same order as the groups parsed by TaskFileParser.
+	The lines are only classified with task_io_internal::scan_line(), so nothing is allocated for the tasks.
+
+	A group without tasks lends its name to the group after it when parsed, so it is part of the span of the group after it.
+	The windows of the nested groups and invalid due dates are displayed once the group is loaded instead.
+	Throws std::out_of_range from a task line without the comma and space after its due date, as TaskFileParser does.
+	*/
+	std::vector<Span> build(const std::string_view task_file);
+	///Returns true if the group of the span has a task due on or before the date, or has no valid due date.
+	inline bool due_by(const Span& span, const std::chrono::sys_days& date) noexcept{
+		return (span.nearest_due_date == no_due_date) || (span.nearest_due_date <= date.time_since_epoch().count());
+	}
+	///Parses the group of the span with TaskFileParser.
+	TaskGroup load(const std::string_view task_file, const Span& span,
+					void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&),
+					parse_diagnostics::Collector* const diagnostics = nullptr);
+
+	///A group of the task file, which is either loaded, or only indexed by its span.
+	struct LazyTaskGroup{
+		std::optional<TaskGroup> taskgroup;
+		Span span;
+	};
+
+	///The task file with its groups loaded lazily. The text is kept for loading the groups, as the task file itself is rewritten by saving.
+	struct LazyTaskFile{
+		std::string text;
+		std::vector<LazyTaskGroup> taskgroups;
+	};
+
+	///Indexes the text of the task file with build(), without loading any group.
+	LazyTaskFile index(std::string&& task_file);
+	///Applies the journal operation as task_journal::apply(), loading the group it renames.
+	///Returns false and leaves the groups as is if the index of the operation is out of range.
+	bool apply(LazyTaskFile& task_file, const task_journal::Operation& operation,
+				void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&),
+				parse_diagnostics::Collector* const diagnostics = nullptr);
+	///Normalizes the loaded groups as in task_journal::as_loaded_from_task_file(), before and after the journal is replayed over the groups.
+	///A group which is not loaded is left as is, unless it is after a group without tasks and is loaded for the name lent to it,
+	///or it has no valid due date and is loaded as it may be without tasks.
+	void as_loaded_from_task_file(LazyTaskFile& task_file,
+								void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&),
+								parse_diagnostics::Collector* const diagnostics = nullptr);
+	///Returns every group of the task file, loading the ones which are not loaded.
+	std::vector<TaskGroup> to_taskgroups(const LazyTaskFile& task_file,
+										void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&),
+										parse_diagnostics::Collector* const diagnostics = nullptr);
+}
+
+#endif
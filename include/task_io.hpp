@@ -14,21 +14,50 @@ You should have received a copy of the GNU General Public License along with Wor
 #define taskio_hpp
 
 #include "Task.hpp"
+#include "task_index.hpp"
+#include "task_journal.hpp"
+#include "parse_diagnostics.hpp"
 
 #include <memory>
 #include <vector>
 #include <string>
 #include <chrono>
 #include <utility>
+#include <cstddef>
 #include <fstream>
+#include <istream>
 #include <stdexcept>
+#include <string_view>
 
 /**
 \file task_io.hpp
 A module for reading and writing to task file;
 as well as utilities for converting types related to Task to std::string equivalent.
+
+task_io does not depend on FLTK, so it can be linked by the tools and benchmarks without a display.
+The windows it displays are through the functions of task_io_report, which main() sets to FLTK's.
 */
 
+/**
+The functions task_io displays its errors with, and asks the user with when a save fails.
+
+Without setting them, the errors are written to std::cerr and a failed save is not retried.
+The functions may be called from any thread which calls task_io, so the ones set must be safe to call from those threads.
+*/
+namespace task_io_report{
+	using AlertFunction = void(*)(const char* message);
+	///Returns true if the save which failed is to be tried again.
+	using RetryFunction = bool(*)(const char* question);
+	
+	void set_alert_function(const AlertFunction alert_function) noexcept;
+	void set_retry_function(const RetryFunction retry_function) noexcept;
+	
+	///Displays the error or warning with the alert function set, the equivalent of fl_alert().
+	void alert(const char* const message);
+	///Asks the question with the retry function set, returns true if the user chose to try again.
+	bool ask_retry(const char* const question);
+}
+
 ///\todo might just make it task_io and put everything in, or remove this entirely in 0.6
 namespace task_io_internal{
 	/**
@@ -69,6 +98,42 @@ namespace task_io_internal{
 		return !(lhs == rhs);
 	}
 
+	/**
+	A non-owning variant of TaskStr, viewing the characters of a line in the task file.
+	The viewed buffer (usually a MappedFile) must outlive the object.
+	*/
+	struct TaskStrView{
+		std::string_view due_date;
+		std::string_view name;
+	};
+
+	///Returns true if TaskStrView::due_date and TaskStrView::name of both are the same.
+	inline bool operator==(const TaskStrView& lhs, const TaskStrView& rhs){
+		return (lhs.due_date == rhs.due_date) && (lhs.name == rhs.name);
+	}
+	///Returns true if TaskStrView::due_date or TaskStrView::name of both are not the same.
+	inline bool operator!=(const TaskStrView& lhs, const TaskStrView& rhs){
+		return !(lhs == rhs);
+	}
+
+	/**
+	A non-owning variant of TaskStrGroup, viewing the characters of the task file.
+	The viewed buffer (usually a MappedFile) must outlive the object.
+	*/
+	struct TaskStrViewGroup{
+		std::string_view group_name;
+		std::vector<TaskStrView> taskstrs;
+	};
+
+	///Returns true if TaskStrViewGroup::group_name and TaskStrViewGroup::taskstrs of both are the same.
+	inline bool operator==(const TaskStrViewGroup& lhs, const TaskStrViewGroup& rhs){
+		return (lhs.group_name == rhs.group_name) && (lhs.taskstrs == rhs.taskstrs);
+	}
+	///Returns true if TaskStrViewGroup::group_name or TaskStrViewGroup::taskstrs of both are not the same.
+	inline bool operator!=(const TaskStrViewGroup& lhs, const TaskStrViewGroup& rhs){
+		return !(lhs == rhs);
+	}
+
 	
 	using file_buffer = std::pair<std::unique_ptr<char[]>, std::size_t>;
 	
@@ -77,13 +142,19 @@ namespace task_io_internal{
 	file_buffer get_raw_file(const std::string& filename);
 
 	///The error callback for buffer_to_separated_lines. This gets called and pops up a window if a nested group is detected.
+	///The parsers record the nested group to their parse_diagnostics::Collector instead if they are provided one.
 	///\todo make callsite_filename and callsite_line be a single std::string.
 	void default_nested_group_callback(const char* const callsite_filename, const int callsite_line, 
 										const std::string& first_taskgroup_name, const std::string& second_taskgroup_name);
 	
 	///Separates lines from the given buffer of characters. The newline character is the separator.
 	///The return vector does not contain any line which is empty.
+	///
+	///This copies every line, prefer buffer_to_line_views() if the buffer outlives the lines.
 	std::vector<std::string> buffer_to_separated_lines(const file_buffer& buffer);
+	///Separates lines from the given buffer of characters without copying them. The newline character is the separator.
+	///The return vector does not contain any line which is empty, and each line views the provided buffer.
+	std::vector<std::string_view> buffer_to_line_views(const std::string_view buffer);
 	
 	/**
 	Constructs a TaskStr from the provided line in "yyyy/(m)m/(d)d, task name" format.
@@ -95,6 +166,10 @@ namespace task_io_internal{
 	- A task without the space after the comma would lose the first character of the task name.	
 	*/
 	TaskStr line_to_TaskStr(const std::string& line);
+	///The non-copying variant of line_to_TaskStr(), the returned TaskStrView views the provided line.
+	///
+	///As with line_to_TaskStr(), a line without the comma and space after the due date throws std::out_of_range.
+	TaskStrView line_to_TaskStrView(const std::string_view line);
 	
 	/**
 	Parses raw lines to TaskStrGroup, its default callback will pop up a window if an instance of nested group is present in task file. 
@@ -109,43 +184,294 @@ namespace task_io_internal{
 	- If the code already was fetching for tasks of a group and the current line defines another group, the code simply warns the nesting of a group, and moves on to fetch tasks to the former group.
 	
 	We chose to display a window rather than throwing an exception, simply because it is a small error.
+	If diagnostics is provided, the nested group is recorded there instead, without its position as the empty lines are not counted here.
 	*/
 	std::vector<TaskStrGroup> lines_to_TaskStrGroup(const std::vector<std::string>& lines, 
-													void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&) = default_nested_group_callback);
+													void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&) = default_nested_group_callback,
+													parse_diagnostics::Collector* const diagnostics = nullptr);
+	///The non-copying variant of lines_to_TaskStrGroup(), the returned groups view the characters of the provided lines.
+	std::vector<TaskStrViewGroup> lines_to_TaskStrViewGroup(const std::vector<std::string_view>& lines, 
+															void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&) = default_nested_group_callback,
+															parse_diagnostics::Collector* const diagnostics = nullptr);
 	///Converts multiple TaskStrGroup to TaskGroup. 
 	///
+	///May display a window if the due date of a task is invalid, and will continue on. 
+	///If diagnostics is provided, the invalid due date is recorded there instead, without its position.
+	std::vector<TaskGroup> TaskStrGroups_to_TaskGroups(const std::vector<TaskStrGroup>& taskstr_groups, parse_diagnostics::Collector* const diagnostics = nullptr);
+	///Converts multiple TaskStrViewGroup to TaskGroup. This is where the names of tasks and groups are copied out of the viewed buffer.
+	///
 	///May display a window if the due date of a task is invalid, and will continue on.
-	std::vector<TaskGroup> TaskStrGroups_to_TaskGroups(const std::vector<TaskStrGroup>& taskstr_groups);
+	///If diagnostics is provided, the invalid due date is recorded there instead, without its position.
+	std::vector<TaskGroup> TaskStrViewGroups_to_TaskGroups(const std::vector<TaskStrViewGroup>& taskstr_groups, parse_diagnostics::Collector* const diagnostics = nullptr);
+	
+	/**
+	A line of the task file classified and parsed on its own, without the state of the lines before it.
+	This lets the lines be parsed on multiple threads, TaskFileParser then fetches them to groups in order.
+	
+	The errors of the line are kept instead of being displayed or thrown, so TaskFileParser can report them in order.
+	*/
+	struct ParsedLine{
+		enum class Type{
+			GroupDefinition, ScopeEnd, Task, InvalidTask, MissingComma
+		};
+		
+		Type type;
+		///The group name of Type::GroupDefinition, the task name of Type::Task, or the entire line of Type::InvalidTask and Type::MissingComma.
+		std::string_view text;
+		///The due date of Type::Task. The task is constructed once the line is fetched by TaskFileParser, 
+		///so the names are interned into name_pool on the thread fetching the lines rather than on each thread parsing them.
+		std::chrono::year_month_day due_date;
+		///The line counted from 0 and the offset of its first character, from the start of the characters parsed. For reporting the errors of the line.
+		std::size_t line_number = 0;
+		std::size_t offset = 0;
+	};
+	
+	///A line of the task file classified as in ParsedLine, without its position.
+	struct ScannedLine{
+		ParsedLine::Type type;
+		///The same as ParsedLine::text, and the task name of ParsedLine::Type::Task.
+		std::string_view text;
+		///The due date of ParsedLine::Type::Task.
+		std::chrono::year_month_day due_date;
+	};
+	
+	///Classifies a line which is not empty, the returned ScannedLine views the provided line.
+	///This allocates nothing, for finding the groups and due dates of a task file without loading its tasks.
+	ScannedLine scan_line(const std::string_view line) noexcept;
+	///Classifies and parses a line which is not empty with scan_line(), the returned ParsedLine views the provided line.
+	///This does not display a window, call any callback nor intern the task name, so it can be called from any thread without contending on a lock.
+	ParsedLine parse_line(const std::string_view line) noexcept;
+	///Parses every line which is not empty in the provided characters with parse_line(), with the positions of the lines from the start of the characters.
+	///Stops after a line of ParsedLine::Type::MissingComma, as the lines after it are not parsed by TaskFileParser either.
+	///line_count is set to the count of lines passed, including the empty ones, for the positions of the lines of the characters after these.
+	std::vector<ParsedLine> parse_lines(const std::string_view chars, std::size_t& line_count);
+	
+	///Splits the buffer into at most chunk_count chunks of roughly the same size. 
+	///Each chunk ends after a newline or at the end of the buffer, so no line is split between chunks.
+	std::vector<std::string_view> split_at_lines(const std::string_view buffer, const std::size_t chunk_count);
+	///Parses each chunk with parse_lines() on thread_count threads including the calling thread, then fetches the lines of every chunk in order with TaskFileParser.
+	///Each chunk must end at the end of a line, as from split_at_lines(), and the chunks must be consecutive for the positions of the errors recorded to diagnostics.
+	std::vector<TaskGroup> parse_chunks_parallel(const std::vector<std::string_view>& chunks, const unsigned thread_count,
+												void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&),
+												parse_diagnostics::Collector* const diagnostics = nullptr);
 }
 
+/**
+A single-pass parser which converts the characters of a task file straight to TaskGroup,
+without the intermediate lines and TaskStrGroup of the functions in task_io_internal.
+
+The characters can be fed in chunks of any size with feed(), a chunk may end in the middle of a line,
+so a file can be parsed while it is still being read. Only the unfinished line at the end of a chunk is copied.
+Once every chunk is fed, call finish() for the TaskGroups.
+
+It behaves exactly as task_io_internal::lines_to_TaskStrGroup() then task_io_internal::TaskStrGroups_to_TaskGroups():
+- The behaviours of task_io_internal::line_to_TaskStr(), including throwing std::out_of_range from a task line without the comma and space after its due date.
+- A group without its scope ending would have every task after the group definition to be in the group.
+- A nested group definition calls the nested group callback, and the tasks are fetched to the former group.
+- A task with an invalid due date displays a window and is skipped.
+- A group without its scope ending is dropped if its last line is not a task, without displaying the invalid due dates of its tasks,
+  so the invalid due dates of a group are only displayed once the group is saved.
+
+If the parser is provided a parse_diagnostics::Collector, the nested groups and invalid due dates are recorded there with their line and offset instead,
+without calling the callback or displaying any window.
+*/
+class TaskFileParser{
+	public:
+	TaskFileParser(void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&) = task_io_internal::default_nested_group_callback,
+					parse_diagnostics::Collector* const diagnostics = nullptr);
+	
+	///Sets the position of the next character fed, for parsing a part of a task file which does not start at its first line.
+	///The line is counted from 0. This must be called before feeding any character.
+	void start_at(const std::size_t offset, const std::size_t line_number) noexcept;
+	
+	///Parses every complete line in the provided characters. 
+	///The characters after the last newline are kept until the next feed() or finish() completes the line.
+	void feed(const char* const data, const std::size_t size);
+	///Parses the remaining unfinished line and returns every TaskGroup parsed. The parser can then be reused for another file.
+	std::vector<TaskGroup> finish();
+	
+	private:
+	///Parses a single line which is not empty with task_io_internal::parse_line(), then fetches it with fetch_line().
+	///The line is at this->line_number, and offset is of its first character.
+	void parse_line(const std::string_view line, const std::size_t offset);
+	///The state machine equivalent of the loop body of task_io_internal::lines_to_TaskStrGroup(), which fetches the parsed line to the groups.
+	///The errors kept in the parsed line are displayed or thrown here.
+	void fetch_line(task_io_internal::ParsedLine&& parsed_line);
+	///Moves this->fetching_taskgroup to this->taskgroups and clears the state of the group being fetched.
+	void save_fetching_taskgroup();
+	///Displays or records the invalid due dates of the group being fetched, then clears them.
+	void report_invalid_task_lines();
+	
+	///A task line with an invalid due date, kept until its group is saved.
+	struct InvalidTaskLine{
+		std::string line;
+		std::size_t line_number;
+		std::size_t offset;
+	};
+	
+	void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&);
+	parse_diagnostics::Collector* diagnostics;
+	
+	std::vector<TaskGroup> taskgroups;
+	///The group which tasks are being fetched to, which can either be a group or a single task.
+	TaskGroup fetching_taskgroup;
+	///The amount of task lines fetched to this->fetching_taskgroup, including the tasks with invalid due date which were not added.
+	std::size_t fetched_task_line_count;
+	bool fetching_group;
+	///True if the last parsed line is a task, the group being fetched is then saved if the line was the last line of the file.
+	bool last_line_is_task;
+	///The invalid due dates of the group being fetched, which are only displayed once the group is saved.
+	std::vector<InvalidTaskLine> invalid_task_lines;
+	
+	///The unfinished line at the end of the last chunk fed.
+	std::string unfinished_line;
+	///The offset of the first character of this->unfinished_line.
+	std::size_t unfinished_line_offset;
+	///The offset of the next character fed.
+	std::size_t fed_size;
+	///The line of the next line parsed, counted from 0 including the empty lines.
+	std::size_t line_number;
+	std::chrono::year_month_day current_date;
+	
+	friend std::vector<TaskGroup> task_io_internal::parse_chunks_parallel(const std::vector<std::string_view>& chunks, const unsigned thread_count,
+																		void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&),
+																		parse_diagnostics::Collector* const diagnostics);
+};
+
+///The snapshot of the task file, see task_snapshot.hpp.
+constexpr const char* task_snapshot_filename = "tasks.snapshot";
+///The journal of the changes saved since the task file was last written entirely, see task_journal.hpp.
+constexpr const char* task_journal_filename = "tasks.journal";
+
 ///The function that simplifies the entire task file reading and conversion process.
+///The task file is memory mapped and parsed in place with TaskFileParser, the only copies made are the names of the constructed tasks and groups.
+///If the task file has not changed since the last overwrite_taskfile(), the groups are loaded from the snapshot instead of parsing the task file.
+///The journal is then replayed over the groups. If the journal could not be replayed entirely, a window is displayed and the groups replayed are written to the task file.
+///The groups are returned as in task_journal::as_loaded_from_task_file(), which is the list the indices of the journal refer to.
+///If replay_status is provided, the status of replaying the journal is stored to it instead, and nothing is written or displayed for it,
+///so a caller which only reads the task file leaves the task file and the journal as they are.
 ///
 ///May throw std::ios_base_failure for unknown I/O error, or std::runtime_error if the file could not be opened.
-///And may display a window if the a group is a nested group, or a task has an invalid due date.
-std::vector<TaskGroup> get_tasks(void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&) = task_io_internal::default_nested_group_callback);
+///And may display a window if the a group is a nested group, or a task has an invalid due date, unless they are recorded to diagnostics.
+std::vector<TaskGroup> get_tasks(void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&) = task_io_internal::default_nested_group_callback,
+								parse_diagnostics::Collector* const diagnostics = nullptr, task_journal::ReplayStatus* const replay_status = nullptr);
+/**
+Folds the journal into the task file by rewriting the task file with the journal replayed over it, so the programs reading the task file see every save.
+Nothing is written if there is no journal, or it was made for another version of the task file. Returns true if the task file was rewritten.
+
+The errors of the task file are recorded to diagnostics, and the lines they are on are not written, as with any rewrite of the task file.
+May throw std::ios_base_failure if the task file could not be read or written, std::runtime_error if it could not be opened,
+or the exceptions of parse_tasks_parallel().
+*/
+bool compact_task_file(parse_diagnostics::Collector* const diagnostics);
+///Reads and parses the task file from the provided stream in chunks with TaskFileParser, for task files which are not in the file system.
+///
+///May throw std::ios_base_failure if the stream lost its integrity while reading.
+///And may display a window if the a group is a nested group, or a task has an invalid due date, unless they are recorded to diagnostics.
+std::vector<TaskGroup> get_tasks_from_stream(std::istream& stream, void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&) = task_io_internal::default_nested_group_callback,
+											parse_diagnostics::Collector* const diagnostics = nullptr);
+
+///The least amount of characters parse_tasks_parallel() gives a thread, below this the threads cost more than parsing the characters.
+constexpr std::size_t parallel_parse_min_chunk_size = 256 * 1024;
+
+///Returns the amount of threads supported by the hardware, or 1 if it is unknown.
+unsigned default_parse_thread_count() noexcept;
+
+/**
+Parses the characters of an entire task file on multiple threads, and returns the same TaskGroups in the same order as TaskFileParser.
+
+The buffer is split into chunks at newlines, which are parsed on thread_count threads including the calling thread.
+The groups which open in one chunk and end in another are put together afterwards, when the lines of every chunk are fetched in order on the calling thread.
+A buffer too small to give every thread at least parallel_parse_min_chunk_size characters is parsed on fewer threads, down to only the calling thread.
+
+As with TaskFileParser, may throw std::out_of_range from a task line without the comma and space after its due date.
+The windows and nested group callback are only displayed and called from the calling thread, in the order of the lines, 
+or the errors are recorded to diagnostics from the calling thread.
+May also throw std::system_error if a thread could not be started.
+*/
+std::vector<TaskGroup> parse_tasks_parallel(const std::string_view buffer, const unsigned thread_count = default_parse_thread_count(),
+											void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&) = task_io_internal::default_nested_group_callback,
+											parse_diagnostics::Collector* const diagnostics = nullptr);
+///The multithreaded variant of get_tasks(), which parses the mapped task file with parse_tasks_parallel(). 
+///Returns the same TaskGroups as get_tasks(), and small task files are parsed on the calling thread only.
+///The snapshot is loaded instead when it is valid, and the journal is replayed or only its status stored to replay_status, as in get_tasks().
+///
+///May throw std::ios_base_failure for unknown I/O error, std::runtime_error if the file could not be opened, or std::system_error if a thread could not be started.
+///And may display a window if the a group is a nested group, or a task has an invalid due date, unless they are recorded to diagnostics.
+std::vector<TaskGroup> get_tasks_parallel(const unsigned thread_count = default_parse_thread_count(),
+										void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&) = task_io_internal::default_nested_group_callback,
+										parse_diagnostics::Collector* const diagnostics = nullptr, task_journal::ReplayStatus* const replay_status = nullptr);
+
+///Returns true if the task file is large enough to be loaded with get_tasks_lazily(), see task_index::lazy_load_min_size.
+bool should_load_lazily() noexcept;
+/**
+The lazy variant of get_tasks(), which indexes the task file with task_index::build() without loading any group.
+The journal is replayed over the index, loading only the groups it renames and the groups without a valid due date, which may have no tasks. The snapshot is not loaded, as it has every group loaded.
+If the journal could not be replayed entirely, a window is displayed and every group is loaded for writing the task file.
+
+May throw std::ios_base_failure for unknown I/O error, std::runtime_error if the file could not be opened,
+or std::out_of_range from a task line without the comma and space after its due date.
+The windows of nested groups and invalid due dates are displayed once their groups are loaded with task_index::load(), 
+or recorded to diagnostics for the groups loaded here.
+*/
+task_index::LazyTaskFile get_tasks_lazily(void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&) = task_io_internal::default_nested_group_callback,
+										parse_diagnostics::Collector* const diagnostics = nullptr);
 
 ///Returns a 2 character string equivalent of the argument. So 0-9 would be 0x.
 ///If the argument has more than 2 digits, it returns a string equivalent with more than 2 characters.
 std::string int_to_2char(const unsigned num);
 
-///The function for saving the provided array of TaskGroup to task file.
+///Converts the groups to the contents of the task file. A group with a single task is written as the task only.
+///The size of the contents is counted before writing, so the tasks are written into a single allocation without temporary strings.
+std::string taskgroups_to_str(const std::vector<TaskGroup>& taskgroups);
+
+///Saves the provided array of TaskGroup to task file, without displaying any window so it can be called from any thread.
+///The snapshot of the task file is saved along with it, or removed if it could not be saved. The journal is removed, as the task file has its changes.
 ///
-///It may display a window if an error occurs while saving to task file, and will give the user a decision to either:
+///Throws std::ios_base::failure if the task file could not be written, the journal is kept then.
+void write_taskfile(const std::vector<TaskGroup>& taskgroups);
+
+///The function for saving the provided array of TaskGroup to task file with write_taskfile().
+///
+///It asks the user with task_io_report::ask_retry() if an error occurs while saving to task file, for a decision to either:
 ///ignore the anomaly or try writing to the file again.
 void overwrite_taskfile(const std::vector<TaskGroup>& taskgroups);
 
 ///Converts a Task object to the format used in task file.
 std::string task_to_str(const Task& task);
 
+///The different points where parsing a yyyy/(m)m/(d)d string can go wrong. Anything other than YmdParseStatus::Ok is an error.
+enum class YmdParseStatus{
+	Ok, TooShort, NonNumericYmd, MonthNotProvided, NonNumericDay, DayNotProvided, InvalidYmd
+};
+
+///Returns the message describing the status, which is displayed to the user for the errors.
+const char* ymd_parse_status_message(const YmdParseStatus status) noexcept;
+
+///The result of parse_ymd(). YmdParseResult::ymd is only valid if YmdParseResult::ok() is true.
+struct YmdParseResult{
+	std::chrono::year_month_day ymd;
+	YmdParseStatus status;
+	
+	bool ok() const noexcept {return this->status == YmdParseStatus::Ok;}
+};
+
 /**
 Converts the string which is in yyyy/(m)m/(d)d format to std::chrono::year_month_day.
 The digits in parenthesis are optional, for example 05 and 5 would still be May, same for day.
 It can also take 2 digit month but 1 digit day, or the other way around as well.
 
-It may throw std::invalid_argument with different messages depending on what went wrong.
-\todo perhaps enum for different error points instead?
+This does not allocate or throw, an invalid string only results in a status other than YmdParseStatus::Ok.
+Use this rather than str_to_ymd() where invalid dates are expected, such as parsing the task file.
+*/
+YmdParseResult parse_ymd(const std::string_view str) noexcept;
+
+/**
+The throwing variant of parse_ymd().
+
+It may throw std::invalid_argument with the message of ymd_parse_status_message() depending on what went wrong.
 */
-std::chrono::year_month_day str_to_ymd(const std::string& str);
+std::chrono::year_month_day str_to_ymd(const std::string_view str);
 
 ///Converts the argument to std::string representation in  yyyy/(m)m/(d)d format, 
 ///where the digits in parenthesis would be there if need to, i.e., May would result in 5, not 05.
@@ -0,0 +1,155 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef task_journal_hpp
+#define task_journal_hpp
+
+#include "Task.hpp"
+#include "task_snapshot.hpp"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <functional>
+#include <string_view>
+
+/**
+\file task_journal.hpp
+Provides the journal of the task file, where saving appends the edits made since the last save instead of rewriting the entire task file.
+Loading the task file replays the journal over it, and once the journal grows large enough it is folded back into the task file by rewriting it.
+
+The journal consists of a header, with the format version and the size and last write time of the task file it applies to (see task_snapshot::SourceStamp),
+followed by a batch for each save. A batch is its size and checksum, then its encoded operations. 
+A batch is either replayed entirely or not at all, so a save interrupted midway cannot leave half of a merge in the task list.
+*/
+namespace task_journal{
+	///The version of the journal format, increment this on any change to the format.
+	constexpr std::uint32_t format_version = 1;
+	///The least size of the journal before should_compact() folds it into the task file, regardless of the size of the task file.
+	constexpr std::uint64_t min_compaction_size = 1024 * 1024;
+	
+	/**
+	An edit to the list of groups saved by overwrite_taskfile(), which is the list of the bars in root view.
+	The index refers to the group in the list after the operations before it, starting from the groups as in as_loaded_from_task_file(),
+	which is the list a session appending to the journal loaded as well.
+	
+	Merging a group into another is a Modify of the group merged into, then a Delete of the merged group.
+	*/
+	struct Operation{
+		enum class Type : std::uint8_t{
+			Add, Modify, Delete, Rename
+		};
+		
+		Type type;
+		///The index of the group of Type::Modify, Type::Delete and Type::Rename.
+		std::uint32_t index;
+		///The group appended by Type::Add, the group replacing the group at the index by Type::Modify, or only the new group name for Type::Rename.
+		TaskGroup taskgroup;
+		
+		///Appends the group to the end of the list.
+		static Operation add(const TaskGroup& taskgroup);
+		///Replaces the group at the index.
+		static Operation modify(const std::size_t index, const TaskGroup& taskgroup);
+		///Erases the group at the index.
+		static Operation erase(const std::size_t index);
+		///Changes the name of the group at the index.
+		static Operation rename(const std::size_t index, const std::string& group_name);
+	};
+	
+	///Returns true if the type, index and group of both are the same.
+	inline bool operator==(const Operation& lhs, const Operation& rhs){
+		return (lhs.type == rhs.type) && (lhs.index == rhs.index) && (lhs.taskgroup == rhs.taskgroup);
+	}
+	inline bool operator!=(const Operation& lhs, const Operation& rhs){
+		return !(lhs == rhs);
+	}
+	
+	///Encodes the operations of a batch.
+	std::string encode(const std::vector<Operation>& operations);
+	///Decodes the operations of a batch, or returns std::nullopt if the batch is not entirely valid.
+	std::optional<std::vector<Operation>> decode(const std::string_view encoded_operations);
+	///Returns the operations with the ones made to the same group back to back folded into one, such as the renames of a group while typing its name,
+	///or the edits made to the group being viewed in group view. Applying the result gives the same groups as applying the operations.
+	std::vector<Operation> coalesce(std::vector<Operation>&& operations);
+	///Applies the operation to the groups. Returns false and leaves the groups as is if the index of the operation is out of range.
+	bool apply(std::vector<TaskGroup>& taskgroups, const Operation& operation);
+	
+	/**
+	Returns the groups as they would be loaded from the task file written by overwrite_taskfile(), see task_snapshot::serialize():
+	a group with a single task loses its name, and a group without tasks is dropped and lends its name to the next single task.
+	*/
+	std::vector<TaskGroup> as_loaded_from_task_file(std::vector<TaskGroup>&& taskgroups);
+	
+	enum class ReplayStatus{
+		///There is no journal, the groups are as loaded from the task file.
+		NoJournal,
+		///Every batch of the journal is replayed.
+		Replayed,
+		///The journal was made for another version of the task file, which was changed outside of WorkTable. None of the batches are replayed.
+		StaleJournal,
+		///The last batch is cut short, such as from the program closing while saving. The batches before it are replayed.
+		IncompleteBatch,
+		///A batch failed its checksum, could not be decoded, or has an operation with an invalid index. The batches before it are replayed.
+		CorruptedBatch
+	};
+	
+	///Returns the message describing the status, which is displayed to the user if the journal could not be replayed entirely.
+	const char* replay_status_message(const ReplayStatus status) noexcept;
+	
+	struct ReplayResult{
+		///The groups after replaying the journal, as in as_loaded_from_task_file(), even if there is no journal or it is stale.
+		std::vector<TaskGroup> taskgroups;
+		ReplayStatus status;
+	};
+	
+	/**
+	Checks the journal against source_filename (the task file), then calls apply_batch with the operations of every valid batch in order.
+	taskgroup_count is the amount of groups loaded from the task file, the indices of a batch are checked against it before the batch is passed,
+	so apply_batch can apply the operations without checking them. 
+	
+	This is replay() for lists of groups other than std::vector<TaskGroup>, such as the groups of a task file loaded lazily.
+	*/
+	ReplayStatus replay_batches(const std::string_view journal, const std::string& source_filename, std::size_t taskgroup_count,
+								const std::function<void(const std::vector<Operation>&)>& apply_batch);
+	///Replays the batches of the journal over the groups loaded from source_filename (the task file).
+	///The groups are normalized with as_loaded_from_task_file() before replaying, as the indices of the journal are of the normalized groups.
+	ReplayResult replay(std::vector<TaskGroup>&& taskgroups, const std::string_view journal, const std::string& source_filename);
+	///Replays the batches of journal_filename over the groups loaded from source_filename (the task file).
+	ReplayResult replay_file(std::vector<TaskGroup>&& taskgroups, const std::string& journal_filename, const std::string& source_filename);
+	
+	/**
+	Appends the operations to journal_filename as a single batch. 
+	loaded_source is the stamp of source_filename the operations were made to, as it was when it was last loaded or written.
+	A new journal is started if journal_filename does not exist or was made for another version of source_filename.
+	
+	May throw std::ios_base::failure if the status of source_filename could not be read, source_filename no longer matches loaded_source
+	as it was changed outside of WorkTable, or the journal could not be written. 
+	The indices of the operations do not apply to a changed source_filename, so it must be rewritten entirely instead.
+	*/
+	void append(const std::vector<Operation>& operations, const std::string& journal_filename, const std::string& source_filename,
+				const task_snapshot::SourceStamp& loaded_source);
+	///Returns true if journal_filename is large enough to be folded into source_filename by rewriting it:
+	///once it is both at least min_compaction_size and a quarter of the size of source_filename.
+	bool should_compact(const std::string& journal_filename, const std::string& source_filename) noexcept;
+	///Removes journal_filename if it exists.
+	void remove(const std::string& journal_filename) noexcept;
+	///Returns the name a stale journal is kept as by reject(), which is journal_filename followed by ".rejected".
+	inline std::string rejected_filename(const std::string& journal_filename) {return journal_filename + ".rejected";}
+	/**
+	Renames journal_filename to rejected_filename(), replacing a journal rejected before, so the saves of a stale journal are not lost 
+	once the next save starts a new journal. Returns false if the journal could not be renamed, it is left as is then.
+	*/
+	bool reject(const std::string& journal_filename) noexcept;
+}
+
+#endif
@@ -0,0 +1,109 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef task_snapshot_hpp
+#define task_snapshot_hpp
+
+#include "Task.hpp"
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+/**
+\file task_snapshot.hpp
+Provides the binary snapshot of the task file, which is loaded instead of parsing the task file when the task file has not changed since the snapshot.
+
+The snapshot consists of:
+- task_snapshot::Header, with the format version, the checksum of the rest of the snapshot, and the size and last write time of the task file it was made with.
+- task_snapshot::GroupRecord for each group, the group offset table, with the range of tasks in the group.
+- task_snapshot::TaskRecord for each task, with the due date as std::chrono::sys_days.
+- The string pool, which has the characters of every task and group name, without separators.
+
+The integers are in the byte order of the machine, a snapshot from a machine of another byte order fails the version check and the task file is parsed instead.
+*/
+namespace task_snapshot{
+	///The version of the snapshot format, increment this on any change to the format.
+	constexpr std::uint32_t format_version = 1;
+	
+	///The size and last write time of the task file, a snapshot is only loaded if the task file still has the ones it was made with.
+	struct SourceStamp{
+		std::uint64_t size;
+		std::int64_t last_write_time;
+	};
+	
+	inline bool operator==(const SourceStamp& lhs, const SourceStamp& rhs){
+		return (lhs.size == rhs.size) && (lhs.last_write_time == rhs.last_write_time);
+	}
+	inline bool operator!=(const SourceStamp& lhs, const SourceStamp& rhs){
+		return !(lhs == rhs);
+	}
+	
+	struct Header{
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t group_count;
+		std::uint32_t task_count;
+		std::uint32_t string_pool_size;
+		std::uint64_t source_size;
+		std::int64_t source_last_write_time;
+		///The checksum of every byte after the header.
+		std::uint64_t checksum;
+	};
+	
+	struct GroupRecord{
+		std::uint32_t name_offset;
+		std::uint32_t name_size;
+		///The index of the first task of the group in the task records.
+		std::uint32_t first_task;
+		std::uint32_t task_count;
+	};
+	
+	struct TaskRecord{
+		///std::chrono::sys_days of the due date.
+		std::int32_t due_date;
+		std::uint32_t name_offset;
+		std::uint32_t name_size;
+	};
+	
+	///Returns the stamp of the file, or std::nullopt if the file does not exist or its status could not be read.
+	std::optional<SourceStamp> get_source_stamp(const std::string& filename) noexcept;
+	
+	///Returns the checksum stored in Header::checksum for the provided bytes.
+	std::uint64_t checksum(const std::string_view bytes) noexcept;
+	
+	/**
+	Returns the snapshot of the groups made with the task file of the provided stamp.
+	
+	The snapshot has the groups as they would be loaded from the task file written by overwrite_taskfile(), rather than the provided groups as is:
+	a group with a single task is written without its group, which loses its name, and a group without tasks lends its name to the next single task.
+	
+	Returns an empty string if the task file would not load the same groups, 
+	such as a name with a newline, a task name ending with '{', or a year not written with 4 digits; the snapshot should not be written then.
+	*/
+	std::string serialize(const std::vector<TaskGroup>& taskgroups, const SourceStamp& source);
+	///Returns the groups of the snapshot, or std::nullopt if the snapshot is invalid, corrupted, or not made with the task file of the provided stamp.
+	std::optional<std::vector<TaskGroup>> deserialize(const std::string_view snapshot, const SourceStamp& source, const std::chrono::year_month_day& current_date);
+	
+	///Writes the snapshot of the groups to snapshot_filename, made with the current source_filename; source_filename must already have the groups written to it.
+	///The snapshot is only a cache of source_filename, so failing to write it is not an error: the snapshot is removed and the task file is parsed on the next load.
+	void save(const std::vector<TaskGroup>& taskgroups, const std::string& snapshot_filename, const std::string& source_filename);
+	///Loads the groups from snapshot_filename, or returns std::nullopt if the snapshot does not exist, is invalid, or source_filename has changed since the snapshot was made.
+	std::optional<std::vector<TaskGroup>> load(const std::string& snapshot_filename, const std::string& source_filename);
+	///Removes snapshot_filename if it exists, so it cannot be loaded while source_filename is being rewritten.
+	void remove(const std::string& snapshot_filename) noexcept;
+}
+
+#endif
@@ -0,0 +1,145 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef task_store_hpp
+#define task_store_hpp
+
+#include "Task.hpp"
+#include "name_pool.hpp"
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+/**
+\file task_store.hpp
+Provides TaskStore, the single place where the tasks and groups being displayed are kept.
+*/
+
+/**
+The tasks and groups being displayed, stored as columns: the due dates, the name handles and the groups of the tasks are each in an array of their own,
+indexed by the ID of the task. A Bar or a window refers to its task or group by ID instead of holding a copy of it.
+
+The IDs stay the same until the task or group is erased, even as other tasks and groups are added, erased or moved between groups,
+and the IDs of the erased ones are reused afterwards. What holds on to a task or group across events, like a window editing it,
+keeps a TaskHandle or GroupHandle instead, which no longer finds it once it is erased, even if its ID was reused.
+The tasks of a group are kept from nearest due date to furthest; tasks with the same due date stay in the order they were added.
+
+An ID passed to a member function must be one of a task or group in the store.
+*/
+class TaskStore{
+	public:
+	using TaskId = std::uint32_t;
+	using GroupId = std::uint32_t;
+	
+	///Never the ID of a task or a group.
+	static constexpr std::uint32_t no_id = UINT32_MAX;
+	
+	///The ID of a task with the generation it was added in. Every task and group added to a store gets a new generation, even after clear().
+	struct TaskHandle{
+		TaskId id = no_id;
+		std::uint64_t generation = 0;
+	};
+	///The ID of a group with the generation it was added in.
+	struct GroupHandle{
+		GroupId id = no_id;
+		std::uint64_t generation = 0;
+	};
+	
+	///The days remaining of the tasks are counted from current_ymd.
+	explicit TaskStore(const std::chrono::year_month_day& current_ymd);
+	
+	///Adds a group with the name and tasks of taskgroup, and returns its ID.
+	GroupId add_group(const TaskGroup& taskgroup);
+	///Erases the group and every task in it.
+	void erase_group(const GroupId group);
+	void rename_group(const GroupId group, const std::string_view group_name);
+	///Moves every task of from to into in linear time, from is left without tasks.
+	void merge_groups(const GroupId into, const GroupId from);
+	
+	const std::string& group_name(const GroupId group) const {return this->group_names[group];}
+	///The tasks of the group, from nearest due date to furthest.
+	const std::vector<TaskId>& group_tasks(const GroupId group) const {return this->group_task_ids[group];}
+	///Returns a copy of the group, for the journal and for comparing with the groups of a task file.
+	TaskGroup taskgroup(const GroupId group) const;
+	///Returns a copy of the groups in the provided order, for writing them to the task file.
+	std::vector<TaskGroup> taskgroups(const std::vector<GroupId>& groups) const;
+	
+	///Adds the task to the group, and returns its ID.
+	TaskId add_task(const GroupId group, const Task& task);
+	///Erases the task from its group. The group stays in the store, even without tasks.
+	void erase_task(const TaskId task);
+	///Sets the due date and name of the task, which moves it to its place in its group by the new due date, after the tasks with the same due date.
+	void set_task(const TaskId task, const std::chrono::year_month_day& due_date, const std::string_view name);
+	///Moves the task to the end of its due date among the tasks of group.
+	void move_task(const TaskId task, const GroupId group);
+	
+	///Returns true if task is the ID of a task in the store, for IDs which may have been erased since.
+	bool contains_task(const TaskId task) const noexcept {return (task < this->task_groups.size()) && (this->task_groups[task] != no_id);}
+	Task task(const TaskId task) const;
+	GroupId group_of(const TaskId task) const {return this->task_groups[task];}
+	std::string_view name(const TaskId task) const noexcept {return this->names[task].view();}
+	std::chrono::year_month_day due_date(const TaskId task) const noexcept;
+	///Returns the days from the date the store was constructed with to the due date of the task.
+	std::chrono::days days_remaining(const TaskId task) const noexcept {return std::chrono::days(this->due_days[task] - this->current_day);}
+	
+	///Returns the count of tasks in the store.
+	std::size_t task_count() const noexcept {return this->due_days.size() - this->free_task_ids.size();}
+	///Returns the count of groups in the store.
+	std::size_t group_count() const noexcept {return this->group_names.size() - this->free_group_ids.size();}
+	
+	TaskHandle task_handle(const TaskId task) const noexcept {return {task, this->task_generations[task]};}
+	GroupHandle group_handle(const GroupId group) const noexcept {return {group, this->group_generations[group]};}
+	///Returns the ID of the task, or TaskStore::no_id if it was erased since the handle was taken.
+	TaskId find_task(const TaskHandle& handle) const noexcept;
+	///Returns the ID of the group, or TaskStore::no_id if it was erased since the handle was taken.
+	GroupId find_group(const GroupHandle& handle) const noexcept;
+	
+	///Erases every task and group, the IDs start over from 0. The handles taken before are not found afterwards.
+	void clear() noexcept;
+	
+	private:
+	std::chrono::year_month_day current_ymd() const noexcept;
+	///Inserts the task after the tasks of group which are due by its due date.
+	void insert_sorted(const TaskId task, const GroupId group);
+	///Removes the task from the tasks of its group, without erasing it.
+	void remove_from_group(const TaskId task);
+	///Returns the position of the task in the tasks of its group, found by binary search on its due date.
+	std::vector<TaskId>::iterator find_in_group(const TaskId task);
+	
+	///Days since 1970/01/01, indexed by TaskId.
+	std::vector<std::int32_t> due_days;
+	///Indexed by TaskId, the IDs of erased tasks keep the empty name, so their names are released from name_pool.
+	std::vector<name_pool::Name> names;
+	///The group of each task, or TaskStore::no_id for the IDs of erased tasks. Indexed by TaskId.
+	std::vector<GroupId> task_groups;
+	///The generation each task was added in, 0 for the IDs of erased tasks. Indexed by TaskId.
+	std::vector<std::uint64_t> task_generations;
+	std::vector<TaskId> free_task_ids;
+	
+	///Indexed by GroupId.
+	std::vector<std::string> group_names;
+	///Indexed by GroupId, the IDs of erased groups have no tasks.
+	std::vector<std::vector<TaskId>> group_task_ids;
+	///The generation each group was added in, 0 for the IDs of erased groups. Indexed by GroupId.
+	std::vector<std::uint64_t> group_generations;
+	std::vector<GroupId> free_group_ids;
+	
+	///The generation of the next task or group added, it is never reset so that a handle is not found again after clear().
+	std::uint64_t next_generation = 1;
+	std::int32_t current_day;
+};
+
+#endif
@@ -13,7 +13,7 @@ You should have received a copy of the GNU General Public License along with Wor
 #ifndef timecalc_hpp
 #define timecalc_hpp
 
-#include "Timescale.hpp"
+#include "timescale.hpp"
 #include <chrono>
 
 /**
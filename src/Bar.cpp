@@ -12,6 +12,7 @@ You should have received a copy of the GNU General Public License along with Wor
 
 #include "Bar.hpp"
 #include "BarGroup.hpp"
+#include "task_store.hpp"
 
 #include <FL/Fl.H>
 #include <FL/Fl_Box.H>
@@ -19,66 +20,20 @@ You should have received a copy of the GNU General Public License along with Wor
 #include <FL/fl_draw.h>
 #include <FL/fl_ask.h>
 
+#include <span>
 #include <cmath>
 #include <string>
 #include <iostream>
 
-Bar_TaskGroup::Bar_TaskGroup(const TaskGroup& taskgroup)
-:	TaskGroup(taskgroup)
-{
-	this->sort_and_reassign();
-}
-
-void Bar_TaskGroup::sort_and_reassign(){
-	std::sort(this->tasks.begin(), this->tasks.end(), Task::due_date_is_earlier);
-	this->_nearest_due_date_task = this->tasks.front();
-	this->_furthest_due_date_task = this->tasks.back();	
-}
-
-void Bar_TaskGroup::add_task(const Task& task){
-	this->tasks.push_back(task);
-	this->sort_and_reassign();
-}
-
-void Bar_TaskGroup::merge_taskgroup(const TaskGroup& other){
-	this->tasks.reserve(this->tasks.size() + other.tasks.size());
-	for(const Task& task : other.tasks){
-		this->tasks.push_back(task);
-	}
-	this->sort_and_reassign();
-}
-
-bool Bar_TaskGroup::set_task_at(const std::size_t index, const Task& other){
-	if(index >= this->tasks.size()) return false;
-	this->tasks[index] = other;
-	this->sort_and_reassign();
-	return true;
-}
-
-bool Bar_TaskGroup::delete_task_at(const std::size_t index){
-	if(index >= this->tasks.size()) return false;
-	
-	const bool is_nearest_due_date_task = index == 0;
-	const bool is_furthest_due_date_task = index == this->tasks.size();
-	
-	if(is_nearest_due_date_task)
-		this->_nearest_due_date_task = this->tasks[1];
-	if(is_furthest_due_date_task)
-		this->_nearest_due_date_task = this->tasks[this->tasks.size() - 1];
-	
-	this->tasks.erase(this->tasks.begin() + index);
-	return true;
-}
-
-
 Bar::Bar(const BarConstructorArgs& args)
-:	Bar(args.xpos, args.ypos, args.width, args.height, args.taskgroup, args.days_from_interval)
+:	Bar(args.xpos, args.ypos, args.width, args.height, args.tasks, args.days_from_interval)
 {
 }
 
-Bar::Bar(const int xpos, const int ypos, const int width, const int height, const Bar_TaskGroup& taskgroup, const std::chrono::days& days_from_interval)
+Bar::Bar(const int xpos, const int ypos, const int width, const int height, const BarTasks& tasks, const std::chrono::days& days_from_interval)
 :	Fl_Button(xpos, ypos, width, height),
-	taskgroup(taskgroup),
+	tasks(tasks),
+	item_index(0),
 	days_from_interval(days_from_interval)
 {
 	this->align(FL_ALIGN_LEFT | FL_ALIGN_INSIDE | FL_ALIGN_WRAP);
@@ -91,45 +46,24 @@ Bar::Bar(const int xpos, const int ypos, const int width, const int height, cons
 	this->update_label();
 }
 
-void Bar::merge_taskgroup(const TaskGroup& other_taskgroup){
-	const bool has_no_taskgroup_name = this->is_single_task();
-	if(has_no_taskgroup_name) this->taskgroup.group_name = this->taskgroup.tasks[0].name();
-	this->taskgroup.merge_taskgroup(other_taskgroup);
-	this->update_width(this->days_from_interval, (this->parent())->x());
-	this->update_label();
-}
-
-
-void Bar::update_group_name(const char* const group_name){
-	this->taskgroup.group_name = group_name;
-	this->update_label();
-}
-
-void Bar::update_task(const char* const task_name, const std::chrono::year_month_day& due_date, const std::chrono::days& days_from_interval, const int parent_xpos){
-	this->taskgroup.group_name = task_name;
-	
-	const Task task {due_date, task_name};
-	this->taskgroup.set_task_at(0, task);
-	
+void Bar::refresh(const std::chrono::days& days_from_interval, const int parent_xpos){
 	this->update_label();
 	
 	this->update_width(days_from_interval, parent_xpos);	
 	this->update_color_from_days_remaining();	
 }
 
+void Bar::rebind(const BarTasks& tasks, const std::size_t item_index, const std::chrono::days& days_from_interval, const int parent_xpos){
+	this->tasks = tasks;
+	this->item_index = item_index;
+	this->refresh(days_from_interval, parent_xpos);
+}
+
 void Bar::update_width(const std::chrono::days& days_from_interval, const int parent_xpos){
-	const int bar_width = Bar::calc_bar_width(this->taskgroup.furthest_due_date_task().days_remaining(), days_from_interval);
-	const bool all_tasks_are_overdue = bar_width <= 0;
-	
 	this->days_from_interval = days_from_interval;
-	const bool use_overdue_position = this->taskgroup.nearest_due_date_task().days_remaining().count() < 1;
 	
-	if(use_overdue_position && all_tasks_are_overdue)
-		this->resize(parent_xpos, this->y(), BarGroup::bar_xoffset, this->h());
-	else if(use_overdue_position && !all_tasks_are_overdue)
-		this->resize(parent_xpos, this->y(), bar_width + BarGroup::overdue_bar_width, this->h());
-	else
-		this->resize(parent_xpos + BarGroup::bar_xoffset, this->y(), bar_width, this->h());
+	const BarSpan span = Bar::calc_span(this->tasks, days_from_interval, parent_xpos);
+	this->resize(span.xpos, this->y(), span.width, this->h());
 }
 
 
@@ -160,38 +94,57 @@ int Bar::calc_bar_width(const std::chrono::days& days_remaining, const std::chro
 	return std::clamp(int(width), 0, BarGroup::bar_max_width);
 }
 
+BarSpan Bar::calc_span(const BarTasks& tasks, const std::chrono::days& days_from_interval, const int parent_xpos) noexcept{
+	const int bar_width = Bar::calc_bar_width(tasks.furthest_days_remaining(), days_from_interval);
+	const bool all_tasks_are_overdue = bar_width <= 0;
+	const bool use_overdue_position = tasks.nearest_days_remaining().count() < 1;
+	
+	if(use_overdue_position && all_tasks_are_overdue)
+		return BarSpan{parent_xpos, BarGroup::bar_xoffset};
+	else if(use_overdue_position && !all_tasks_are_overdue)
+		return BarSpan{parent_xpos, bar_width + BarGroup::overdue_bar_width};
+	else
+		return BarSpan{parent_xpos + BarGroup::bar_xoffset, bar_width};
+}
 
-//Protected
-void Bar::draw(){
-	const bool use_overdue_position = this->taskgroup.nearest_due_date_task().days_remaining().count() < 1;
-	const bool all_tasks_are_overdue = this->taskgroup.furthest_due_date_task().days_remaining().count() < 1;
+void Bar::draw_tasks(const BarTasks& tasks, const std::chrono::days& days_from_interval, const int xpos, const int ypos, const int height){
+	const bool use_overdue_position = tasks.nearest_days_remaining().count() < 1;
+	const bool all_tasks_are_overdue = tasks.furthest_days_remaining().count() < 1;
 
 	//If all the tasks which the Bar represent is overdue, there would only be one color,
 	//so no need to iterate over every task, as they are all overdue anyways.
 	if(use_overdue_position && all_tasks_are_overdue){
-		fl_draw_box(FL_FLAT_BOX, this->x(), this->y(), BarGroup::overdue_bar_width, this->h(), get_bar_color(this->taskgroup.furthest_due_date_task().days_remaining().count()));
-	}	
+		fl_draw_box(FL_FLAT_BOX, xpos, ypos, BarGroup::overdue_bar_width, height, get_bar_color(tasks.furthest_days_remaining().count()));
+		return;
+	}
+	
 	//This is when a task is overdue, but not all tasks are.
 	//The xpos is at its parents' and the width is of the furthest due date plus the overdue width.
+	//Else start at regular bar xoffset with regular width.
 	//We reverse iterate because the sorted tasks are in nearest-to-furthest order, but we want to draw the further ones earlier than the nearer ones for overlay.
-	else if(use_overdue_position && !all_tasks_are_overdue){
-		for(std::int_least64_t i = this->taskgroup.tasks.size()-1; i >= 0; i--){
-			const Task& task = this->taskgroup.tasks[i];
-			const float of_days_from_interval = std::clamp(float(task.days_remaining().count()) / float(this->days_from_interval.count()), 0.0f, 1.0f);
-			const float width = float(BarGroup::bar_max_width) * of_days_from_interval;
-			fl_draw_box(FL_FLAT_BOX, this->x(), this->y(), width + BarGroup::overdue_bar_width, this->h(), get_bar_color(task.days_remaining().count()));
-		}
-	}
-	//Start at regular bar xoffset with regular width.
-	//We reverse iterate because the sorted tasks are in nearest-to-furthest order, but we want to draw the further ones earlier than the nearer ones for overlay.	
-	else{
-		for(std::int_least64_t i = this->taskgroup.tasks.size()-1; i >= 0; i--){
-			const Task& task = this->taskgroup.tasks[i];
-			const float of_days_from_interval = std::clamp(float(task.days_remaining().count()) / float(this->days_from_interval.count()), 0.0f, 1.0f);
-			const float width = float(BarGroup::bar_max_width) * of_days_from_interval;
-			fl_draw_box(FL_FLAT_BOX, this->x(), this->y(), width, this->h(), get_bar_color(task.days_remaining().count()));
-		}
+	const int overdue_width = use_overdue_position ? BarGroup::overdue_bar_width : 0;
+	const std::span<const TaskStore::TaskId> task_ids = tasks.task_ids();
+	for(std::int_least64_t i = task_ids.size()-1; i >= 0; i--){
+		const std::chrono::days days_remaining = tasks.store->days_remaining(task_ids[i]);
+		const float of_days_from_interval = std::clamp(float(days_remaining.count()) / float(days_from_interval.count()), 0.0f, 1.0f);
+		const float width = float(BarGroup::bar_max_width) * of_days_from_interval;
+		fl_draw_box(FL_FLAT_BOX, xpos, ypos, width + overdue_width, height, get_bar_color(days_remaining.count()));
 	}
+}
+
+std::string Bar::make_label(const BarTasks& tasks){
+	//[Task[0] name] ([days] days)
+	if(tasks.task_ids().size() == 1) 
+		return std::string(tasks.store->name(tasks.task_ids().front())) + " (" + std::to_string(tasks.nearest_days_remaining().count()) + " days)";
+	
+	//[TaskGroup name] ([days] - [days] days)
+	return tasks.store->group_name(tasks.group) + " (" + std::to_string(tasks.nearest_days_remaining().count()) + "-" + std::to_string(tasks.furthest_days_remaining().count()) + " days)";
+}
+
+
+//Protected
+void Bar::draw(){
+	Bar::draw_tasks(this->tasks, this->days_from_interval, this->x(), this->y(), this->h());
 	
 	//Tells FLTK to draw the text only, we drew the colors manually.
 	//We accomplished this by telling FLTK to treat this as a no-background widget (this->box(FL_NO_BOX)),
@@ -250,15 +203,7 @@ int Bar::handle(const int event){
 
 //private
 void Bar::update_label(){
-	std::string label;
-		//[Task[0] name] ([days] days)
-	if(this->is_single_task()) 
-		label = taskgroup.tasks[0].name() + " (" + std::to_string(taskgroup.tasks[0].days_remaining().count()) + " days)";
-	else
-		//[TaskGroup name] ([days] - [days] days)		
-		label = taskgroup.group_name + " (" + std::to_string(taskgroup.nearest_due_date_task().days_remaining().count()) + "-" + std::to_string(taskgroup.furthest_due_date_task().days_remaining().count()) + " days)";
-	
-	this->copy_label(label.c_str());		
+	this->copy_label(Bar::make_label(this->tasks).c_str());		
 }
 
 void Bar::update_color_from_days_remaining() noexcept{
@@ -313,23 +258,23 @@ void Bar::right_mouse_click_callback(){
 }
 
 
-BarConstructorArgs::BarConstructorArgs(const BarGroup* const parent, const TaskGroup& taskgroup, 
+BarConstructorArgs::BarConstructorArgs(const BarGroup* const parent, const BarTasks& tasks, 
 										const int bar_count, const int item_index)
-:	taskgroup(taskgroup)
+:	tasks(tasks)
 {
-	const bool use_overdue_position = this->taskgroup.nearest_due_date_task().days_remaining().count() < 1;
+	const bool use_overdue_position = this->tasks.nearest_days_remaining().count() < 1;
 	
 	if(use_overdue_position){
 		xpos = parent->x();
-		const bool has_only_overdue_tasks = this->taskgroup.furthest_due_date_task().days_remaining().count() <= 0;
+		const bool has_only_overdue_tasks = this->tasks.furthest_days_remaining().count() <= 0;
 		if(has_only_overdue_tasks)
 			width = BarGroup::overdue_bar_width;
 		else
-			width = BarGroup::overdue_bar_width + Bar::calc_bar_width(this->taskgroup.furthest_due_date_task().days_remaining(), parent->get_days_from_interval());
+			width = BarGroup::overdue_bar_width + Bar::calc_bar_width(this->tasks.furthest_days_remaining(), parent->get_days_from_interval());
 	}
 	else{
 		xpos = parent->x() + BarGroup::bar_xoffset;
-		width = Bar::calc_bar_width(this->taskgroup.furthest_due_date_task().days_remaining(), parent->get_days_from_interval());
+		width = Bar::calc_bar_width(this->tasks.furthest_days_remaining(), parent->get_days_from_interval());
 	}
 	
 	const int bar_height_with_yspacing = Bar::calc_height_with_yspacing(parent->h(), bar_count);
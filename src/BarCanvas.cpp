@@ -0,0 +1,152 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "BarCanvas.hpp"
+#include "BarGroup.hpp"
+#include "Bar.hpp"
+
+#include <FL/Fl.H>
+#include <FL/Fl_Widget.H>
+
+#include <FL/fl_draw.H>
+#include <FL/fl_ask.H>
+
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+
+BarCanvas::BarCanvas(const int xpos, const int ypos, const int width, const int height)
+:	Fl_Widget(xpos, ypos, width, height),
+	pushed_item_index(-1)
+{
+	this->box(FL_NO_BOX);
+}
+
+
+//protected
+void BarCanvas::draw(){
+	const BarGroup* const bar_group = (const BarGroup*)(this->parent());
+	const std::chrono::days days_from_interval = bar_group->get_days_from_interval();
+	const int bar_height = Bar::calc_height(bar_group->row_height());
+
+	fl_push_clip(this->x(), this->y(), this->w(), this->h());
+	fl_font(this->labelfont(), this->labelsize());
+
+	for(std::size_t i = 0; i < bar_group->visible_row_count; ++i){
+		const std::size_t item_index = bar_group->first_visible_row + i;
+		const int bar_ypos = bar_group->row_ypos(item_index);
+		//only the rows in the area damaged by BarGroup are drawn, such as a single row after it was edited.
+		if(!fl_not_clipped(this->x(), bar_ypos, this->w(), bar_height)) continue;
+
+		const BarTasks& row = bar_group->rows[item_index];
+		const BarSpan span = Bar::calc_span(row, days_from_interval, bar_group->x());
+		Bar::draw_tasks(row, days_from_interval, span.xpos, bar_ypos, bar_height);
+
+		//the label is placed as Fl_Button places the label of a Bar, which is inset by 3 pixels on each side.
+		fl_color(this->labelcolor());
+		fl_draw(Bar::make_label(row).c_str(), span.xpos + 3, bar_ypos, span.width - 6, bar_height, FL_ALIGN_LEFT | FL_ALIGN_INSIDE | FL_ALIGN_WRAP);
+	}
+
+	fl_pop_clip();
+}
+
+int BarCanvas::handle(const int event){
+	constexpr int handled_event = 1;
+	constexpr int unhandled_event = 0;
+	BarGroup* const bar_group = (BarGroup*)(this->parent());
+
+	//See Bar::handle() for the order of the events.
+	switch(event){
+		//Only pushing on a row is handled, so the widgets under the other areas still receive the event.
+		case FL_PUSH:
+			this->pushed_item_index = bar_group->get_item_index_at(Fl::event_x(), Fl::event_y());
+			return (this->pushed_item_index < 0) ? unhandled_event : handled_event;
+
+		case FL_RELEASE:{
+			const std::int_least64_t pushed_item_index = this->pushed_item_index;
+			this->pushed_item_index = -1;
+			if(pushed_item_index < 0) return unhandled_event;
+
+			const bool clicked_and_released_same_row = bar_group->get_item_index_at(Fl::event_x(), Fl::event_y()) == pushed_item_index;
+			if(clicked_and_released_same_row){
+				const int clicked_button = Fl::event_button();
+				bar_group->signal_hide_root_group_box();
+
+				if(clicked_button == FL_LEFT_MOUSE)
+					this->left_mouse_click_callback(pushed_item_index);
+				if(clicked_button == FL_RIGHT_MOUSE)
+					this->right_mouse_click_callback(pushed_item_index);
+			}else{
+				bar_group->handle_bar_mouse_button_release(std::size_t(pushed_item_index));
+			}
+			return handled_event;
+		}
+
+		case FL_DRAG:
+			if(this->pushed_item_index < 0) return unhandled_event;
+			bar_group->signal_bar_being_dragged();
+			return handled_event;
+
+		default:
+			return Fl_Widget::handle(event);
+	}
+}
+
+
+//private
+void BarCanvas::left_mouse_click_callback(const std::size_t item_index){
+	BarGroup* const bar_group = (BarGroup*)(this->parent());
+	try{
+		if(bar_group->row_is_single_task(item_index))
+			bar_group->request_window_for_editing_task(item_index);
+		else
+			bar_group->display_tasks_in_task_group(item_index);
+	}
+	catch(const std::bad_alloc& alloc_err){
+		fl_alert("Caught memory allocation error while requesting window for editing TaskGroup. (BarCanvas::left_mouse_click_callback())");
+	}
+	catch(const std::length_error& exceeded_max_alloc){
+		fl_alert("Exceeded maximum memory allocation while requesting window for editing TaskGroup. (BarCanvas::left_mouse_click_callback())");
+	}
+	catch(const std::exception& unspecified_excp){
+		const std::string msg = std::string("Caught unspecified exception while requesting window for editing TaskGroup. (BarCanvas::left_mouse_click_callback())\n")
+								+ unspecified_excp.what();
+		fl_alert(msg.c_str());
+	}
+	catch(...){
+		fl_alert("Caught unspecified throw while requesting window for editing TaskGroup. (BarCanvas::left_mouse_click_callback())");
+	}
+}
+
+void BarCanvas::right_mouse_click_callback(const std::size_t item_index){
+	BarGroup* const bar_group = (BarGroup*)(this->parent());
+	try{
+		if(bar_group->row_is_single_task(item_index))
+			bar_group->request_window_for_editing_task(item_index);
+		else
+			bar_group->request_window_for_editing_group(item_index);
+	}
+	catch(const std::bad_alloc& alloc_err){
+		fl_alert("Caught memory allocation error while requesting window for editing TaskGroup. (BarCanvas::right_mouse_click_callback())");
+	}
+	catch(const std::length_error& exceeded_max_alloc){
+		fl_alert("Exceeded maximum memory allocation while requesting window for editing TaskGroup. (BarCanvas::right_mouse_click_callback())");
+	}
+	catch(const std::exception& unspecified_excp){
+		const std::string msg = std::string("Caught unspecified exception while requesting window for editing TaskGroup. (BarCanvas::right_mouse_click_callback())\n")
+								+ unspecified_excp.what();
+		fl_alert(msg.c_str());
+	}
+	catch(...){
+		fl_alert("Caught unspecified throw while requesting window for editing TaskGroup. (BarCanvas::right_mouse_click_callback())");
+	}
+}
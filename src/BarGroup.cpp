@@ -13,31 +13,48 @@ You should have received a copy of the GNU General Public License along with Wor
 #include "BarGroup.hpp"
 
 #include "Bar.hpp"
+#include "BarCanvas.hpp"
 #include "MainWindow.hpp"
 
 #include "Task.hpp"
 #include "align.hpp"
 #include "task_io.hpp"
-#include "Timescale.hpp"
+#include "background_saver.hpp"
+#include "parse_diagnostics.hpp"
+#include "task_diff.hpp"
+#include "task_index.hpp"
+#include "task_journal.hpp"
+#include "task_snapshot.hpp"
+#include "task_store.hpp"
+#include "timescale.hpp"
 #include "time_calc.hpp"
 
 #include <FL/Fl.H>
 #include <FL/Fl_Box.H>
 #include <FL/Fl_Group.H>
+#include <FL/Fl_Scrollbar.H>
 
 #include <FL/fl_ask.H>
 #include <FL/fl_draw.H>
 
+#include <ios>
 #include <cmath>
 #include <vector>
 #include <memory>
+#include <utility>
 #include <string>
 #include <cstdint>
+#include <optional>
 #include <stdexcept>
 #include <algorithm>
 
 BarGroup::BarGroup(const int xpos, const int ypos, const int width, const int height)
 :	Fl_Group(xpos, ypos, width, height),
+	first_visible_row(0),
+	visible_row_count(0),
+	root_scroll_position(0),
+	laid_out_row_height(0),
+	laid_out_scroll_position(0),
 	task_group_id(this->not_in_any_group),			
 	current_date_label(xpos_center_by_point(this->date_label_width, this->current_date_line_xpos()), 
 						ypos_below(*this) - this->date_label_yraise, 
@@ -47,10 +64,16 @@ BarGroup::BarGroup(const int xpos, const int ypos, const int width, const int he
 						ypos_below(*this) - this->date_label_yraise, 
 						this->date_label_width, this->date_label_height
 	),
+	scrollbar(xpos + width - this->scrollbar_width, ypos, this->scrollbar_width, height),
+	canvas(xpos, ypos, width - this->scrollbar_width, height),
+	render_mode(RenderMode::Widgets),
 	current_timescale(timescale::default_timescale),
 	current_ymd(get_current_ymd()),	
 	next_interval(get_next_interval(this->current_ymd, this->current_timescale)),
-	unsaved_changes_made_to_tasks(false)
+	task_store(this->current_ymd),
+	unsaved_changes_made_to_tasks(false),
+	journal_in_sync(false),
+	task_file_stamp(std::make_shared<std::optional<task_snapshot::SourceStamp>>())
 {
 	this->end();
 	
@@ -62,9 +85,17 @@ BarGroup::BarGroup(const int xpos, const int ypos, const int width, const int he
 	
 	this->current_date_label.copy_label(ymd_to_string(this->current_ymd).c_str());
 	this->current_date_label.align(FL_ALIGN_CENTER | FL_ALIGN_INSIDE);
+	
+	//the bars of a row partly in view are drawn up to the edges of BarGroup.
+	this->clip_children(1);
+	this->scrollbar.type(FL_VERTICAL);
+	this->scrollbar.callback(BarGroup::scrollbar_callback);
+	this->scrollbar.hide();
+	this->canvas.hide();
 		
 	try{
 		this->load_tasks_to_bars();
+		this->journal_in_sync = true;
 	}
 	catch(const std::bad_alloc& alloc_err) {
 		fl_alert("Memory allocation error while loading tasks. (BarGroup::BarGroup(): std::bad_alloc)"
@@ -120,64 +151,83 @@ BarGroup::~BarGroup() noexcept{
 			fl_alert("Caught an unspecified throw while saving tasks to file. (BarGroup::~BarGroup())");			
 		}
 	}
+	
+	//The saves kept in the journal are folded into tasks.txt, so the programs reading tasks.txt see them once WorkTable is closed.
+	try{
+		parse_diagnostics::Collector diagnostics;
+		compact_task_file(&diagnostics);
+	}
+	catch(const std::exception& unspecified_excp){
+		const std::string msg = std::string("Caught an exception while folding the journal into tasks.txt, the saved changes are kept in tasks.journal.")
+								+ " (BarGroup::~BarGroup(): " + std::string(unspecified_excp.what()) + ")";
+		fl_alert(msg.c_str());
+	}
+	catch(...){
+		fl_alert("Caught an unspecified throw while folding the journal into tasks.txt, the saved changes are kept in tasks.journal. (BarGroup::~BarGroup())");
+	}
 }
 
 
 void BarGroup::add_task(const Task& task){
-	this->add_bar(task);
 	if(this->displaying_a_taskgroup()){
-		this->paged_taskgroups[this->task_group_id].tasks.push_back(task);
+		const TaskStore::GroupId viewed_group = this->root_groups[this->task_group_id];
+		this->add_bar(viewed_group, this->task_store.add_task(viewed_group, task));
+		this->unsaved_operations.push_back(task_journal::Operation::modify(this->get_taskgroup_index(this->task_group_id), this->task_store.taskgroup(viewed_group)));
+	}else{
+		//a single task is a group named after the task.
+		const TaskStore::GroupId group = this->task_store.add_group({std::string(task.name()), {task}});
+		this->root_groups.push_back(group);
+		this->add_bar(group, TaskStore::no_id);
+		this->unsaved_operations.push_back(task_journal::Operation::add(this->task_store.taskgroup(group)));
+		if(!this->root_slots.empty()) this->root_slots.push_back(std::nullopt);
 	}
 	
-	this->unsaved_changes_made_to_tasks = true;
-	this->redraw();
+	this->adjust_vertical_layout(this->rows.size() - 1);
+	this->mark_tasks_changed();
 }
 
-bool BarGroup::delete_bar(const int item_index){	
-	if(this->bars.size() <= std::abs(item_index))
-		return false;
-	
-	if(this->displaying_a_taskgroup()){
-		if(this->paged_taskgroups[this->task_group_id].tasks.size() <= std::abs(item_index))
-			return false;
-	}
-	
-	this->remove(this->bars[item_index].get());
-	
-	if(this->displaying_a_taskgroup()){
-		this->paged_taskgroups[this->task_group_id].tasks.erase(this->paged_taskgroups[this->task_group_id].tasks.begin() + item_index);
-	}
-	
-	this->bars.erase(this->bars.begin() + item_index);
-	this->unsaved_changes_made_to_tasks = true;
-	
-	this->adjust_vertical_layout();
-	this->redraw();
-	return true;
+bool BarGroup::delete_task(const TaskStore::TaskHandle& task){
+	const int_least64_t item_index = this->get_task_item_index(task);
+	if(item_index < 0) return false;
+	return this->delete_bar(item_index);
+}
+
+bool BarGroup::delete_group(const TaskStore::GroupHandle& group){
+	const int_least64_t item_index = this->get_group_item_index(group);
+	if(item_index < 0) return false;
+	return this->delete_bar(item_index);
 }
 
-void BarGroup::modify_task(const char* const task_name, const std::chrono::year_month_day& due_date, const int item_index){
-	const bool out_of_bounds_index = (item_index < 0) || (std::llabs(item_index) >= this->bars.size());
-	if(out_of_bounds_index)
+void BarGroup::modify_task(const char* const task_name, const std::chrono::year_month_day& due_date, const TaskStore::TaskHandle& task_handle){
+	const int_least64_t item_index = this->get_task_item_index(task_handle);
+	if(item_index < 0)
 		throw std::invalid_argument("BarGroup::modify_task(): invalid task index.");
-	bars[item_index]->update_task(task_name, due_date, this->get_days_from_interval(), this->x());		
+	
+	const TaskStore::TaskId task = task_handle.id;
+	this->task_store.set_task(task, due_date, task_name);
+	const TaskStore::GroupId group = this->task_store.group_of(task);
 	
 	if(this->displaying_a_taskgroup()){
-		this->paged_taskgroups[task_group_id].tasks[item_index] = bars[item_index]->get_single_task();
+		this->unsaved_operations.push_back(task_journal::Operation::modify(this->get_taskgroup_index(this->task_group_id), this->task_store.taskgroup(group)));
+	}else{
+		//a single task is a group named after the task.
+		this->task_store.rename_group(group, task_name);
+		this->unsaved_operations.push_back(task_journal::Operation::modify(this->get_taskgroup_index(item_index), this->task_store.taskgroup(group)));
 	}
+	this->refresh_bar(item_index);
 
-	this->unsaved_changes_made_to_tasks = true;
-	this->redraw();
+	this->mark_tasks_changed();
 }
 
-bool BarGroup::modify_group(const char* const group_name, const int item_index){
-	const bool out_of_bounds_index = (item_index < 0) || (std::llabs(item_index) >= this->bars.size());
-	if(out_of_bounds_index) return false;
+bool BarGroup::modify_group(const char* const group_name, const TaskStore::GroupHandle& group){
+	const int_least64_t item_index = this->get_group_item_index(group);
+	if(item_index < 0) return false;
 	
-	bars[item_index]->update_group_name(group_name);
+	this->task_store.rename_group(group.id, group_name);
+	this->refresh_bar(item_index);
+	this->unsaved_operations.push_back(task_journal::Operation::rename(this->get_taskgroup_index(item_index), group_name));
 
-	this->unsaved_changes_made_to_tasks = true;
-	this->redraw();	
+	this->mark_tasks_changed();
 	return true;
 }
 
@@ -187,7 +237,14 @@ bool BarGroup::request_window_for_editing_task(const Bar* const bar){
 	const bool invalid_item = item_index < 0;
 	if(invalid_item) return false;
 	
-	((MainWindow*)(this->parent()))->show_window_for_editing_task(bar->get_single_task(), item_index);
+	return this->request_window_for_editing_task(std::size_t(item_index));
+}
+
+bool BarGroup::request_window_for_editing_task(const std::size_t item_index){
+	if(item_index >= this->rows.size()) return false;
+	
+	const TaskStore::TaskId task = this->rows[item_index].task_ids().front();
+	((MainWindow*)(this->parent()))->show_window_for_editing_task(this->task_store.task(task), this->task_store.task_handle(task));
 	return true;
 }
 
@@ -196,7 +253,14 @@ bool BarGroup::request_window_for_editing_group(const Bar* const bar){
 	const bool invalid_item = item_index < 0;
 	if(invalid_item) return false;
 	
-	((MainWindow*)(this->parent()))->show_window_for_editing_group(bar->get_taskgroup().group_name, item_index);
+	return this->request_window_for_editing_group(std::size_t(item_index));
+}
+
+bool BarGroup::request_window_for_editing_group(const std::size_t item_index){
+	if(item_index >= this->rows.size()) return false;
+	
+	const TaskStore::GroupId group = this->rows[item_index].group;
+	((MainWindow*)(this->parent()))->show_window_for_editing_group(this->task_store.group_name(group), this->task_store.group_handle(group));
 	return true;
 }
 
@@ -206,116 +270,150 @@ void BarGroup::display_tasks_in_task_group(const Bar* const bar){
 	if(bar_index == -1)
 		throw std::invalid_argument("Invalid task index passed to BarGroup::display_tasks_in_task_group().");
 	
-	this->task_group_id = bar_index;
-	
-	this->paged_taskgroups.clear();
-	this->paged_taskgroups.reserve(this->bars.size());
+	this->display_tasks_in_task_group(std::size_t(bar_index));
+}
+
+void BarGroup::display_tasks_in_task_group(const std::size_t bar_index){
+	if(bar_index >= this->rows.size())
+		throw std::invalid_argument("Invalid task index passed to BarGroup::display_tasks_in_task_group().");
 	
-	for(const std::unique_ptr<Bar>& bar : this->bars){
-		this->paged_taskgroups.push_back(bar->get_taskgroup());
-		this->remove(bar.get());
-	}
+	this->task_group_id = bar_index;
+	const TaskStore::GroupId viewed_group = this->root_groups[bar_index];
 	
-	this->bars.clear();
+	this->root_scroll_position = this->scroll_position();
+	this->clear_bars();
 	
-	const std::size_t task_count = this->paged_taskgroups[bar_index].tasks.size();
-	for(std::size_t i = 0; i < task_count; ++i){
-		const Task task = this->paged_taskgroups[bar_index].tasks[i];
-		this->add_bar({task.name(), {task}}, task_count, i);
-	}
+	for(const TaskStore::TaskId task : this->task_store.group_tasks(viewed_group))
+		this->add_bar(viewed_group, task);
 	
+	//group view starts from the top.
+	this->scrollbar.value(0);
+	this->adjust_vertical_layout();
 	((MainWindow*)(this->parent()))->enable_taskgroup_button();
 	this->redraw();
 }
 
 void BarGroup::show_taskgroups(){
 	if(!(this->displaying_a_taskgroup())) return;
-	this->bars.clear();
+	this->clear_bars();
 	
-	const std::size_t taskgroup_count = this->paged_taskgroups.size();
-	std::vector<TaskGroup> non_empty_taskgroups; 
-	non_empty_taskgroups.reserve(taskgroup_count);
+	std::vector<TaskStore::GroupId> non_empty_groups; 
+	non_empty_groups.reserve(this->root_groups.size());
 	
-	for(const TaskGroup& taskgroup : this->paged_taskgroups){
-		const bool taskgroup_not_empty = taskgroup.tasks.size() != 0;
+	for(const TaskStore::GroupId group : this->root_groups){
+		const bool taskgroup_not_empty = !this->task_store.group_tasks(group).empty();
 		if(taskgroup_not_empty) 
-			non_empty_taskgroups.push_back(taskgroup);
+			non_empty_groups.push_back(group);
+		else{
+			//the groups after the dropped ones move down in the list of the journal as well.
+			const std::size_t taskgroup_index = this->get_taskgroup_index(non_empty_groups.size());
+			this->unsaved_operations.push_back(task_journal::Operation::erase(taskgroup_index));
+			if(!this->root_slots.empty()) this->root_slots.erase(this->root_slots.begin() + taskgroup_index);
+			this->task_store.erase_group(group);
+		}
 	}
+	this->root_groups = std::move(non_empty_groups);
 	
-	const std::size_t non_empty_taskgroup_count = non_empty_taskgroups.size();
-	for(std::size_t i = 0; i < non_empty_taskgroup_count; i++){
-		this->add_bar(non_empty_taskgroups[i], non_empty_taskgroup_count, i);
-	}
+	for(const TaskStore::GroupId group : this->root_groups)
+		this->add_bar(group, TaskStore::no_id);
 
-	this->paged_taskgroups.clear();
 	this->task_group_id = not_in_any_group;
 	
+	//back to where root view was scrolled to before shifting to group view.
+	this->scrollbar.value(this->root_scroll_position);
+	this->adjust_vertical_layout();
+	//the timescale may have been widened while in group view.
+	this->load_due_taskgroups();
 	this->redraw();
 }
 
 
 void BarGroup::save_tasks_to_file(){
-	std::vector<TaskGroup> taskgroups;
-	
-	if(this->task_group_id != not_in_any_group){
-		taskgroups = this->paged_taskgroups;
-	}else{
-		taskgroups.reserve(this->bars.size());
-		for(const std::unique_ptr<Bar>& bar : this->bars)
-			taskgroups.emplace_back(bar->get_taskgroup());	
+	const BackgroundSaver::Job save_job = this->take_save_job();
+	try{
+		save_job();
 	}
-	
-	overwrite_taskfile(taskgroups);
-	this->unsaved_changes_made_to_tasks = false;
+	catch(...){
+		this->handle_failed_save();
+		throw;
+	}
+}
+
+void BarGroup::save_tasks_to_file(BackgroundSaver& saver){
+	saver.submit(this->take_save_job());
+}
+
+void BarGroup::handle_task_file_changed(){
+	//The journal is continued from the task file it was started with, which the edits kept here are no longer made to.
+	this->journal_in_sync = false;
+}
+
+void BarGroup::handle_failed_save(){
+	//What the failed save managed to write is unknown, so the next save rewrites the entire task file.
+	this->journal_in_sync = false;
+	this->unsaved_changes_made_to_tasks = true;
 }
 
 void BarGroup::revert_to_tasks_from_file(){
-	std::vector<TaskGroup> task_groups;
-	
 	try{
-		task_groups = get_tasks();
+		this->load_tasks_to_bars();
 	}
 	catch(const std::ios_base::failure& file_io_error) {throw;}
 	catch(const std::runtime_error& file_not_opened) {throw;}	
-	
-	for(std::unique_ptr<Bar>& bar_uniptr : this->bars){
-		this->remove(bar_uniptr.get());
-		bar_uniptr.release();
-	}
-	this->bars.clear();
-	
-	const auto taskgroup_count = task_groups.size();
-	
-	for(std::size_t i = 0; i < taskgroup_count; ++i)
-		this->add_bar(task_groups[i], taskgroup_count, i);	
 
+	this->unsaved_operations.clear();
+	this->journal_in_sync = true;
 	this->unsaved_changes_made_to_tasks = false;
 }
 
 
 void BarGroup::handle_bar_mouse_button_release(const Bar* const clicked_bar){
+	const int_least64_t clicked_item_index = this->get_item_index(clicked_bar);
+	if(clicked_item_index < 0){
+		this->signal_hide_root_group_box();
+		return;
+	}
+	this->handle_bar_mouse_button_release(std::size_t(clicked_item_index));
+}
+
+void BarGroup::handle_bar_mouse_button_release(const std::size_t clicked_item_index){
 	this->signal_hide_root_group_box();	
+	if(clicked_item_index >= this->rows.size()) return;
+	const BarTasks clicked_row = this->rows[clicked_item_index];
 	
 	const bool move_task_to_rootgroup = this->check_mouse_released_in_root_group_box() && this->displaying_a_taskgroup();
 	if(move_task_to_rootgroup){
-		this->paged_taskgroups.emplace_back(clicked_bar->get_taskgroup());
-		const int clicked_bar_index  = this->get_item_index(clicked_bar);
-		this->delete_bar(clicked_bar_index);
-		this->redraw();
+		//the task keeps its ID, it is moved to a group of its own named after it.
+		const TaskStore::TaskId task = clicked_row.task;
+		const TaskStore::GroupId group = this->task_store.add_group({std::string(this->task_store.name(task)), {}});
+		this->task_store.move_task(task, group);
+		this->root_groups.push_back(group);
+		
+		this->unsaved_operations.push_back(task_journal::Operation::add(this->task_store.taskgroup(group)));
+		if(!this->root_slots.empty()) this->root_slots.push_back(std::nullopt);
+		this->unsaved_operations.push_back(task_journal::Operation::modify(this->get_taskgroup_index(this->task_group_id), this->task_store.taskgroup(clicked_row.group)));
+		
+		this->remove_bar(clicked_item_index);
+		this->mark_tasks_changed();
+		this->adjust_vertical_layout(clicked_item_index);
 		return;
 	}
 	
 	const bool possible_taskgroup_merge = !(this->displaying_a_taskgroup());
 	if(possible_taskgroup_merge){
-		for(const std::unique_ptr<Bar>& bar_at_rootgroup : bars)
-		{
-			const bool mouse_button_released_in_taskgroup = Fl::event_inside(bar_at_rootgroup.get());
-			if(mouse_button_released_in_taskgroup){
-				bar_at_rootgroup->merge_taskgroup(clicked_bar->get_taskgroup());
-				this->delete_bar(this->get_item_index(clicked_bar));
-				this->redraw();
-				break;
-			}
+		//the bars are stacked in order, so the one the mouse was released in is found from the position.
+		const int_least64_t released_item_index = this->get_item_index_at(Fl::event_x(), Fl::event_y());
+		
+		const bool mouse_button_released_in_taskgroup = (released_item_index >= 0) && (std::size_t(released_item_index) != clicked_item_index);
+		if(mouse_button_released_in_taskgroup){
+			const TaskStore::GroupId group = this->rows[released_item_index].group;
+			//a single task has no group name of its own yet.
+			if(this->row_is_single_task(released_item_index)) this->task_store.rename_group(group, this->task_store.name(this->task_store.group_tasks(group).front()));
+			this->task_store.merge_groups(group, clicked_row.group);
+			this->refresh_bar(released_item_index);
+			
+			this->unsaved_operations.push_back(task_journal::Operation::modify(this->get_taskgroup_index(released_item_index), this->task_store.taskgroup(group)));
+			this->delete_bar(clicked_item_index);
 		}
 	}
 }
@@ -343,6 +441,11 @@ int BarGroup::xpos_right_of_interval_date_label() const{
 }
 
 
+void BarGroup::mark_tasks_changed(){
+	this->unsaved_changes_made_to_tasks = true;
+	((MainWindow*)(this->parent()))->handle_tasks_changed();
+}
+
 bool BarGroup::has_unsaved_changes_to_tasks() const{
 	return this->unsaved_changes_made_to_tasks;
 }
@@ -358,6 +461,30 @@ Timescale BarGroup::zoomout_timescale(){
 	return this->change_timescale(new_timescale);
 }
 
+void BarGroup::set_render_mode(const RenderMode render_mode){
+	this->render_mode = render_mode;
+	if(render_mode == RenderMode::Canvas)
+		this->canvas.show();
+	else
+		this->canvas.hide();
+	
+	this->layout_rows();
+	this->redraw();
+}
+
+const char* BarGroup::render_mode_name(const RenderMode render_mode) noexcept{
+	switch(render_mode){
+		case RenderMode::Widgets:
+		return "Widgets";
+		
+		case RenderMode::Canvas:
+		return "Canvas";
+		
+		default:
+		return "Unknown";
+	}
+}
+
 
 
 //protected:
@@ -375,72 +502,458 @@ void BarGroup::draw(){
 	);
 }
 
+int BarGroup::handle(const int event){
+	if(event == FL_MOUSEWHEEL && this->scrollbar.visible())
+		return this->scrollbar.handle(event);
+	return Fl_Group::handle(event);
+}
+
 
 //private:
 void BarGroup::load_tasks_to_bars(){
 	std::vector<TaskGroup> task_groups;
+	std::optional<task_index::LazyTaskFile> lazy_task_file;
+	//taken before reading, so a change made while reading fails the next journal save rather than being saved over.
+	const std::optional<task_snapshot::SourceStamp> loaded_stamp = task_snapshot::get_source_stamp("tasks.txt");
 	
 	try{
-		task_groups = get_tasks();
+		if(should_load_lazily())
+			lazy_task_file = get_tasks_lazily(task_io_internal::default_nested_group_callback, &this->load_diagnostics);
+		else
+			task_groups = get_tasks_parallel(default_parse_thread_count(), task_io_internal::default_nested_group_callback, &this->load_diagnostics);
 	}
 	catch(const std::ios_base::failure& file_io_error) {throw;}
 	catch(const std::runtime_error& file_not_opened) {throw;}
+	this->task_file_stamp = std::make_shared<std::optional<task_snapshot::SourceStamp>>(loaded_stamp);
+	
+	//Every group is loaded before and after, so only the bars of the groups which changed are replaced.
+	if(!lazy_task_file && this->root_slots.empty()){
+		this->apply_changed_taskgroups(task_groups);
+		this->show_load_diagnostics();
+		return;
+	}
+	
+	this->clear_bars();
+	this->root_groups.clear();
+	this->task_store.clear();
+	this->root_slots.clear();
+	this->unloaded_task_file.clear();
+	
+	if(lazy_task_file){
+		//The groups loaded by replaying the journal are constructed as bars, the others wait for load_due_taskgroups().
+		this->root_slots.reserve(lazy_task_file->taskgroups.size());
+		for(task_index::LazyTaskGroup& lazy_taskgroup : lazy_task_file->taskgroups){
+			if(lazy_taskgroup.taskgroup){
+				task_groups.push_back(std::move(*lazy_taskgroup.taskgroup));
+				this->root_slots.push_back(std::nullopt);
+			}else{
+				this->root_slots.push_back(lazy_taskgroup.span);
+			}
+		}
+		this->unloaded_task_file = std::move(lazy_task_file->text);
+	}
 
-	const auto task_count = task_groups.size();	
-	for(decltype(task_groups.size()) i = 0; i < task_count; ++i)
-		this->add_bar(task_groups[i], task_count, i);
+	this->root_groups.reserve(task_groups.size());
+	this->rows.reserve(task_groups.size());
+	for(const TaskGroup& taskgroup : task_groups){
+		this->root_groups.push_back(this->task_store.add_group(taskgroup));
+		this->add_bar(this->root_groups.back(), TaskStore::no_id);
+	}
+	
+	this->scrollbar.value(0);
+	this->adjust_vertical_layout();
+	this->load_due_taskgroups();
+	this->redraw();
 }
 
+void BarGroup::load_due_taskgroups(){
+	if(this->root_slots.empty() || this->displaying_a_taskgroup()) return;
+	
+	const std::chrono::sys_days next_interval_days(this->next_interval);
+	std::size_t bar_index = 0;
+	std::size_t first_loaded_item_index = this->no_row;
+	bool all_loaded = true;
+	
+	for(std::optional<task_index::Span>& slot : this->root_slots){
+		if(!slot){
+			bar_index++;
+			continue;
+		}
+		if(!task_index::due_by(*slot, next_interval_days)){
+			all_loaded = false;
+			continue;
+		}
+		
+		this->insert_bar(task_index::load(this->unloaded_task_file, *slot, task_io_internal::default_nested_group_callback, &this->load_diagnostics), bar_index);
+		first_loaded_item_index = std::min(first_loaded_item_index, bar_index);
+		slot.reset();
+		bar_index++;
+	}
+	
+	//Every group is loaded, BarGroup goes on as if the task file was loaded entirely.
+	if(all_loaded){
+		this->root_slots.clear();
+		this->unloaded_task_file = std::string();
+	}
+	
+	//the rows before the first loaded one stay where they are.
+	this->adjust_vertical_layout(std::min(first_loaded_item_index, this->rows.size()));
+	this->show_load_diagnostics();
+}
 
-void BarGroup::add_bar(const TaskGroup& taskgroup, const int total_items, const int item_index){
-	Bar* bar;
-	try{
-		bar = new Bar(BarConstructorArgs(this, taskgroup, total_items, item_index));
-		this->bars.emplace_back(bar);		
+void BarGroup::apply_changed_taskgroups(const std::vector<TaskGroup>& taskgroups){
+	const std::vector<TaskGroup> displayed_taskgroups = this->task_store.taskgroups(this->root_groups);
+	
+	//compared as kept by TaskStore, which sorts the tasks of a group.
+	std::vector<TaskGroup> sorted_taskgroups = taskgroups;
+	for(TaskGroup& taskgroup : sorted_taskgroups)
+		std::stable_sort(taskgroup.tasks.begin(), taskgroup.tasks.end(), Task::due_date_is_earlier);
+	
+	const std::vector<task_diff::Change> changes = task_diff::diff(displayed_taskgroups, sorted_taskgroups);
+	const bool layout_changed = displayed_taskgroups.size() != taskgroups.size();
+	
+	for(const task_diff::Change& change : changes){
+		if(change.type != task_diff::Change::Type::Insert){
+			this->remove_bar(change.index);
+			this->task_store.erase_group(this->root_groups[change.index]);
+			this->root_groups.erase(this->root_groups.begin() + change.index);
+		}
+		if(change.type != task_diff::Change::Type::Remove)
+			this->insert_bar(taskgroups[change.new_index], change.index);
 	}
-	catch(const std::bad_alloc& alloc_err) {throw alloc_err;}
-	catch(const std::length_error& exceeded_max_alloc) {throw exceeded_max_alloc;}
 	
-	this->add(bar);
+	if(layout_changed){
+		//the rows before the first change stay where they are, unless the rows were resized.
+		std::size_t first_changed_item_index = this->rows.size();
+		for(const task_diff::Change& change : changes)
+			first_changed_item_index = std::min(first_changed_item_index, change.index);
+		this->adjust_vertical_layout(first_changed_item_index);
+		return;
+	}
+	
+	//only the bars of the replaced rows are drawn again, as the other rows stay where they are.
+	//A replaced group may reuse the ID of the one it replaced, which leaves its Bar bound to the same tasks.
+	this->layout_rows();
+	for(const task_diff::Change& change : changes)
+		this->refresh_bar(change.index);
 }
 
-void BarGroup::add_bar(const Task& task){
-	//kinda verbose, but without these lines, it would be pretty confusing.
-	const auto incremented_bar_count = bars.size() + 1;
-	const auto incremented_item_index = incremented_bar_count - 1;
+std::size_t BarGroup::get_taskgroup_index(const std::size_t item_index) const{
+	if(this->root_slots.empty()) return item_index;
 	
-	try{
-		this->add_bar({task.name(), {task}}, incremented_bar_count, incremented_item_index);
+	std::size_t loaded_count = 0;
+	for(std::size_t i = 0; i < this->root_slots.size(); ++i){
+		if(this->root_slots[i]) continue;
+		if(loaded_count == item_index) return i;
+		loaded_count++;
 	}
-	catch(const std::bad_alloc& alloc_err) {throw alloc_err;}
-	catch(const std::length_error& exceeded_max_alloc) {throw exceeded_max_alloc;}
+	//the index past the last loaded group, such as for a group being added.
+	return this->root_slots.size();
+}
 
-	this->adjust_vertical_layout();
+std::vector<TaskGroup> BarGroup::get_all_taskgroups() const{
+	//the group being viewed is in this->root_groups as well, so both views are saved the same.
+	std::vector<TaskGroup> loaded_taskgroups = this->task_store.taskgroups(this->root_groups);
+	if(this->root_slots.empty()) return loaded_taskgroups;
+	
+	std::vector<TaskGroup> taskgroups;
+	taskgroups.reserve(this->root_slots.size());
+	
+	std::size_t loaded_index = 0;
+	for(const std::optional<task_index::Span>& slot : this->root_slots){
+		if(slot)
+			taskgroups.push_back(task_index::load(this->unloaded_task_file, *slot, task_io_internal::default_nested_group_callback, &this->load_diagnostics));
+		else
+			taskgroups.push_back(std::move(loaded_taskgroups[loaded_index++]));
+	}
+	
+	return taskgroups;
+}
+
+void BarGroup::show_load_diagnostics(){
+	if(this->load_diagnostics.empty()) return;
+	
+	const std::string msg = parse_diagnostics::summary(this->load_diagnostics);
+	this->load_diagnostics.clear();
+	fl_alert(msg.c_str());
 }
 
 
-int_least64_t BarGroup::get_item_index(const Bar* const bar) const{
-	const auto bar_count = this->bars.size();
+void BarGroup::add_bar(const TaskStore::GroupId group, const TaskStore::TaskId task){
+	this->rows.push_back(BarTasks{&this->task_store, group, task});
+	
+	std::vector<std::size_t>& row_slots = (task == TaskStore::no_id) ? this->group_rows : this->task_rows;
+	const std::uint32_t id = (task == TaskStore::no_id) ? group : task;
+	if(row_slots.size() <= id) row_slots.resize(std::size_t(id) + 1, this->no_row);
+	row_slots[id] = this->rows.size() - 1;
+}
+
+void BarGroup::insert_bar(const TaskGroup& taskgroup, const std::size_t item_index){
+	const TaskStore::GroupId group = this->task_store.add_group(taskgroup);
+	this->root_groups.insert(this->root_groups.begin() + item_index, group);
+	
+	this->add_bar(group, TaskStore::no_id);
+	//add_bar() appends the row, it is moved to its place.
+	std::rotate(this->rows.begin() + item_index, this->rows.end() - 1, this->rows.end());
+	this->renumber_bars(item_index);
+}
+
+bool BarGroup::delete_bar(const int item_index){	
+	if(this->rows.size() <= std::abs(item_index))
+		return false;
+	
+	const BarTasks& row = this->rows[item_index];
+	if(this->displaying_a_taskgroup()){
+		this->task_store.erase_task(row.task);
+		this->unsaved_operations.push_back(task_journal::Operation::modify(this->get_taskgroup_index(this->task_group_id), this->task_store.taskgroup(row.group)));
+	}else{
+		const std::size_t taskgroup_index = this->get_taskgroup_index(item_index);
+		this->unsaved_operations.push_back(task_journal::Operation::erase(taskgroup_index));
+		if(!this->root_slots.empty()) this->root_slots.erase(this->root_slots.begin() + taskgroup_index);
+		
+		this->task_store.erase_group(row.group);
+		this->root_groups.erase(this->root_groups.begin() + item_index);
+	}
+	
+	this->remove_bar(item_index);
+	this->mark_tasks_changed();
+	
+	this->adjust_vertical_layout(item_index);
+	return true;
+}
+
+void BarGroup::remove_bar(const std::size_t item_index){
+	const BarTasks& row = this->rows[item_index];
+	if(row.task == TaskStore::no_id)
+		this->group_rows[row.group] = this->no_row;
+	else
+		this->task_rows[row.task] = this->no_row;
 	
-	for(decltype(this->bars.size()) i = 0; i < bar_count; ++i){
-		if (bar == this->bars[i].get()) return i;
+	this->rows.erase(this->rows.begin() + item_index);
+	this->renumber_bars(item_index);
+}
+
+void BarGroup::clear_bars(){
+	this->rows.clear();
+	this->group_rows.clear();
+	this->task_rows.clear();
+	this->layout_rows();
+}
+
+void BarGroup::renumber_bars(const std::size_t first_item_index){
+	for(std::size_t i = first_item_index; i < this->rows.size(); ++i){
+		const BarTasks& row = this->rows[i];
+		if(row.task == TaskStore::no_id)
+			this->group_rows[row.group] = i;
+		else
+			this->task_rows[row.task] = i;
+	}
+}
+
+void BarGroup::refresh_bar(const std::size_t item_index){
+	const bool row_in_view = (item_index >= this->first_visible_row) && (item_index - this->first_visible_row < this->visible_row_count);
+	if(!row_in_view) return;
+	
+	//the entire row is drawn again rather than the Bar, as the Bar may become narrower, and its previous label may have been wider than it.
+	this->damage_rows(item_index, item_index + 1);
+	
+	//this->canvas draws the row from this->task_store, so only a Bar has to be updated.
+	Bar* const bar = this->get_bar(item_index);
+	if(bar != nullptr) bar->refresh(this->get_days_from_interval(), this->x());
+}
+
+void BarGroup::damage_rows(const std::size_t first_item_index, const std::size_t last_item_index){
+	const std::int_least64_t row_height = this->row_height();
+	const std::int_least64_t rows_ypos = std::int_least64_t(this->y()) - this->scroll_position();
+	
+	const std::int_least64_t damage_ypos = std::max(rows_ypos + row_height * std::int_least64_t(first_item_index), std::int_least64_t(this->y()));
+	std::int_least64_t damage_ypos_below = ypos_below(*this);
+	if(last_item_index != this->no_row) 
+		damage_ypos_below = std::min(rows_ypos + row_height * std::int_least64_t(last_item_index), damage_ypos_below);
+	
+	if(damage_ypos >= damage_ypos_below) return;
+	this->damage(FL_DAMAGE_ALL, this->x(), damage_ypos, this->w(), damage_ypos_below - damage_ypos);
+}
+
+Bar* BarGroup::get_bar(const std::size_t item_index) const{
+	if(this->render_mode != RenderMode::Widgets) return nullptr;
+	if(item_index < this->first_visible_row || item_index - this->first_visible_row >= this->visible_row_count) return nullptr;
+	return this->bars[item_index - this->first_visible_row].get();
+}
+
+
+BackgroundSaver::Job BarGroup::take_save_job(){
+	//Only the group being viewed can be left without tasks, which is dropped once the task file is loaded.
+	const bool viewed_taskgroup_is_empty = this->displaying_a_taskgroup() && this->task_store.group_tasks(this->root_groups[this->task_group_id]).empty();
+	const bool append_to_journal = this->journal_in_sync && !viewed_taskgroup_is_empty 
+									&& !task_journal::should_compact(task_journal_filename, "tasks.txt");
+	
+	BackgroundSaver::Job save_job;
+	if(append_to_journal){
+		save_job = [operations = task_journal::coalesce(std::move(this->unsaved_operations)), loaded_stamp = this->task_file_stamp](){
+			//left empty if the save rewriting tasks.txt before this one could not get the stamp of what it wrote.
+			if(!*loaded_stamp) 
+				throw std::ios_base::failure("BarGroup.cpp: the version of tasks.txt the changes were made to is unknown.");
+			task_journal::append(operations, task_journal_filename, "tasks.txt", **loaded_stamp);
+			return std::nullopt;
+		};
+	}else{
+		//the groups not loaded yet are parsed here rather than on the worker thread, as the errors found are displayed in a window.
+		this->task_file_stamp = std::make_shared<std::optional<task_snapshot::SourceStamp>>();
+		save_job = [taskgroups = this->get_all_taskgroups(), written_stamp = this->task_file_stamp](){
+			write_taskfile(taskgroups);
+			*written_stamp = task_snapshot::get_source_stamp("tasks.txt");
+			return *written_stamp;
+		};
+		this->journal_in_sync = !viewed_taskgroup_is_empty;
+		this->show_load_diagnostics();
 	}
+	
+	this->unsaved_operations.clear();
+	this->unsaved_changes_made_to_tasks = false;
+	return save_job;
+}
+
+int_least64_t BarGroup::get_item_index(const Bar* const bar) const{
+	const std::size_t item_index = bar->get_item_index();
+	if(this->get_bar(item_index) == bar) return item_index;
 	return -1;
 }
 
+int_least64_t BarGroup::get_task_item_index(const TaskStore::TaskHandle& task_handle) const{
+	//a reload may have erased the task while a window held on to it, and its ID may be of another task since.
+	const TaskStore::TaskId task = this->task_store.find_task(task_handle);
+	if(task == TaskStore::no_id) return -1;
+	
+	std::size_t item_index = this->no_row;
+	if(this->displaying_a_taskgroup()){
+		if(task < this->task_rows.size()) item_index = this->task_rows[task];
+	}
+	//in root view, a task has a row of its own if it is the only task of its group.
+	else{
+		const TaskStore::GroupId group = this->task_store.group_of(task);
+		if(group < this->group_rows.size() && this->task_store.group_tasks(group).size() == 1) item_index = this->group_rows[group];
+	}
+	
+	if(item_index == this->no_row) return -1;
+	return item_index;
+}
+
+int_least64_t BarGroup::get_group_item_index(const TaskStore::GroupHandle& group_handle) const{
+	const TaskStore::GroupId group = this->task_store.find_group(group_handle);
+	if(group == TaskStore::no_id || this->displaying_a_taskgroup() || group >= this->group_rows.size() || this->group_rows[group] == this->no_row) return -1;
+	return this->group_rows[group];
+}
+
+int_least64_t BarGroup::get_item_index_at(const int ypos) const{
+	if(this->rows.empty() || ypos < this->y()) return -1;
+	
+	const int row_height = this->row_height();
+	if(row_height <= 0) return -1;
+	
+	const std::size_t item_index = (std::int_least64_t(ypos) - this->y() + this->scroll_position()) / row_height;
+	if(item_index >= this->rows.size()) return -1;
+	return item_index;
+}
+
+int_least64_t BarGroup::get_item_index_at(const int xpos, const int ypos) const{
+	const int_least64_t item_index = this->get_item_index_at(ypos);
+	if(item_index < 0) return -1;
+	
+	//the position may be in the spacing below the Bar of the row, or right of it.
+	const int bar_ypos = this->row_ypos(item_index);
+	if(ypos >= bar_ypos + Bar::calc_height(this->row_height())) return -1;
+	
+	const BarSpan span = Bar::calc_span(this->rows[item_index], this->get_days_from_interval(), this->x());
+	if(xpos < span.xpos || xpos >= span.xpos + span.width) return -1;
+	return item_index;
+}
+
+
+int BarGroup::row_height() const{
+	if(this->rows.empty()) return this->h();
+	return std::max(Bar::calc_height_with_yspacing(this->h(), this->rows.size()), int(this->min_row_height));
+}
+
+int BarGroup::row_ypos(const std::size_t item_index) const{
+	return Bar::calc_ypos(this->y() - this->scroll_position(), this->row_height(), item_index);
+}
+
+int BarGroup::scroll_position() const{
+	return this->scrollbar.visible() ? this->scrollbar.value() : 0;
+}
+
+void BarGroup::adjust_vertical_layout(const std::size_t first_changed_item_index){
+	const int previous_row_height = this->laid_out_row_height;
+	const int previous_scroll_position = this->laid_out_scroll_position;
+	
+	const int row_height = this->row_height();
+	const std::int_least64_t rows_height = std::int_least64_t(row_height) * this->rows.size();
+	
+	if(rows_height > this->h()){
+		const int max_scroll_position = rows_height - this->h();
+		this->scrollbar.value(std::min(this->scrollbar.value(), max_scroll_position), this->h(), 0, rows_height);
+		this->scrollbar.linesize(row_height);
+		this->scrollbar.show();
+	}else{
+		this->scrollbar.value(0);
+		this->scrollbar.hide();
+	}
+	
+	this->layout_rows();
+	
+	if(this->laid_out_row_height != previous_row_height || this->laid_out_scroll_position != previous_scroll_position)
+		this->redraw();
+	else
+		this->damage_rows(first_changed_item_index, this->no_row);
+}
 
-void BarGroup::adjust_vertical_layout(){
-	const std::size_t bar_count = this->bars.size();
+void BarGroup::layout_rows(){
+	const int row_height = this->row_height();
+	const int scroll_position = this->scroll_position();
+	this->laid_out_row_height = row_height;
+	this->laid_out_scroll_position = scroll_position;
 	
-	const int bar_height = Bar::calc_height(this->h(), bar_count);
-	const int bar_height_with_yspacing = Bar::calc_height_with_yspacing(this->h(), bar_count);
+	this->first_visible_row = std::min(std::size_t(scroll_position / row_height), this->rows.size());
+	//a row partly in view at the top and one at the bottom are in view as well.
+	const std::size_t rows_in_view = std::size_t(this->h() / row_height) + 2;
+	this->visible_row_count = std::min(rows_in_view, this->rows.size() - this->first_visible_row);
 	
-	for(std::size_t i = 0; i < bar_count; ++i){
-		const std::unique_ptr<Bar>& bar = this->bars[i];
+	if(this->render_mode == RenderMode::Canvas){
+		for(const std::unique_ptr<Bar>& bar : this->bars) bar->hide();
+		return;
+	}
+	
+	const int bar_height = Bar::calc_height(row_height);
+	const std::chrono::days days_from_interval = this->get_days_from_interval();
+	
+	for(std::size_t i = 0; i < this->visible_row_count; ++i){
+		const std::size_t item_index = this->first_visible_row + i;
+		const BarTasks& row = this->rows[item_index];
+		
+		if(i == this->bars.size()){
+			try{
+				this->bars.emplace_back(new Bar(BarConstructorArgs(this, row, this->rows.size(), item_index)));
+			}
+			catch(const std::bad_alloc& alloc_err) {throw alloc_err;}
+			catch(const std::length_error& exceeded_max_alloc) {throw exceeded_max_alloc;}
+			this->add(this->bars.back().get());
+		}
 		
-		const int bar_ypos = Bar::calc_ypos(this->y(), bar_height_with_yspacing, i);
+		Bar* const bar = this->bars[i].get();
+		if(!bar->visible() || bar->get_item_index() != item_index || !(bar->get_tasks() == row)){
+			//the Bar may become narrower, so the area it was drawn in is drawn again as well.
+			if(bar->visible()) this->damage(FL_DAMAGE_ALL, bar->x(), bar->y(), bar->w(), bar->h());
+			bar->rebind(row, item_index, days_from_interval, this->x());
+			bar->show();
+		}
+		
+		const int bar_ypos = Bar::calc_ypos(this->y() - scroll_position, row_height, item_index);
 		bar->resize(bar->x(), bar_ypos, bar->w(), bar_height);
 	}
+	
+	for(std::size_t i = this->visible_row_count; i < this->bars.size(); ++i)
+		this->bars[i]->hide();
 }
 
 Timescale BarGroup::change_timescale(const Timescale timescale){
@@ -459,9 +972,13 @@ Timescale BarGroup::change_timescale(const Timescale timescale){
 	
 	this->current_timescale = timescale;
 	
-	for(std::unique_ptr<Bar>& bar : bars)
-		bar->update_width(get_days_from_interval(), this->x());
+	//the rows out of view have their widths updated once they are bound to a Bar, and this->canvas lays out the rows as it draws them.
+	if(this->render_mode == RenderMode::Widgets){
+		for(std::size_t i = 0; i < this->visible_row_count; ++i)
+			this->bars[i]->update_width(get_days_from_interval(), this->x());
+	}
 	
+	this->load_due_taskgroups();
 	this->redraw();
 	return timescale;
 }
@@ -477,4 +994,12 @@ int BarGroup::next_interval_date_line_xpos() const{
 
 bool BarGroup::check_mouse_released_in_root_group_box(){
 	return ((MainWindow*)(this->parent()))->mouse_released_in_root_group_box();
+}
+
+
+//static private
+void BarGroup::scrollbar_callback(Fl_Widget* const self_ptr, void* const data){
+	BarGroup* const bar_group = (BarGroup*)(self_ptr->parent());
+	bar_group->layout_rows();
+	bar_group->redraw();
 }
\ No newline at end of file
@@ -12,6 +12,9 @@ You should have received a copy of the GNU General Public License along with Wor
 
 #include "MainWindow.hpp"
 #include "BarGroup.hpp"
+#include "autosave.hpp"
+#include "file_watch.hpp"
+#include "background_saver.hpp"
 
 #include "TaskGroupWindow.hpp"
 #include "TaskPropertiesWindow.hpp"
@@ -23,9 +26,15 @@ You should have received a copy of the GNU General Public License along with Wor
 #include<FL/Fl_Box.H>
 #include<FL/Fl_Button.H>
 #include<FL/Fl_Window.H>
+#include<FL/Fl_Light_Button.H>
 
 #include <FL/fl_ask.h>
 
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+
 MainWindow::MainWindow(const int xpos, const int ypos, const int width, const int height, const char* window_title)
 :	Fl_Window(xpos, ypos, width, height, window_title),
 	task_properties_window(TaskPropertiesWindow::width, TaskPropertiesWindow::height, this
@@ -62,7 +71,17 @@ MainWindow::MainWindow(const int xpos, const int ypos, const int width, const in
 	),
 	root_group_box(
 		0, 0, this->bar_group.x(), height, "Drop task here to move it out from group."
-	)
+	),
+	autosave_button(
+		xpos_right_of(taskgroup_button) + 10, ypos_below(bar_group),
+		MainWindow::autosave_button_width, MainWindow::button_height, "Autosave"
+	),
+	save_status_box(
+		xpos_right_of(autosave_button) + 10, ypos_below(bar_group),
+		MainWindow::save_status_box_width, MainWindow::button_height
+	),
+	task_file_watcher("tasks.txt"),
+	saver(MainWindow::save_finished_callback, this)
 {		
 	this->timescale_text_box.align(FL_ALIGN_INSIDE | FL_ALIGN_RIGHT);
 	this->timescale_text_box.label(timescale::get_timescale_str(timescale::default_timescale));
@@ -72,6 +91,7 @@ MainWindow::MainWindow(const int xpos, const int ypos, const int width, const in
 	this->save_button.callback(MainWindow::save_button_callback);	
 	this->discard_button.callback(MainWindow::discard_button_callback);	
 	this->taskgroup_button.callback(MainWindow::taskgroup_button_callback);	
+	this->autosave_button.callback(MainWindow::autosave_button_callback);
 	
 	this->zoomin_button.callback(MainWindow::zoomin_button_callback);
 	this->zoomout_button.callback(MainWindow::zoomout_button_callback);
@@ -102,6 +122,13 @@ MainWindow::MainWindow(const int xpos, const int ypos, const int width, const in
 	this->root_group_box.labelfont(FL_HELVETICA_BOLD);		
 	this->root_group_box.hide();
 	
+	this->autosave_button.color(fl_rgb_color(230));
+	this->autosave_button.labelcolor(fl_rgb_color(100));
+	this->autosave_button.box(FL_FLAT_BOX);
+	
+	this->save_status_box.align(FL_ALIGN_INSIDE | FL_ALIGN_LEFT);
+	this->save_status_box.labelcolor(fl_rgb_color(100));
+	
 	//We start in root view, so this button should be deactivated.
 	this->taskgroup_button.deactivate();
 	
@@ -124,8 +151,25 @@ MainWindow::MainWindow(const int xpos, const int ypos, const int width, const in
 	this->add(this->zoomout_button);
 	this->add(this->timescale_text_box);
 	this->add(this->root_group_box);
+	this->add(this->autosave_button);
+	this->add(this->save_status_box);
 	
 	this->color(FL_WHITE);
+	
+	if(this->task_file_watcher.fd() != -1)
+		Fl::add_fd(this->task_file_watcher.fd(), FL_READ, MainWindow::task_file_changed_callback, this);
+	else
+		Fl::add_timeout(FileWatcher::poll_interval, MainWindow::task_file_poll_callback, this);
+}
+
+MainWindow::~MainWindow(){
+	Fl::remove_timeout(MainWindow::autosave_timeout_callback, this);
+	if(this->task_file_watcher.fd() != -1)
+		Fl::remove_fd(this->task_file_watcher.fd());
+	else
+		Fl::remove_timeout(MainWindow::task_file_poll_callback, this);
+	this->saver.wait_until_idle();
+	this->show_save_results();
 }
 
 //public
@@ -133,18 +177,22 @@ void MainWindow::add_task(const Task& task){
 	this->bar_group.add_task(task);	
 }
 
-bool MainWindow::delete_bar(const int item_index){
-	return this->bar_group.delete_bar(item_index);
+bool MainWindow::delete_task(const TaskStore::TaskHandle& task){
+	return this->bar_group.delete_task(task);
+}
+
+bool MainWindow::delete_group(const TaskStore::GroupHandle& group){
+	return this->bar_group.delete_group(group);
 }
 
-void MainWindow::modify_task(const char* const task_name, const std::chrono::year_month_day& due_date, const int item_index){
+void MainWindow::modify_task(const char* const task_name, const std::chrono::year_month_day& due_date, const TaskStore::TaskHandle& task){
 	try{
-		this->bar_group.modify_task(task_name, due_date, item_index);
-	}catch(const std::invalid_argument& invalid_item_index) {throw;}
+		this->bar_group.modify_task(task_name, due_date, task);
+	}catch(const std::invalid_argument& invalid_task) {throw;}
 }
 
-bool MainWindow::modify_taskgroup_name(const char* const group_name, const int item_index){
-	return this->bar_group.modify_group(group_name, item_index);
+bool MainWindow::modify_taskgroup_name(const char* const group_name, const TaskStore::GroupHandle& group){
+	return this->bar_group.modify_group(group_name, group);
 }
 
 void MainWindow::show_taskgroups(){
@@ -173,13 +221,13 @@ void MainWindow::show_window_for_creating_new_task(){
 	this->task_properties_window.show();
 }
 
-void MainWindow::show_window_for_editing_task(const Task& task_properties, const int item_index){
-	this->task_properties_window.store_task(task_properties, item_index);
+void MainWindow::show_window_for_editing_task(const Task& task_properties, const TaskStore::TaskHandle& task){
+	this->task_properties_window.store_task(task_properties, task);
 	this->task_properties_window.show();
 }
 
-void MainWindow::show_window_for_editing_group(const std::string& group_name, const int item_index){
-	this->taskgroup_window.store_group(group_name, item_index);
+void MainWindow::show_window_for_editing_group(const std::string& group_name, const TaskStore::GroupHandle& group){
+	this->taskgroup_window.store_group(group_name, group);
 	this->taskgroup_window.show();
 }
 
@@ -187,6 +235,13 @@ void MainWindow::show_root_group_box(){
 	this->root_group_box.show();
 }
 
+void MainWindow::hide_root_group_box(){
+	//Fl_Widget::hide() would redraw MainWindow entirely, which is called on every click of a row.
+	if(!this->root_group_box.visible()) return;
+	this->root_group_box.clear_visible();
+	this->damage(FL_DAMAGE_ALL, this->root_group_box.x(), this->root_group_box.y(), this->root_group_box.w(), this->root_group_box.h());
+}
+
 void MainWindow::save_tasks_to_file(){
 	try{
 		if(!this->bar_group.has_unsaved_changes_to_tasks()){
@@ -194,7 +249,7 @@ void MainWindow::save_tasks_to_file(){
 			return;
 		}
 		
-		this->bar_group.save_tasks_to_file();
+		this->submit_save();
 	}
 	catch(const std::length_error& exceeded_max_alloc){
 		fl_alert("Not enough memory to save tasks to file. (MainWindow::save_tasks_to_file(): std::length_error)");	
@@ -212,6 +267,58 @@ void MainWindow::save_tasks_to_file(){
 	}
 }
 
+void MainWindow::handle_tasks_changed(){
+	this->autosave_scheduler.record_edit(autosave::Clock::now());
+	if(this->autosave_button.value()) this->schedule_autosave();
+}
+
+void MainWindow::autosave(){
+	if(!this->autosave_button.value()) return;
+	
+	if(!this->bar_group.has_unsaved_changes_to_tasks()) return;
+	if(!this->autosave_scheduler.save_due(autosave::Clock::now())){
+		this->schedule_autosave();
+		return;
+	}
+	
+	try{
+		this->submit_save();
+	}
+	catch(const std::exception& excp){
+		const std::string msg = std::string("Autosave failed, the changes are kept unsaved. ") + excp.what();
+		this->save_status_box.copy_label(msg.c_str());
+		this->save_status_box.redraw();
+	}
+	catch(...){
+		this->save_status_box.copy_label("Autosave failed, the changes are kept unsaved.");
+		this->save_status_box.redraw();
+	}
+}
+
+void MainWindow::show_save_results(){
+	const std::vector<BackgroundSaver::Result> results = this->saver.take_results();
+	if(results.empty()) return;
+	
+	std::string failure_message;
+	for(const BackgroundSaver::Result& result : results){
+		//only the task file written by a save is acknowledged, a change made outside of WorkTable meanwhile is still reloaded.
+		if(result.written_stamp) this->task_file_watcher.acknowledge_write(*result.written_stamp);
+		if(result.status == BackgroundSaver::Result::Status::Saved) continue;
+		
+		this->bar_group.handle_failed_save();
+		if(failure_message.empty()) failure_message = result.error_message;
+	}
+	
+	if(!failure_message.empty())
+		this->save_status_box.copy_label(("Save failed, the changes are kept unsaved. " + failure_message).c_str());
+	else if(this->saver.busy())
+		this->save_status_box.copy_label("Saving...");
+	else
+		this->save_status_box.copy_label("Saved.");
+	
+	this->save_status_box.redraw();
+}
+
 void MainWindow::revert_to_tasks_from_file(){
 	try{
 		if(!this->bar_group.has_unsaved_changes_to_tasks()){
@@ -224,8 +331,7 @@ void MainWindow::revert_to_tasks_from_file(){
 		if (user_decision != user_decision_revert) return;
 	
 		try{
-			this->bar_group.revert_to_tasks_from_file();
-			this->bar_group.redraw();		
+			this->reload_task_file();
 		}
 		catch(const std::bad_alloc& alloc_err) {
 			fl_alert("Memory allocation error while reverting changes to tasks. (MainWindow::revert_to_tasks_from_file(): std::bad_alloc)"
@@ -254,13 +360,65 @@ void MainWindow::revert_to_tasks_from_file(){
 	}	
 }
 
+void MainWindow::reload_changed_task_file(){
+	//A save may be rewriting the task file, which is only acknowledged once its result is taken, so the file is checked after every save is finished.
+	//MainWindow::save_results_callback() checks it again then.
+	if(this->saver.busy()){
+		this->task_file_watcher.defer_change();
+		return;
+	}
+	if(!this->task_file_watcher.changed()) return;
+	
+	try{
+		if(this->bar_group.has_unsaved_changes_to_tasks()){
+			const int user_decision_reload = 1;
+			const int user_decision = fl_choice("tasks.txt was changed outside of WorkTable. Reload it and discard the unsaved changes?", "Keep changes", "Reload", 0);
+			if(user_decision != user_decision_reload){
+				this->bar_group.handle_task_file_changed();
+				return;
+			}
+		}
+		
+		try{
+			this->reload_task_file();
+			this->save_status_box.copy_label("Reloaded tasks.txt after it was changed outside of WorkTable.");
+			this->save_status_box.redraw();
+		}
+		catch(const std::bad_alloc& alloc_err) {
+			fl_alert("Memory allocation error while reloading tasks. (MainWindow::reload_changed_task_file(): std::bad_alloc)"
+					"\nIt is recommended to exit the program without saving in order to not overwrite task list with faulty data.");		
+		}	
+		catch(const std::length_error& exceeded_max_alloc) {
+			fl_alert("Memory allocation error while reloading tasks. (MainWindow::reload_changed_task_file(): std::length_error)"
+					"\nIt is recommended to exit the program without saving in order to not overwrite task list with faulty data.");
+		}	
+		catch(const std::ios_base::failure& file_io_error) {
+			fl_alert("I/O error while reloading the changed task list. (MainWindow::reload_changed_task_file())"
+					"\nCurrently displayed tasks are still intact.");
+		}
+		catch(const std::runtime_error& file_not_opened) {
+			fl_alert("Task list file unable to be opened. (MainWindow::reload_changed_task_file())"
+					"\nCurrently displayed tasks are still intact.");
+		}
+	}
+	catch(const std::exception& unspecified_excp){
+		const std::string msg = std::string("Caught unspecified exception while reloading tasks. (MainWindow::reload_changed_task_file())\n")
+								+ std::string(unspecified_excp.what());
+		fl_alert(msg.c_str());
+	}
+	catch(...){
+		fl_alert("Caught unspecified throw while reloading tasks. (MainWindow::reload_changed_task_file())");
+	}
+}
+
 
 void MainWindow::zoomin_timescale(){
 	try{
 		const Timescale new_timescale = this->bar_group.zoomin_timescale();	
 		
+		//BarGroup redraws itself, so only the label is drawn again here.
 		this->timescale_text_box.label(timescale::get_timescale_str(new_timescale));	
-		this->redraw();
+		this->timescale_text_box.redraw_label();
 	}
 	catch(const std::exception& excp){
 		const std::string msg = std::string("MainWindow::zoomin_timescale(): caught an exception while changing timescale.")
@@ -276,8 +434,9 @@ void MainWindow::zoomout_timescale(){
 	try{
 		const Timescale new_timescale = this->bar_group.zoomout_timescale();	
 		
+		//BarGroup redraws itself, so only the label is drawn again here.
 		this->timescale_text_box.label(timescale::get_timescale_str(new_timescale));
-		this->redraw();	
+		this->timescale_text_box.redraw_label();
 	}
 	catch(const std::exception& excp){
 		const std::string msg = std::string("MainWindow::zoomout_timescale(): caught an exception while changing timescale.")
@@ -289,6 +448,33 @@ void MainWindow::zoomout_timescale(){
 	}	
 }
 
+void MainWindow::set_bar_render_mode(const BarGroup::RenderMode render_mode){
+	this->bar_group.set_render_mode(render_mode);
+}
+
+void MainWindow::compare_bar_render_modes(const int frame_count){
+	const BarGroup::RenderMode original_render_mode = this->bar_group.get_render_mode();
+	std::string results = "Average time to draw the tasks over " + std::to_string(frame_count) + " frames:";
+	
+	for(const BarGroup::RenderMode render_mode : {BarGroup::RenderMode::Widgets, BarGroup::RenderMode::Canvas}){
+		this->bar_group.set_render_mode(render_mode);
+		//The first frame is not counted, as the bars for the rows in view are constructed and bound to their rows then.
+		Fl::flush();
+		
+		const auto start = std::chrono::steady_clock::now();
+		for(int i = 0; i < frame_count; ++i){
+			this->bar_group.redraw();
+			Fl::flush();
+		}
+		const auto frame_time = std::chrono::duration_cast<std::chrono::microseconds>((std::chrono::steady_clock::now() - start) / frame_count);
+		
+		results += std::string("\n") + BarGroup::render_mode_name(render_mode) + ": " + std::to_string(frame_time.count()) + " microseconds";
+	}
+	
+	this->bar_group.set_render_mode(original_render_mode);
+	fl_message("%s", results.c_str());
+}
+
 
 //static public
 void MainWindow::new_task_button_callback(Fl_Widget* const self_ptr, void* const data){
@@ -313,4 +499,72 @@ void MainWindow::zoomin_button_callback(Fl_Widget* const self_ptr, void* const d
 
 void MainWindow::zoomout_button_callback(Fl_Widget* const self_ptr, void* const data){
 	((MainWindow*)(self_ptr->parent()))->zoomout_timescale();
-}
\ No newline at end of file
+}
+
+void MainWindow::autosave_button_callback(Fl_Widget* const self_ptr, void* const data){
+	MainWindow* const main_window = (MainWindow*)(self_ptr->parent());
+	//The edits made while autosave was off are saved on the same schedule as new ones.
+	if(main_window->autosave_button.value() && main_window->bar_group.has_unsaved_changes_to_tasks())
+		main_window->handle_tasks_changed();
+	else
+		Fl::remove_timeout(MainWindow::autosave_timeout_callback, main_window);
+}
+
+void MainWindow::autosave_timeout_callback(void* const data){
+	((MainWindow*)data)->autosave();
+}
+
+void MainWindow::compare_bar_render_modes_callback(void* const data){
+	((MainWindow*)data)->compare_bar_render_modes(MainWindow::compared_frame_count);
+}
+
+void MainWindow::save_finished_callback(void* const data){
+	Fl::awake(MainWindow::save_results_callback, data);
+}
+
+void MainWindow::save_results_callback(void* const data){
+	MainWindow* const main_window = (MainWindow*)data;
+	main_window->show_save_results();
+	//the changes to the task file deferred while saving.
+	main_window->reload_changed_task_file();
+}
+
+void MainWindow::task_file_changed_callback(const int fd, void* const data){
+	((MainWindow*)data)->reload_changed_task_file();
+}
+
+void MainWindow::task_file_poll_callback(void* const data){
+	((MainWindow*)data)->reload_changed_task_file();
+	Fl::repeat_timeout(FileWatcher::poll_interval, MainWindow::task_file_poll_callback, data);
+}
+
+
+//private
+void MainWindow::submit_save(){
+	this->bar_group.save_tasks_to_file(this->saver);
+	this->autosave_scheduler.record_save(autosave::Clock::now());
+	Fl::remove_timeout(MainWindow::autosave_timeout_callback, this);
+	
+	this->save_status_box.copy_label("Saving...");
+	this->save_status_box.redraw();
+}
+
+void MainWindow::schedule_autosave(){
+	const auto time_until_due = this->autosave_scheduler.due_time() - autosave::Clock::now();
+	const double seconds_until_due = std::max(0.0, std::chrono::duration<double>(time_until_due).count());
+	
+	Fl::remove_timeout(MainWindow::autosave_timeout_callback, this);
+	Fl::add_timeout(seconds_until_due, MainWindow::autosave_timeout_callback, this);
+}
+
+void MainWindow::reload_task_file(){
+	//The bars are compared against the task file in root view.
+	this->show_taskgroups();
+	
+	//The task file must not be read while a save is still writing it.
+	this->saver.wait_until_idle();
+	this->show_save_results();
+	
+	this->bar_group.revert_to_tasks_from_file();
+	this->task_file_watcher.acknowledge_change();
+}
@@ -11,49 +11,64 @@ You should have received a copy of the GNU General Public License along with Wor
 */
 
 #include "Task.hpp"
+#include "name_pool.hpp"
 #include "time_calc.hpp"
 
-#include <string>
 #include <chrono>
+#include <cstdint>
+#include <string_view>
 
-Task::Task(const std::chrono::year_month_day& due_date, const std::string& name)
+static_assert(sizeof(Task) == 12, "Task is meant to stay compact, as the task files may hold millions of them.");
+
+namespace{
+	std::int32_t to_day_count(const std::chrono::year_month_day& ymd) noexcept{
+		return std::int32_t(std::chrono::sys_days(ymd).time_since_epoch().count());
+	}
+}
+
+Task::Task(const std::chrono::year_month_day& due_date, const std::string_view name)
 :	Task(due_date, name, get_current_ymd())
 {
 	//nothing here :D
 }
 
-Task::Task(const std::chrono::year_month_day& due_date, const std::string& name, const std::chrono::year_month_day& current_ymd)
-:	_due_date(due_date), _days_remaining(delta_days(due_date, current_ymd)), _name(name)
+Task::Task(const std::chrono::year_month_day& due_date, const std::string_view name, const std::chrono::year_month_day& current_ymd)
+:	_due_date(to_day_count(due_date)), _days_remaining(std::int32_t(delta_days(due_date, current_ymd).count())), _name(name_pool::intern(name))
+{
+	//nothing here :D
+}
+
+Task::Task(const std::chrono::year_month_day& due_date, const name_pool::Name& name, const std::chrono::year_month_day& current_ymd)
+:	_due_date(to_day_count(due_date)), _days_remaining(std::int32_t(delta_days(due_date, current_ymd).count())), _name(name)
 {
 	//nothing here :D
 }
 
-std::chrono::year_month_day Task::due_date() const{
-	return _due_date;
+std::chrono::year_month_day Task::due_date() const noexcept{
+	return std::chrono::year_month_day(std::chrono::sys_days(std::chrono::days(_due_date)));
 }
 
 void Task::due_date(const std::chrono::year_month_day& new_due_date){
-	_due_date = new_due_date;
-	_days_remaining = delta_days(new_due_date, get_current_ymd());
+	_due_date = to_day_count(new_due_date);
+	_days_remaining = std::int32_t(delta_days(new_due_date, get_current_ymd()).count());
 }	
 
-std::chrono::days Task::days_remaining() const{
-	return _days_remaining;
+std::chrono::days Task::days_remaining() const noexcept{
+	return std::chrono::days(_days_remaining);
 }
 
-std::string Task::name() const{
-	return _name;
+std::string_view Task::name() const noexcept{
+	return _name.view();
 }
 
-void Task::name(const std::string& new_name){
-	_name = new_name;
+void Task::name(const std::string_view new_name){
+	_name = name_pool::intern(new_name);
 }
 
 bool Task::due_date_is_earlier(const Task& lhs, const Task& rhs) noexcept{
-	return lhs.due_date() < rhs.due_date();
+	return lhs._due_date < rhs._due_date;
 }
 
 bool Task::due_date_is_later(const Task& lhs, const Task& rhs) noexcept{
-	return lhs.due_date() > rhs.due_date();
+	return lhs._due_date > rhs._due_date;
 }
-
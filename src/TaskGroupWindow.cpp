@@ -40,7 +40,7 @@ TaskGroupWindow::TaskGroupWindow(const int width, const int height, MainWindow*
 				button_width - 5, button_height, "Save"
 	),
 	main_window(main_window),
-	modifying_item_index(-1)
+	modifying_group()
 {
 	this->end();
 	this->color(fl_rgb_color(240, 240, 240));
@@ -57,10 +57,10 @@ TaskGroupWindow::TaskGroupWindow(const int width, const int height, MainWindow*
 	this->save_button.box(FL_FLAT_BOX);
 }
 
-void TaskGroupWindow::store_group(const std::string& group_name, const int item_index){
+void TaskGroupWindow::store_group(const std::string& group_name, const TaskStore::GroupHandle& group){
 	this->copy_label(group_name.c_str());
 	this->task_name_dialog.value(group_name.c_str());
-	this->modifying_item_index = item_index;
+	this->modifying_group = group;
 }
 
 
@@ -86,9 +86,9 @@ void TaskGroupWindow::delete_button_callback(Fl_Widget* const self, void* const
 
 void TaskGroupWindow::delete_group(){
 	try{
-		if(!main_window->delete_bar(modifying_item_index)){
+		if(!main_window->delete_group(modifying_group)){
 			fl_alert("Failed to delete task."
-					"\nTaskGroupWindow::delete_group(): Invalid deletion index.");
+					"\nTaskGroupWindow::delete_group(): Invalid group.");
 		}
 	}catch(const std::exception& excp){
 		const std::string msg = std::string("TaskGroupWindow::delete_group(): an exception was thrown while deleting task.")
@@ -101,8 +101,8 @@ void TaskGroupWindow::delete_group(){
 
 void TaskGroupWindow::modify_group_name(){
 	try{
-		if(!(this->main_window->modify_taskgroup_name(task_name_dialog.value(), modifying_item_index))){
-			fl_alert("TaskGroupWindow::modify_group_name(): invalid item index.");
+		if(!(this->main_window->modify_taskgroup_name(task_name_dialog.value(), modifying_group))){
+			fl_alert("TaskGroupWindow::modify_group_name(): invalid group.");
 		}
 	}
 	catch(const std::exception& excp){
@@ -51,7 +51,7 @@ TaskPropertiesWindow::TaskPropertiesWindow(const int width, const int height, Ma
 				button_width - 5, button_height, "Create"
 	),
 	main_window(main_window),
-	modifying_item_index(-1),
+	modifying_task(),
 	current_mode(TaskPropertiesWindow::Mode::UnInit)
 {
 	this->end();
@@ -90,11 +90,11 @@ void TaskPropertiesWindow::set_window_for_creating_task(){
 	this->current_mode = TaskPropertiesWindow::Mode::CreateNewTask;
 }
 
-void TaskPropertiesWindow::store_task(const Task& task, const int item_index){
-	this->copy_label(task.name().c_str());
-	this->task_name_dialog.value(task.name().c_str());
+void TaskPropertiesWindow::store_task(const Task& task, const TaskStore::TaskHandle& task_handle){
+	this->copy_label(task.name().data());
+	this->task_name_dialog.value(task.name().data());
 	this->due_date_dialog.value(ymd_to_string(task.due_date()).c_str());
-	this->modifying_item_index = item_index;
+	this->modifying_task = task_handle;
 	this->current_mode = TaskPropertiesWindow::Mode::EditTask;
 	this->delete_button.label("Delete");
 	this->save_button.label("Save");	
@@ -155,15 +155,14 @@ void TaskPropertiesWindow::add_task(){
 			return;
 		}
 		
-		try{
-			const std::chrono::year_month_day new_due_date = str_to_ymd(std::string(this->due_date_dialog.value()));
-		
-			this->main_window->add_task(Task(new_due_date, std::string(task_name_dialog.value())));
-			this->hide();
-		}
-		catch(const std::invalid_argument& invalid_ymd_str){
-			this->warning_message.copy_label(invalid_ymd_str.what());
+		const YmdParseResult new_due_date = parse_ymd(this->due_date_dialog.value());
+		if(!new_due_date.ok()){
+			this->warning_message.label(ymd_parse_status_message(new_due_date.status));
+			return;
 		}
+		
+		this->main_window->add_task(Task(new_due_date.ymd, task_name_dialog.value()));
+		this->hide();
 	}
 	catch(const std::exception& excp){
 		const std::string msg = std::string("TaskPropertiesWindow::add_task(): an exception was thrown while adding task.")
@@ -176,9 +175,9 @@ void TaskPropertiesWindow::add_task(){
 
 void TaskPropertiesWindow::delete_task(){
 	try{
-		if(!main_window->delete_bar(modifying_item_index)){
+		if(!main_window->delete_task(modifying_task)){
 			fl_alert("Failed to delete task."
-					"\nTaskPropertiesWindow::delete_task(): Invalid deletion index.");
+					"\nTaskPropertiesWindow::delete_task(): Invalid task.");
 		}
 	}
 	catch(const std::exception& excp){
@@ -208,22 +207,19 @@ void TaskPropertiesWindow::modify_task(){
 		}
 				
 		
-		std::chrono::year_month_day new_due_date;
-		try{
-			new_due_date = str_to_ymd(std::string(due_date_dialog.value()));
-		}
-		catch(const std::invalid_argument& invalid_ymd_str){
-			this->warning_message.copy_label(invalid_ymd_str.what());
-			return;	
+		const YmdParseResult new_due_date = parse_ymd(due_date_dialog.value());
+		if(!new_due_date.ok()){
+			this->warning_message.label(ymd_parse_status_message(new_due_date.status));
+			return;
 		}
 
 		try{
-			this->main_window->modify_task(task_name_dialog.value(), new_due_date, modifying_item_index);
+			this->main_window->modify_task(task_name_dialog.value(), new_due_date.ymd, modifying_task);
 			this->hide();
 		}
-		catch(const std::invalid_argument& invalid_index){
+		catch(const std::invalid_argument& invalid_task){
 			fl_alert("Failed to save changes."
-					"\nTaskPropertiesWindow::modify_task(): Invalid task index.");
+					"\nTaskPropertiesWindow::modify_task(): Invalid task.");
 		}
 	}
 	catch(const std::exception& excp){
@@ -0,0 +1,45 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "autosave.hpp"
+
+#include <chrono>
+#include <algorithm>
+
+namespace autosave{
+	Scheduler::Scheduler(const Policy& policy) noexcept
+	:	_policy(policy)
+	{
+	}
+	
+	Clock::time_point Scheduler::record_edit(const Clock::time_point time) noexcept{
+		this->last_edit = time;
+		return this->due_time();
+	}
+	
+	void Scheduler::record_save(const Clock::time_point time) noexcept{
+		this->last_save = time;
+		this->last_edit.reset();
+	}
+	
+	Clock::time_point Scheduler::due_time() const noexcept{
+		const Clock::time_point after_quiet_period = *this->last_edit + this->_policy.quiet_period;
+		if(!this->last_save) return after_quiet_period;
+		
+		return std::max(after_quiet_period, *this->last_save + this->_policy.min_interval);
+	}
+	
+	bool Scheduler::save_due(const Clock::time_point time) const noexcept{
+		return this->save_pending() && (time >= this->due_time());
+	}
+}
@@ -0,0 +1,94 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "background_saver.hpp"
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <optional>
+#include <exception>
+#include <stop_token>
+
+BackgroundSaver::BackgroundSaver(void(*notify)(void*), void* const notify_data)
+:	notify(notify), notify_data(notify_data), job_running(false),
+	worker([this](std::stop_token stop_token){this->run(stop_token);})
+{
+}
+
+void BackgroundSaver::submit(Job job){
+	{
+		const std::lock_guard<std::mutex> lock(this->mutex);
+		this->jobs.push_back(std::move(job));
+	}
+	this->job_submitted.notify_one();
+}
+
+std::vector<BackgroundSaver::Result> BackgroundSaver::take_results(){
+	const std::lock_guard<std::mutex> lock(this->mutex);
+	return std::exchange(this->results, {});
+}
+
+bool BackgroundSaver::busy() const{
+	const std::lock_guard<std::mutex> lock(this->mutex);
+	return this->job_running || !this->jobs.empty();
+}
+
+void BackgroundSaver::wait_until_idle(){
+	std::unique_lock<std::mutex> lock(this->mutex);
+	this->idle.wait(lock, [this](){return !this->job_running && this->jobs.empty();});
+}
+
+void BackgroundSaver::run(std::stop_token stop_token){
+	std::unique_lock<std::mutex> lock(this->mutex);
+	
+	while(true){
+		//Only stop once the queue is empty, the jobs left are saves the user expects to be written.
+		this->job_submitted.wait(lock, stop_token, [this](){return !this->jobs.empty();});
+		if(this->jobs.empty()) return;
+		
+		Job job = std::move(this->jobs.front());
+		this->jobs.pop_front();
+		this->job_running = true;
+		lock.unlock();
+		
+		Result result = {Result::Status::Saved, "", std::nullopt};
+		try{
+			result.written_stamp = job();
+		}
+		catch(const std::exception& excp){
+			result = {Result::Status::Failed, excp.what(), std::nullopt};
+		}
+		catch(...){
+			result = {Result::Status::Failed, "Caught an unspecified throw while saving.", std::nullopt};
+		}
+		
+		lock.lock();
+		this->results.push_back(std::move(result));
+		if(this->results.back().status == Result::Status::Failed){
+			for(std::size_t i = 0; i < this->jobs.size(); ++i)
+				this->results.push_back({Result::Status::Cancelled, "A save before it failed.", std::nullopt});
+			this->jobs.clear();
+		}
+		this->job_running = false;
+		if(this->jobs.empty()) this->idle.notify_all();
+		
+		//Notified without the lock, so the notify function is free to call take_results() right away.
+		lock.unlock();
+		if(this->notify != nullptr) this->notify(this->notify_data);
+		lock.lock();
+	}
+}
@@ -0,0 +1,152 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "byte_scan.hpp"
+
+//The SIMD kernels rely on GCC and Clang function attributes for compiling AVX2 code without compiling the entire program for AVX2,
+//so the program still runs on CPUs without it.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+	#define BYTE_SCAN_X86
+	#include <immintrin.h>
+#endif
+
+namespace byte_scan{
+	namespace{
+		const char* find_first_of_scalar(const char* first, const char* const last, const ScanSet& set) noexcept{
+			for(; first != last; ++first){
+				if(set.contains(*first)) return first;
+			}
+			return last;
+		}
+
+		#ifdef BYTE_SCAN_X86
+		__attribute__((target("sse2")))
+		const char* find_first_of_sse2(const char* first, const char* const last, const ScanSet& set) noexcept{
+			const __m128i a = _mm_set1_epi8(set.chars[0]);
+			const __m128i b = _mm_set1_epi8(set.chars[1]);
+			const __m128i c = _mm_set1_epi8(set.chars[2]);
+			const __m128i d = _mm_set1_epi8(set.chars[3]);
+
+			for(; last - first >= 16; first += 16){
+				const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+				const __m128i matches = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, a), _mm_cmpeq_epi8(block, b)),
+													_mm_or_si128(_mm_cmpeq_epi8(block, c), _mm_cmpeq_epi8(block, d)));
+
+				//a bit for each character of the block, set if the character is in the set.
+				const unsigned match_mask = static_cast<unsigned>(_mm_movemask_epi8(matches));
+				if(match_mask != 0) return first + __builtin_ctz(match_mask);
+			}
+
+			//The remaining characters are less than a block, reading a full block would read past the buffer.
+			return find_first_of_scalar(first, last, set);
+		}
+
+		__attribute__((target("avx2")))
+		const char* find_first_of_avx2(const char* first, const char* const last, const ScanSet& set) noexcept{
+			const __m256i a = _mm256_set1_epi8(set.chars[0]);
+			const __m256i b = _mm256_set1_epi8(set.chars[1]);
+			const __m256i c = _mm256_set1_epi8(set.chars[2]);
+			const __m256i d = _mm256_set1_epi8(set.chars[3]);
+
+			for(; last - first >= 32; first += 32){
+				const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+				const __m256i matches = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, a), _mm256_cmpeq_epi8(block, b)),
+														_mm256_or_si256(_mm256_cmpeq_epi8(block, c), _mm256_cmpeq_epi8(block, d)));
+
+				const unsigned match_mask = static_cast<unsigned>(_mm256_movemask_epi8(matches));
+				if(match_mask != 0) return first + __builtin_ctz(match_mask);
+			}
+
+			//A half block is compared here instead of calling find_first_of_sse2(), as the SSE2 instructions compiled there
+			//would stall when mixed with the AVX2 instructions of this function. The ones compiled here are encoded as AVX.
+			if(last - first >= 16){
+				const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+				const __m128i matches = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, _mm256_castsi256_si128(a)), _mm_cmpeq_epi8(block, _mm256_castsi256_si128(b))),
+													_mm_or_si128(_mm_cmpeq_epi8(block, _mm256_castsi256_si128(c)), _mm_cmpeq_epi8(block, _mm256_castsi256_si128(d))));
+
+				const unsigned match_mask = static_cast<unsigned>(_mm_movemask_epi8(matches));
+				if(match_mask != 0) return first + __builtin_ctz(match_mask);
+				first += 16;
+			}
+
+			return find_first_of_scalar(first, last, set);
+		}
+		#endif
+
+		using find_first_of_function = const char*(*)(const char*, const char* const, const ScanSet&) noexcept;
+
+		find_first_of_function get_kernel_function(const Kernel kernel) noexcept{
+			switch(kernel){
+				#ifdef BYTE_SCAN_X86
+				case Kernel::AVX2:
+				return find_first_of_avx2;
+
+				case Kernel::SSE2:
+				return find_first_of_sse2;
+				#endif
+
+				default:
+				return find_first_of_scalar;
+			}
+		}
+	}
+
+	bool kernel_supported(const Kernel kernel) noexcept{
+		switch(kernel){
+			case Kernel::Scalar:
+			return true;
+
+			#ifdef BYTE_SCAN_X86
+			case Kernel::SSE2:
+			return __builtin_cpu_supports("sse2");
+
+			case Kernel::AVX2:
+			return __builtin_cpu_supports("avx2");
+			#endif
+
+			default:
+			return false;
+		}
+	}
+
+	Kernel active_kernel() noexcept{
+		static const Kernel widest_supported_kernel = kernel_supported(Kernel::AVX2) ? Kernel::AVX2
+													: kernel_supported(Kernel::SSE2) ? Kernel::SSE2
+													: Kernel::Scalar;
+		return widest_supported_kernel;
+	}
+
+	const char* kernel_name(const Kernel kernel) noexcept{
+		switch(kernel){
+			case Kernel::Scalar:
+			return "Scalar";
+
+			case Kernel::SSE2:
+			return "SSE2";
+
+			case Kernel::AVX2:
+			return "AVX2";
+
+			default:
+			return "Unknown";
+		}
+	}
+
+	const char* find_first_of(const char* first, const char* const last, const ScanSet& set) noexcept{
+		static const find_first_of_function active_kernel_function = get_kernel_function(active_kernel());
+		return active_kernel_function(first, last, set);
+	}
+
+	const char* find_first_of(const Kernel kernel, const char* first, const char* const last, const ScanSet& set) noexcept{
+		return get_kernel_function(kernel)(first, last, set);
+	}
+}
@@ -0,0 +1,110 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "file_watch.hpp"
+
+#include "task_snapshot.hpp"
+
+#ifdef __linux__
+	#include <unistd.h>
+	#include <sys/inotify.h>
+#endif
+
+#include <string>
+#include <cstring>
+#include <optional>
+#include <filesystem>
+
+FileWatcher::FileWatcher(const std::string& filename)
+:	filename(filename), 
+	acknowledged_stamp(task_snapshot::get_source_stamp(filename)),
+	inotify_fd(-1),
+	unchecked_events(false)
+{
+	#ifdef __linux__
+	const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if(fd == -1) return;
+	
+	std::string directory = std::filesystem::path(filename).parent_path().string();
+	if(directory.empty()) directory = ".";
+	
+	//IN_CLOSE_WRITE for the file written in place, IN_MOVED_TO for another file renamed over it.
+	if(inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) == -1){
+		close(fd);
+		return;
+	}
+	this->inotify_fd = fd;
+	#endif
+}
+
+FileWatcher::~FileWatcher() noexcept{
+	#ifdef __linux__
+	if(this->inotify_fd != -1) close(this->inotify_fd);
+	#endif
+}
+
+bool FileWatcher::changed() noexcept{
+	if(this->inotify_fd != -1){
+		const bool file_event = this->read_events();
+		if(!file_event && !this->unchecked_events) return false;
+	}
+	this->unchecked_events = false;
+	
+	const std::optional<task_snapshot::SourceStamp> stamp = task_snapshot::get_source_stamp(this->filename);
+	if(!stamp || stamp == this->acknowledged_stamp) return false;
+	
+	this->acknowledged_stamp = stamp;
+	return true;
+}
+
+void FileWatcher::acknowledge_change() noexcept{
+	//the events of the acknowledged write are read and dropped, so they do not wake the event loop again.
+	if(this->inotify_fd != -1) this->read_events();
+	this->acknowledged_stamp = task_snapshot::get_source_stamp(this->filename);
+}
+
+void FileWatcher::acknowledge_write(const task_snapshot::SourceStamp& written_stamp) noexcept{
+	//the events read may include a change made after the write, which is found by comparing the file against the written stamp.
+	this->defer_change();
+	this->acknowledged_stamp = written_stamp;
+}
+
+void FileWatcher::defer_change() noexcept{
+	if(this->inotify_fd != -1 && this->read_events()) this->unchecked_events = true;
+}
+
+bool FileWatcher::read_events() noexcept{
+	bool file_event = false;
+	
+	#ifdef __linux__
+	const std::string file_name = std::filesystem::path(this->filename).filename().string();
+	
+	alignas(inotify_event) char buffer[4096];
+	while(true){
+		const ssize_t read_size = read(this->inotify_fd, buffer, sizeof(buffer));
+		if(read_size <= 0) break;
+		
+		for(ssize_t offset = 0; offset < read_size;){
+			inotify_event event;
+			std::memcpy(&event, buffer + offset, sizeof(inotify_event));
+			
+			//the name is null padded after the event.
+			if(event.len > 0 && file_name == (buffer + offset + sizeof(inotify_event)))
+				file_event = true;
+			offset += sizeof(inotify_event) + event.len;
+		}
+	}
+	#endif
+	
+	return file_event;
+}
@@ -11,14 +11,37 @@ You should have received a copy of the GNU General Public License along with Wor
 */
 
 #include "MainWindow.hpp"
+#include "task_io.hpp"
 
 #include <FL/Fl.H>
 #include <FL/fl_ask.h>
 
-int main(){
+#include <string_view>
+
+int main(const int argc, const char* const* const argv){
 	try{
+		//Enables Fl::awake() for the saves finishing on the worker thread of BackgroundSaver.
+		Fl::lock();
+		
+		//task_io reports its errors and asks whether to retry saving through these, as it does not depend on FLTK.
+		task_io_report::set_alert_function([](const char* const message){fl_alert("%s", message);});
+		task_io_report::set_retry_function([](const char* const question){
+			return fl_choice("%s", "Resave", "Keep anomaly", 0, question) == 0;
+		});
+		
 		//If you ran into a stack overflow issue, change this to pointer.
 		MainWindow window(0, 0, MainWindow::width, MainWindow::height, "WorkTable 0.5.0");
+		
+		//--canvas draws the tasks with a single widget rather than a widget for each, --compare-renderers times drawing them both ways.
+		for(int i = 1; i < argc; ++i){
+			const std::string_view option(argv[i]);
+			if(option == "--canvas")
+				window.set_bar_render_mode(BarGroup::RenderMode::Canvas);
+			else if(option == "--compare-renderers")
+				//the window is given a moment to be mapped, so the frames are actually drawn.
+				Fl::add_timeout(1.0, MainWindow::compare_bar_render_modes_callback, &window);
+		}
+		
 		window.show();
 		return Fl::run();
 	}
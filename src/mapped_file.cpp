@@ -0,0 +1,187 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "mapped_file.hpp"
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+#include <cerrno>
+#include <memory>
+#include <string>
+#include <cstddef>
+#include <utility>
+#include <stdexcept>
+#include <ios>
+
+template<typename ReadFunction>
+void MappedFile::read(const std::size_t size, ReadFunction&& read_some){
+	this->read_buffer = std::make_unique_for_overwrite<char[]>(size);
+	std::size_t read_size = 0;
+	while(read_size < size){
+		const std::size_t read_count = read_some(this->read_buffer.get() + read_size, size - read_size);
+		if(read_count == 0) break;
+		read_size += read_count;
+	}
+	
+	this->_data = this->read_buffer.get();
+	this->_size = read_size;
+}
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& filename)
+:	_data(nullptr), _size(0)
+{
+	//Other processes may still write, rename and delete the file, as with the files opened by the standard library.
+	const HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, 
+									OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(file == INVALID_HANDLE_VALUE)
+		throw std::runtime_error(std::string("mapped_file.cpp: MappedFile::MappedFile(): ") + filename + " cannot be opened.");
+
+	LARGE_INTEGER filesize;
+	if(!GetFileSizeEx(file, &filesize)){
+		CloseHandle(file);
+		throw std::ios_base::failure("mapped_file.cpp: MappedFile::MappedFile(): unable to get the size of " + filename + ".");
+	}
+
+	//A file with the size of 0 cannot be mapped, so we leave it as an empty view.
+	if(filesize.QuadPart == 0){
+		CloseHandle(file);
+		return;
+	}
+	
+	if(static_cast<std::size_t>(filesize.QuadPart) < min_mapped_size){
+		bool read_error = false;
+		this->read(static_cast<std::size_t>(filesize.QuadPart), [&](char* const buffer, const std::size_t size) -> std::size_t{
+			DWORD read_count = 0;
+			if(!ReadFile(file, buffer, static_cast<DWORD>(size), &read_count, nullptr)) read_error = true;
+			return read_count;
+		});
+		CloseHandle(file);
+		if(read_error){
+			this->unmap();
+			throw std::ios_base::failure("mapped_file.cpp: MappedFile::MappedFile(): " + filename + " cannot be read.");
+		}
+		return;
+	}
+
+	const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	//The view keeps the mapping alive by itself, so both handles can be closed once the view is created.
+	CloseHandle(file);
+	if(mapping == nullptr)
+		throw std::ios_base::failure("mapped_file.cpp: MappedFile::MappedFile(): " + filename + " cannot be mapped.");
+
+	const void* const view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if(view == nullptr)
+		throw std::ios_base::failure("mapped_file.cpp: MappedFile::MappedFile(): " + filename + " cannot be mapped.");
+
+	this->_data = static_cast<const char*>(view);
+	this->_size = static_cast<std::size_t>(filesize.QuadPart);
+}
+
+void MappedFile::unmap() noexcept{
+	if(this->is_mapped())
+		UnmapViewOfFile(this->_data);
+	this->read_buffer.reset();
+
+	this->_data = nullptr;
+	this->_size = 0;
+}
+
+#else
+MappedFile::MappedFile(const std::string& filename)
+:	_data(nullptr), _size(0)
+{
+	const int file = open(filename.c_str(), O_RDONLY);
+	if(file == -1)
+		throw std::runtime_error(std::string("mapped_file.cpp: MappedFile::MappedFile(): ") + filename + " cannot be opened.");
+
+	struct stat file_status;
+	if(fstat(file, &file_status) == -1){
+		close(file);
+		throw std::ios_base::failure("mapped_file.cpp: MappedFile::MappedFile(): unable to get the size of " + filename + ".");
+	}
+
+	//A file with the size of 0 cannot be mapped, so we leave it as an empty view.
+	if(file_status.st_size == 0){
+		close(file);
+		return;
+	}
+	
+	//read instead of mapped, so the file being cut short while it is read shortens the view instead of raising SIGBUS.
+	if(static_cast<std::size_t>(file_status.st_size) < min_mapped_size){
+		bool read_error = false;
+		this->read(static_cast<std::size_t>(file_status.st_size), [&](char* const buffer, const std::size_t size) -> std::size_t{
+			ssize_t read_count;
+			do{
+				read_count = ::read(file, buffer, size);
+			}while(read_count == -1 && errno == EINTR);
+			if(read_count == -1) read_error = true;
+			return (read_count == -1) ? 0 : static_cast<std::size_t>(read_count);
+		});
+		close(file);
+		if(read_error){
+			this->unmap();
+			throw std::ios_base::failure("mapped_file.cpp: MappedFile::MappedFile(): " + filename + " cannot be read.");
+		}
+		return;
+	}
+
+	void* const view = mmap(nullptr, file_status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	//The mapping stays valid after the file descriptor is closed.
+	close(file);
+	if(view == MAP_FAILED)
+		throw std::ios_base::failure("mapped_file.cpp: MappedFile::MappedFile(): " + filename + " cannot be mapped.");
+
+	//We read the file from start to end once, so let the OS read ahead.
+	madvise(view, file_status.st_size, MADV_SEQUENTIAL);
+
+	this->_data = static_cast<const char*>(view);
+	this->_size = static_cast<std::size_t>(file_status.st_size);
+}
+
+void MappedFile::unmap() noexcept{
+	if(this->is_mapped())
+		munmap(const_cast<char*>(this->_data), this->_size);
+	this->read_buffer.reset();
+
+	this->_data = nullptr;
+	this->_size = 0;
+}
+#endif
+
+MappedFile::~MappedFile() noexcept{
+	this->unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+:	_data(std::exchange(other._data, nullptr)), _size(std::exchange(other._size, 0)), read_buffer(std::move(other.read_buffer))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept{
+	if(this != &other){
+		this->unmap();
+		this->_data = std::exchange(other._data, nullptr);
+		this->_size = std::exchange(other._size, 0);
+		this->read_buffer = std::move(other.read_buffer);
+	}
+	return *this;
+}
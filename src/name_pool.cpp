@@ -0,0 +1,287 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "name_pool.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+namespace name_pool{
+	namespace{
+		constexpr std::size_t first_segment_bits = 10;
+		constexpr std::size_t first_segment_size = std::size_t(1) << first_segment_bits;
+		//segment k holds first_segment_size << k names, so 23 segments hold more names than there are handles.
+		constexpr std::size_t segment_count = 23;
+		
+		constexpr std::size_t text_chunk_size = 64 * 1024;
+		constexpr std::uint32_t no_handle = UINT32_MAX;
+		
+		struct Slot{
+			///The stored name, which views no characters once the slot is free.
+			std::string_view text;
+			std::atomic<std::uint64_t> references;
+			///The index of the text chunk holding the name, or the next free slot once the slot is free.
+			std::uint32_t chunk_or_next_free;
+		};
+		
+		struct TextChunk{
+			std::unique_ptr<char[]> text;
+			///The count of names stored in the chunk and not released yet, the chunk is released once it reaches 0.
+			std::size_t name_count;
+		};
+		
+		/**
+		The names are looked up by their handle from a table of segments which are never moved once allocated,
+		so a handle can be read without locking while other threads are interning names into later slots or segments.
+		The characters are stored in chunks, which are never moved either.
+		
+		The references are counted in the slots without locking. The last reference dropped locks the pool to release the name,
+		unless the name was interned again meanwhile. Releasing a name does not allocate, so it is done from the destructor of Name.
+		*/
+		class Pool{
+			public:
+			Pool() : current_chunk(no_handle), text_cursor(nullptr), text_remaining(0), next_handle(0), first_free_handle(no_handle), live_name_count(0) {
+				//the empty name takes the first handle, and is never released as Name does not count its references.
+				this->intern("");
+			}
+			
+			Handle intern(const std::string_view name){
+				const std::lock_guard<std::mutex> lock(this->mutex);
+				
+				const auto found = this->handles.find(name);
+				if(found != this->handles.end()){
+					//the name may be waiting to be released by the thread which dropped its last reference, which then leaves it.
+					this->slot(found->second).references.fetch_add(1, std::memory_order_relaxed);
+					return found->second;
+				}
+				
+				if(this->first_free_handle == no_handle && this->next_handle == no_handle) 
+					throw std::length_error("name_pool.cpp: name_pool::intern(): the pool is out of handles.");
+				
+				//the segment and text chunk are allocated before taking a slot, so throwing leaves no slot taken.
+				if(this->first_free_handle == no_handle){
+					const std::size_t segment = segment_of(this->next_handle);
+					if(!this->segments[segment]) this->segments[segment] = std::make_unique<Slot[]>(first_segment_size << segment);
+				}
+				const std::uint32_t chunk = this->reserve_text(name.size() + 1);
+				
+				Handle handle;
+				if(this->first_free_handle != no_handle){
+					handle = this->first_free_handle;
+					this->first_free_handle = this->slot(handle).chunk_or_next_free;
+				}else{
+					handle = this->next_handle++;
+				}
+				
+				Slot& slot = this->slot(handle);
+				slot.text = this->store_text(name, chunk);
+				slot.references.store(1, std::memory_order_relaxed);
+				slot.chunk_or_next_free = chunk;
+				
+				try{
+					this->handles.emplace(slot.text, handle);
+				}
+				catch(...){
+					this->free_slot(handle);
+					throw;
+				}
+				++this->live_name_count;
+				return handle;
+			}
+			
+			void retain(const Handle handle) noexcept{
+				this->slot(handle).references.fetch_add(1, std::memory_order_relaxed);
+			}
+			
+			void release(const Handle handle) noexcept{
+				Slot& slot = this->slot(handle);
+				if(slot.references.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+				
+				const std::lock_guard<std::mutex> lock(this->mutex);
+				//interned again since the count reached 0, or released already by another thread which dropped the reference interned again.
+				//Acquired, as the last reference may have been dropped by a thread which interned the name again and read it meanwhile.
+				if(slot.references.load(std::memory_order_acquire) != 0 || slot.text.data() == nullptr) return;
+				
+				this->handles.erase(slot.text);
+				this->free_slot(handle);
+				--this->live_name_count;
+			}
+			
+			std::string_view view(const Handle handle) const noexcept{
+				const std::size_t segment = segment_of(handle);
+				return this->segments[segment][slot_of(handle, segment)].text;
+			}
+			
+			std::size_t name_count(){
+				const std::lock_guard<std::mutex> lock(this->mutex);
+				return this->live_name_count;
+			}
+			
+			private:
+			static std::size_t segment_of(const Handle handle) noexcept{
+				return std::bit_width((std::uint64_t(handle) + first_segment_size) >> first_segment_bits) - 1;
+			}
+			
+			static std::size_t slot_of(const Handle handle, const std::size_t segment) noexcept{
+				return (std::uint64_t(handle) + first_segment_size) - (std::uint64_t(first_segment_size) << segment);
+			}
+			
+			Slot& slot(const Handle handle) const noexcept{
+				const std::size_t segment = segment_of(handle);
+				return this->segments[segment][slot_of(handle, segment)];
+			}
+			
+			///Returns the chunk which stored_size characters are stored into by store_text(), adding a chunk if the current one has no room left.
+			std::uint32_t reserve_text(const std::size_t stored_size){
+				//long names get a chunk of their own, so they do not waste the rest of the current chunk.
+				const bool own_chunk = stored_size > text_chunk_size / 4;
+				if(!own_chunk && stored_size <= this->text_remaining) return this->current_chunk;
+				
+				std::unique_ptr<char[]> text = std::make_unique<char[]>(own_chunk ? stored_size : text_chunk_size);
+				//a released chunk is pushed to this->free_chunks without allocating, as it has room for every chunk.
+				this->free_chunks.reserve(this->text_chunks.size() + 1);
+				
+				std::uint32_t chunk;
+				if(!this->free_chunks.empty()){
+					chunk = this->free_chunks.back();
+					this->free_chunks.pop_back();
+					this->text_chunks[chunk] = {std::move(text), 0};
+				}else{
+					chunk = std::uint32_t(this->text_chunks.size());
+					this->text_chunks.push_back({std::move(text), 0});
+				}
+				if(own_chunk) return chunk;
+				
+				//the chunk replaced may have had every name in it released already.
+				const std::uint32_t replaced_chunk = std::exchange(this->current_chunk, chunk);
+				if(replaced_chunk != no_handle && this->text_chunks[replaced_chunk].name_count == 0) this->free_chunk(replaced_chunk);
+				this->text_cursor = this->text_chunks[chunk].text.get();
+				this->text_remaining = text_chunk_size;
+				return chunk;
+			}
+			
+			///Copies name with a null terminator into the chunk from reserve_text(), and returns the copy without the terminator.
+			std::string_view store_text(const std::string_view name, const std::uint32_t chunk) noexcept{
+				char* destination;
+				if(chunk == this->current_chunk){
+					destination = this->text_cursor;
+					this->text_cursor += name.size() + 1;
+					this->text_remaining -= name.size() + 1;
+				}else{
+					destination = this->text_chunks[chunk].text.get();
+				}
+				this->text_chunks[chunk].name_count++;
+				
+				if(!name.empty()) std::memcpy(destination, name.data(), name.size());
+				destination[name.size()] = '\0';
+				return std::string_view(destination, name.size());
+			}
+			
+			///Releases the text of the slot and makes the slot the first free one.
+			void free_slot(const Handle handle) noexcept{
+				Slot& slot = this->slot(handle);
+				this->release_text(slot.chunk_or_next_free);
+				slot.text = std::string_view();
+				slot.chunk_or_next_free = this->first_free_handle;
+				this->first_free_handle = handle;
+			}
+			
+			void release_text(const std::uint32_t chunk) noexcept{
+				//the current chunk is kept for the names interned next, it is released once replaced.
+				if(--this->text_chunks[chunk].name_count == 0 && chunk != this->current_chunk) this->free_chunk(chunk);
+			}
+			
+			void free_chunk(const std::uint32_t chunk) noexcept{
+				this->text_chunks[chunk].text.reset();
+				this->free_chunks.push_back(chunk);
+			}
+			
+			mutable std::mutex mutex;
+			std::unordered_map<std::string_view, Handle> handles;
+			std::array<std::unique_ptr<Slot[]>, segment_count> segments;
+			std::vector<TextChunk> text_chunks;
+			std::vector<std::uint32_t> free_chunks;
+			std::uint32_t current_chunk;
+			char* text_cursor;
+			std::size_t text_remaining;
+			Handle next_handle;
+			Handle first_free_handle;
+			std::size_t live_name_count;
+		};
+		
+		Pool& get_pool(){
+			//never destroyed, so the Names destroyed after the static objects of this file still release their names into a valid pool.
+			static Pool* const pool = new Pool();
+			return *pool;
+		}
+	}
+	
+	Name::Name(const Name& other) noexcept
+	:	_handle(other._handle)
+	{
+		if(this->_handle != empty_name) get_pool().retain(this->_handle);
+	}
+	
+	Name::Name(Name&& other) noexcept
+	:	_handle(std::exchange(other._handle, empty_name))
+	{
+	}
+	
+	Name& Name::operator=(const Name& other) noexcept{
+		//retained before releasing, so assigning a Name to itself keeps the name.
+		if(other._handle != empty_name) get_pool().retain(other._handle);
+		if(this->_handle != empty_name) get_pool().release(this->_handle);
+		this->_handle = other._handle;
+		return *this;
+	}
+	
+	Name& Name::operator=(Name&& other) noexcept{
+		if(this != &other){
+			if(this->_handle != empty_name) get_pool().release(this->_handle);
+			this->_handle = std::exchange(other._handle, empty_name);
+		}
+		return *this;
+	}
+	
+	Name::~Name() noexcept{
+		if(this->_handle != empty_name) get_pool().release(this->_handle);
+	}
+	
+	std::string_view Name::view() const noexcept{
+		return name_pool::view(this->_handle);
+	}
+	
+	Name intern(const std::string_view name){
+		if(name.empty()) return Name();
+		return Name(get_pool().intern(name));
+	}
+	
+	std::string_view view(const Handle handle) noexcept{
+		if(handle == empty_name) return std::string_view("", 0);
+		return get_pool().view(handle);
+	}
+	
+	std::size_t name_count(){
+		return get_pool().name_count();
+	}
+}
@@ -0,0 +1,81 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "parse_diagnostics.hpp"
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <string_view>
+
+namespace parse_diagnostics{
+	const char* kind_name(const Kind kind) noexcept{
+		switch(kind){
+			case Kind::InvalidDueDate:
+			return "invalid due date";
+			
+			case Kind::NestedGroup:
+			return "nested group";
+			
+			default:
+			return "unknown error";
+		}
+	}
+	
+	Collector::Collector(const std::size_t max_kept) noexcept
+	:	max_kept(max_kept),
+		invalid_due_date_count(0),
+		nested_group_count(0)
+	{
+	}
+	
+	void Collector::record(const Kind kind, const std::size_t line_number, const std::size_t byte_offset, const std::string_view text){
+		if(kind == Kind::InvalidDueDate) this->invalid_due_date_count++;
+		else this->nested_group_count++;
+		
+		if(this->kept_diagnostics.size() < this->max_kept)
+			this->kept_diagnostics.push_back({kind, line_number, byte_offset, std::string(text)});
+	}
+	
+	std::size_t Collector::count(const Kind kind) const noexcept{
+		return (kind == Kind::InvalidDueDate) ? this->invalid_due_date_count : this->nested_group_count;
+	}
+	
+	void Collector::clear() noexcept{
+		this->kept_diagnostics.clear();
+		this->invalid_due_date_count = 0;
+		this->nested_group_count = 0;
+	}
+	
+	std::string summary(const Collector& collector, const std::size_t max_listed){
+		std::string text = "tasks.txt has " + std::to_string(collector.count()) + " errors: "
+							+ std::to_string(collector.count(Kind::InvalidDueDate)) + " tasks skipped for an invalid due date, "
+							+ std::to_string(collector.count(Kind::NestedGroup)) + " nested groups fetched to the group they are in.";
+		
+		const std::vector<Diagnostic>& diagnostics = collector.diagnostics();
+		const std::size_t listed_count = std::min(max_listed, diagnostics.size());
+		for(std::size_t i = 0; i < listed_count; ++i){
+			const Diagnostic& diagnostic = diagnostics[i];
+			
+			text += '\n';
+			if(diagnostic.line_number != unknown_position)
+				text += "line " + std::to_string(diagnostic.line_number) + " (byte " + std::to_string(diagnostic.byte_offset) + "): ";
+			text += std::string(kind_name(diagnostic.kind)) + ": " + diagnostic.text;
+		}
+		
+		if(collector.count() > listed_count)
+			text += "\n...and " + std::to_string(collector.count() - listed_count) + " more.";
+		
+		return text;
+	}
+}
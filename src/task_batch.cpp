@@ -0,0 +1,404 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "task_batch.hpp"
+
+#include "Task.hpp"
+#include "task_io.hpp"
+#include "task_exchange.hpp"
+#include "parse_diagnostics.hpp"
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstddef>
+#include <utility>
+#include <fstream>
+#include <sstream>
+#include <charconv>
+#include <optional>
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+
+namespace task_batch{
+	namespace{
+		///The options and the positional arguments of a command, the first argument being the command itself.
+		struct CommandArguments{
+			std::vector<std::pair<std::string_view, const std::string*>> options;
+			std::vector<const std::string*> positional;
+			
+			///Returns the value of the option, or nullptr if it is not provided.
+			const std::string* option(const std::string_view name) const noexcept{
+				for(const auto& [option_name, value] : this->options){
+					if(option_name == name) return value;
+				}
+				return nullptr;
+			}
+		};
+		
+		///Splits the arguments after the command into the options of the names provided, which each take a value, and the positional arguments.
+		CommandArguments parse_command_arguments(const std::vector<std::string>& arguments, const std::vector<std::string_view>& option_names, 
+												const std::size_t positional_count, const char* const usage)
+		{
+			CommandArguments command_arguments;
+			for(std::size_t i = 1; i < arguments.size(); ++i){
+				const std::string& argument = arguments[i];
+				if(!argument.starts_with("--")){
+					command_arguments.positional.push_back(&argument);
+					continue;
+				}
+				
+				if(std::find(option_names.begin(), option_names.end(), argument) == option_names.end())
+					throw std::invalid_argument(arguments.front() + ": unknown option " + argument + ". Usage: " + usage);
+				if(i + 1 == arguments.size())
+					throw std::invalid_argument(arguments.front() + ": " + argument + " needs a value. Usage: " + usage);
+				
+				command_arguments.options.emplace_back(argument, &arguments[i + 1]);
+				++i;
+			}
+			
+			if(command_arguments.positional.size() != positional_count)
+				throw std::invalid_argument(arguments.front() + ": expected " + std::to_string(positional_count) + " arguments. Usage: " + usage);
+			
+			return command_arguments;
+		}
+		
+		///Throws std::invalid_argument if the name cannot be written to the task file as a task name.
+		void check_task_name(const std::string& command, const std::string& task_name){
+			if(task_name.empty())
+				throw std::invalid_argument(command + ": the task name is empty.");
+			if(task_name.find('\n') != std::string::npos)
+				throw std::invalid_argument(command + ": the task name " + task_name + " has a newline.");
+			//A line ending with the curly bracket is a group definition.
+			if(task_name.back() == '{')
+				throw std::invalid_argument(command + ": the task name " + task_name + " ends with an open curly bracket.");
+		}
+		
+		///Throws std::invalid_argument if the name cannot be written to the task file as a group name.
+		void check_group_name(const std::string& command, const std::string& group_name){
+			if(group_name.empty())
+				throw std::invalid_argument(command + ": the group name is empty.");
+			if(group_name.find('\n') != std::string::npos)
+				throw std::invalid_argument(command + ": the group name " + group_name + " has a newline.");
+		}
+		
+		///Returns the format of --format if provided, or the format of the extension of the filename.
+		task_exchange::Format get_format(const std::string& command, const std::string_view filename, const std::string* const format_name){
+			if(!format_name) return task_exchange::format_of_filename(filename);
+			
+			const std::optional<task_exchange::Format> format = task_exchange::format_from_name(*format_name);
+			if(!format)
+				throw std::invalid_argument(command + ": unknown format " + *format_name + ", the formats are tasks, csv and jsonl.");
+			return *format;
+		}
+		
+		///Returns the days of N, Nd or Nw.
+		std::chrono::days parse_day_count(const std::string& count){
+			unsigned value = 0;
+			const char* const last = count.data() + count.size();
+			const auto [unit, error] = std::from_chars(count.data(), last, value);
+			
+			const bool no_unit = unit == last;
+			const bool valid_unit = no_unit || ((unit + 1 == last) && (*unit == 'd' || *unit == 'w'));
+			if(error != std::errc() || !valid_unit)
+				throw std::invalid_argument("list: " + count + " is not a count of days (7, 7d) or weeks (2w).");
+			
+			return (!no_unit && *unit == 'w') ? std::chrono::weeks(value) : std::chrono::days(value);
+		}
+	}
+	
+	std::vector<std::string> split_arguments(const std::string_view line){
+		std::vector<std::string> arguments;
+		std::string argument;
+		bool in_argument = false;
+		bool quoted = false;
+		
+		for(std::size_t i = 0; i < line.size(); ++i){
+			const char c = line[i];
+			if(quoted){
+				if(c == '\\' && i + 1 < line.size() && (line[i + 1] == '"' || line[i + 1] == '\\')) argument += line[++i];
+				else if(c == '"') quoted = false;
+				else argument += c;
+			}
+			//'\r' for the lines of a batch written with CRLF.
+			else if(c == ' ' || c == '\t' || c == '\r'){
+				if(in_argument) arguments.push_back(std::move(argument));
+				argument.clear();
+				in_argument = false;
+			}
+			else{
+				if(c == '"') quoted = true;
+				else argument += c;
+				in_argument = true;
+			}
+		}
+		
+		if(quoted)
+			throw std::invalid_argument("a double quote is not closed.");
+		if(in_argument) arguments.push_back(std::move(argument));
+		
+		return arguments;
+	}
+	
+	Batch::Batch(std::vector<TaskGroup>&& taskgroups, const std::chrono::year_month_day& current_date, parse_diagnostics::Collector* const diagnostics)
+	:	_taskgroups(std::move(taskgroups)),
+		task_names_indexed(false),
+		current_date(current_date),
+		diagnostics(diagnostics),
+		_modified(false)
+	{
+		this->index_group_names();
+	}
+	
+	void Batch::run(const std::vector<std::string>& arguments, std::string& output){
+		if(arguments.empty())
+			throw std::invalid_argument("no command provided.");
+		
+		const std::string& command = arguments.front();
+		if(command == "list") this->list(arguments, output);
+		else if(command == "add") this->add(arguments);
+		else if(command == "import") this->import_taskfile(arguments);
+		else if(command == "export") this->export_taskfile(arguments, output);
+		else if(command == "group") this->group(arguments);
+		else throw std::invalid_argument("unknown command " + command + ".");
+	}
+	
+	const std::vector<TaskGroup>& Batch::taskgroups(){
+		this->drop_removed_groups();
+		return this->_taskgroups;
+	}
+	
+	void Batch::list(const std::vector<std::string>& arguments, std::string& output) const{
+		const CommandArguments command_arguments = parse_command_arguments(arguments, {"--due-within", "--group"}, 0, 
+																			"list [--due-within <N>d|<N>w] [--group <group name>]");
+		std::optional<std::chrono::sys_days> last_due_date;
+		if(const std::string* const due_within = command_arguments.option("--due-within"))
+			last_due_date = std::chrono::sys_days(this->current_date) + parse_day_count(*due_within);
+		const std::string* const group_name = command_arguments.option("--group");
+		
+		std::vector<std::pair<const TaskGroup*, const Task*>> listed_tasks;
+		for(const TaskGroup& taskgroup : this->_taskgroups){
+			if(group_name && taskgroup.group_name != *group_name) continue;
+			
+			for(const Task& task : taskgroup.tasks){
+				if(!last_due_date || std::chrono::sys_days(task.due_date()) <= *last_due_date)
+					listed_tasks.emplace_back(&taskgroup, &task);
+			}
+		}
+		
+		//stable, so the tasks due on the same day stay in the order of the task file.
+		std::stable_sort(listed_tasks.begin(), listed_tasks.end(), [](const auto& lhs, const auto& rhs){
+			return Task::due_date_is_earlier(*lhs.second, *rhs.second);
+		});
+		
+		for(const auto& [taskgroup, task] : listed_tasks){
+			output += ymd_to_string(task->due_date());
+			output += '\t';
+			output += taskgroup->group_name;
+			output += '\t';
+			output += task->name();
+			output += '\n';
+		}
+	}
+	
+	void Batch::add(const std::vector<std::string>& arguments){
+		const CommandArguments command_arguments = parse_command_arguments(arguments, {"--group"}, 2, "add [--group <group name>] <yyyy/m/d> <task name>");
+		const std::string& due_date_str = *command_arguments.positional[0];
+		const std::string& task_name = *command_arguments.positional[1];
+		const std::string* const group_name = command_arguments.option("--group");
+		
+		const YmdParseResult due_date = parse_ymd(due_date_str);
+		if(!due_date.ok())
+			throw std::invalid_argument("add: " + due_date_str + ": " + ymd_parse_status_message(due_date.status));
+		check_task_name("add", task_name);
+		if(group_name) check_group_name("add", *group_name);
+		
+		Task task(due_date.ymd, task_name, this->current_date);
+		const std::size_t group_index = group_name ? this->find_or_add_group(*group_name) : this->_taskgroups.size();
+		if(group_name) this->_taskgroups[group_index].tasks.push_back(std::move(task));
+		else this->_taskgroups.push_back({"", {std::move(task)}});
+		this->index_task(task_name, group_index);
+		this->_modified = true;
+	}
+	
+	void Batch::import_taskfile(const std::vector<std::string>& arguments){
+		const CommandArguments command_arguments = parse_command_arguments(arguments, {"--format"}, 1, "import [--format tasks|csv|jsonl] <filename>");
+		const std::string& filename = *command_arguments.positional[0];
+		const task_exchange::Format format = get_format("import", filename, command_arguments.option("--format"));
+		
+		std::ifstream file(filename, std::ios::binary);
+		if(!file.is_open())
+			throw std::runtime_error("import: " + filename + " cannot be opened.");
+		
+		//the groups are added as they are read, and removed if the file turns out invalid, so the groups are left as is.
+		const std::size_t previous_taskgroup_count = this->_taskgroups.size();
+		try{
+			task_exchange::read(file, format, [&](TaskGroup&& taskgroup){this->_taskgroups.push_back(std::move(taskgroup));}, this->diagnostics);
+		}
+		catch(const std::ios_base::failure& file_io_error){
+			this->_taskgroups.resize(previous_taskgroup_count);
+			throw;
+		}
+		catch(const std::out_of_range& no_comma){
+			this->_taskgroups.resize(previous_taskgroup_count);
+			throw std::invalid_argument("import: " + filename + " has a task line without the comma and space after its due date.");
+		}
+		catch(const std::invalid_argument& invalid_record){
+			this->_taskgroups.resize(previous_taskgroup_count);
+			throw std::invalid_argument("import: " + filename + ": " + invalid_record.what());
+		}
+		
+		//the groups of a name already in the task file are added as is, the first group of the name is still the one added to.
+		for(std::size_t i = previous_taskgroup_count; i < this->_taskgroups.size(); ++i){
+			if(!this->_taskgroups[i].group_name.empty()) this->group_indices[this->_taskgroups[i].group_name].push_back(i);
+			for(const Task& task : this->_taskgroups[i].tasks) this->index_task(std::string(task.name()), i);
+		}
+		this->_modified = true;
+	}
+	
+	void Batch::export_taskfile(const std::vector<std::string>& arguments, std::string& output){
+		const CommandArguments command_arguments = parse_command_arguments(arguments, {"--format"}, 1, "export [--format tasks|csv|jsonl] <filename>|-");
+		const std::string& filename = *command_arguments.positional[0];
+		this->drop_removed_groups();
+		
+		if(filename == "-"){
+			const task_exchange::Format format = get_format("export", "", command_arguments.option("--format"));
+			std::ostringstream exported;
+			task_exchange::write(exported, format, this->_taskgroups);
+			output += exported.view();
+			return;
+		}
+		
+		const task_exchange::Format format = get_format("export", filename, command_arguments.option("--format"));
+		std::ofstream file(filename, std::ios::binary);
+		if(!file.is_open())
+			throw std::runtime_error("export: " + filename + " cannot be opened.");
+		
+		task_exchange::write(file, format, this->_taskgroups);
+	}
+	
+	void Batch::group(const std::vector<std::string>& arguments){
+		const CommandArguments command_arguments = parse_command_arguments(arguments, {"--from"}, 2, "group [--from <group name>] <group name> <task name>");
+		const std::string& group_name = *command_arguments.positional[0];
+		const std::string& task_name = *command_arguments.positional[1];
+		const std::string* const from_group_name = command_arguments.option("--from");
+		check_group_name("group", group_name);
+		
+		if(!this->task_names_indexed) this->index_task_names();
+		
+		//only the group of --from, or the first group with a task of the name is searched, none if there is no task of the name.
+		std::size_t first_searched = this->_taskgroups.size();
+		if(from_group_name){
+			const auto from_group = this->group_indices.find(*from_group_name);
+			if(from_group == this->group_indices.end())
+				throw std::invalid_argument("group: there is no group named " + *from_group_name + ".");
+			first_searched = from_group->second.front();
+		}
+		else if(const auto task_groups = this->task_group_indices.find(task_name); task_groups != this->task_group_indices.end()){
+			first_searched = task_groups->second.front();
+		}
+		const std::size_t last_searched = std::min(first_searched + 1, this->_taskgroups.size());
+		
+		for(std::size_t i = first_searched; i < last_searched; ++i){
+			std::vector<Task>& tasks = this->_taskgroups[i].tasks;
+			const auto task = std::find_if(tasks.begin(), tasks.end(), [&](const Task& task){return task.name() == task_name;});
+			if(task == tasks.end()) continue;
+			
+			Task moved_task = std::move(*task);
+			tasks.erase(task);
+			//the group is found after the task is taken from its group, as adding the group may reallocate the groups.
+			const std::size_t group_index = this->find_or_add_group(group_name);
+			this->_taskgroups[group_index].tasks.push_back(std::move(moved_task));
+			this->unindex_task(task_name, i);
+			this->index_task(task_name, group_index);
+			
+			if(this->_taskgroups[i].tasks.empty()) this->remove_group(i);
+			this->_modified = true;
+			return;
+		}
+		
+		throw std::invalid_argument("group: there is no task named " + task_name + (from_group_name ? " in " + *from_group_name : std::string()) + ".");
+	}
+	
+	std::size_t Batch::find_or_add_group(const std::string& group_name){
+		const auto [group_indices, added] = this->group_indices.try_emplace(group_name);
+		if(added){
+			group_indices->second.push_back(this->_taskgroups.size());
+			this->_taskgroups.push_back({group_name, {}});
+		}
+		return group_indices->second.front();
+	}
+	
+	void Batch::remove_group(const std::size_t group_index){
+		const std::string& group_name = this->_taskgroups[group_index].group_name;
+		if(!group_name.empty()){
+			const auto group_indices = this->group_indices.find(group_name);
+			std::vector<std::size_t>& indices = group_indices->second;
+			indices.erase(std::lower_bound(indices.begin(), indices.end(), group_index));
+			if(indices.empty()) this->group_indices.erase(group_indices);
+		}
+		this->removed_groups.push_back(group_index);
+	}
+	
+	void Batch::drop_removed_groups(){
+		if(this->removed_groups.empty()) return;
+		
+		std::sort(this->removed_groups.begin(), this->removed_groups.end());
+		auto removed_group = this->removed_groups.begin();
+		std::size_t kept_count = 0;
+		for(std::size_t i = 0; i < this->_taskgroups.size(); ++i){
+			if(removed_group != this->removed_groups.end() && *removed_group == i){
+				++removed_group;
+				continue;
+			}
+			if(kept_count != i) this->_taskgroups[kept_count] = std::move(this->_taskgroups[i]);
+			++kept_count;
+		}
+		this->_taskgroups.erase(this->_taskgroups.begin() + kept_count, this->_taskgroups.end());
+		this->removed_groups.clear();
+		
+		this->index_group_names();
+		this->task_group_indices.clear();
+		this->task_names_indexed = false;
+	}
+	
+	void Batch::index_group_names(){
+		this->group_indices.clear();
+		for(std::size_t i = 0; i < this->_taskgroups.size(); ++i){
+			if(!this->_taskgroups[i].group_name.empty()) this->group_indices[this->_taskgroups[i].group_name].push_back(i);
+		}
+	}
+	
+	void Batch::index_task_names(){
+		this->task_group_indices.clear();
+		for(std::size_t i = 0; i < this->_taskgroups.size(); ++i){
+			for(const Task& task : this->_taskgroups[i].tasks) this->task_group_indices[std::string(task.name())].push_back(i);
+		}
+		this->task_names_indexed = true;
+	}
+	
+	void Batch::index_task(const std::string& task_name, const std::size_t group_index){
+		if(!this->task_names_indexed) return;
+		std::vector<std::size_t>& indices = this->task_group_indices[task_name];
+		indices.insert(std::upper_bound(indices.begin(), indices.end(), group_index), group_index);
+	}
+	
+	void Batch::unindex_task(const std::string& task_name, const std::size_t group_index){
+		const auto task_groups = this->task_group_indices.find(task_name);
+		std::vector<std::size_t>& indices = task_groups->second;
+		indices.erase(std::lower_bound(indices.begin(), indices.end(), group_index));
+		if(indices.empty()) this->task_group_indices.erase(task_groups);
+	}
+}
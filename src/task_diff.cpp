@@ -0,0 +1,56 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "task_diff.hpp"
+
+#include "Task.hpp"
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+namespace task_diff{
+	std::vector<Change> diff(const std::vector<TaskGroup>& old_taskgroups, const std::vector<TaskGroup>& new_taskgroups){
+		const std::size_t common_count = std::min(old_taskgroups.size(), new_taskgroups.size());
+		
+		std::size_t prefix_count = 0;
+		while(prefix_count < common_count && old_taskgroups[prefix_count] == new_taskgroups[prefix_count])
+			prefix_count++;
+		
+		//the suffix does not overlap the prefix, in either list.
+		std::size_t suffix_count = 0;
+		while(prefix_count + suffix_count < common_count 
+			&& old_taskgroups[old_taskgroups.size() - 1 - suffix_count] == new_taskgroups[new_taskgroups.size() - 1 - suffix_count])
+		{
+			suffix_count++;
+		}
+		
+		const std::size_t old_middle_count = old_taskgroups.size() - prefix_count - suffix_count;
+		const std::size_t new_middle_count = new_taskgroups.size() - prefix_count - suffix_count;
+		const std::size_t paired_count = std::min(old_middle_count, new_middle_count);
+		
+		std::vector<Change> changes;
+		for(std::size_t i = prefix_count; i < prefix_count + paired_count; ++i){
+			if(old_taskgroups[i] != new_taskgroups[i])
+				changes.push_back({Change::Type::Update, i, i});
+		}
+		
+		const std::size_t unpaired_index = prefix_count + paired_count;
+		for(std::size_t i = paired_count; i < old_middle_count; ++i)
+			changes.push_back({Change::Type::Remove, unpaired_index, 0});
+		for(std::size_t i = unpaired_index; i < prefix_count + new_middle_count; ++i)
+			changes.push_back({Change::Type::Insert, i, i});
+		
+		return changes;
+	}
+}
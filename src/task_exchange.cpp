@@ -0,0 +1,565 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "task_exchange.hpp"
+
+#include "Task.hpp"
+#include "task_io.hpp"
+#include "time_calc.hpp"
+#include "byte_scan.hpp"
+#include "parse_diagnostics.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <ostream>
+#include <istream>
+#include <optional>
+#include <algorithm>
+#include <stdexcept>
+#include <functional>
+#include <string_view>
+
+namespace task_exchange{
+	namespace{
+		///The size of the buffer of Writer before it is written to the stream.
+		constexpr std::size_t writer_flush_size = 64 * 1024;
+		constexpr std::string_view csv_header = "group_id,group,due_date,name\n";
+		
+		void append_csv_field(std::string& buffer, const std::string_view field){
+			//A field with a delimiter, quote or newline is quoted, with its quotes doubled.
+			if(byte_scan::find(field, byte_scan::ScanSet(',', '"', '\n', '\r')) == std::string_view::npos){
+				buffer += field;
+				return;
+			}
+			
+			buffer += '"';
+			for(const char c : field){
+				if(c == '"') buffer += '"';
+				buffer += c;
+			}
+			buffer += '"';
+		}
+		
+		void append_json_string(std::string& buffer, const std::string_view str){
+			constexpr const char* hex_digits = "0123456789abcdef";
+			
+			buffer += '"';
+			for(const char c : str){
+				switch(c){
+					case '"': buffer += "\\\""; break;
+					case '\\': buffer += "\\\\"; break;
+					case '\n': buffer += "\\n"; break;
+					case '\r': buffer += "\\r"; break;
+					case '\t': buffer += "\\t"; break;
+					default:
+					if(static_cast<unsigned char>(c) < 0x20){
+						buffer += "\\u00";
+						buffer += hex_digits[static_cast<unsigned char>(c) >> 4];
+						buffer += hex_digits[static_cast<unsigned char>(c) & 0xf];
+					}
+					else buffer += c;
+				}
+			}
+			buffer += '"';
+		}
+		
+		void append_utf8(std::string& buffer, const std::uint32_t code_point){
+			if(code_point < 0x80){
+				buffer += char(code_point);
+			}else if(code_point < 0x800){
+				buffer += char(0xc0 | (code_point >> 6));
+				buffer += char(0x80 | (code_point & 0x3f));
+			}else if(code_point < 0x10000){
+				buffer += char(0xe0 | (code_point >> 12));
+				buffer += char(0x80 | ((code_point >> 6) & 0x3f));
+				buffer += char(0x80 | (code_point & 0x3f));
+			}else{
+				buffer += char(0xf0 | (code_point >> 18));
+				buffer += char(0x80 | ((code_point >> 12) & 0x3f));
+				buffer += char(0x80 | ((code_point >> 6) & 0x3f));
+				buffer += char(0x80 | (code_point & 0x3f));
+			}
+		}
+		
+		std::size_t skip_json_whitespace(const std::string_view json, std::size_t i) noexcept{
+			while(i < json.size() && (json[i] == ' ' || json[i] == '\t')) ++i;
+			return i;
+		}
+		
+		///Returns the 4 hexadecimal digits at i as a number, or std::nullopt if they are not.
+		std::optional<std::uint32_t> parse_hex4(const std::string_view json, const std::size_t i) noexcept{
+			if(i + 4 > json.size()) return std::nullopt;
+			
+			std::uint32_t value = 0;
+			for(std::size_t j = i; j < i + 4; ++j){
+				const char c = json[j];
+				value <<= 4;
+				if(c >= '0' && c <= '9') value |= c - '0';
+				else if(c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+				else if(c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+				else return std::nullopt;
+			}
+			return value;
+		}
+	}
+	
+	std::optional<Format> format_from_name(const std::string_view name) noexcept{
+		if(name == "tasks") return Format::TaskFile;
+		if(name == "csv") return Format::Csv;
+		if(name == "jsonl") return Format::JsonLines;
+		return std::nullopt;
+	}
+	
+	Format format_of_filename(const std::string_view filename) noexcept{
+		if(filename.ends_with(".csv")) return Format::Csv;
+		if(filename.ends_with(".jsonl") || filename.ends_with(".ndjson")) return Format::JsonLines;
+		return Format::TaskFile;
+	}
+	
+	
+	Reader::Reader(const Format format, std::function<void(TaskGroup&&)> taskgroup_callback, parse_diagnostics::Collector* const diagnostics)
+	:	format(format),
+		taskgroup_callback(std::move(taskgroup_callback)),
+		diagnostics(diagnostics),
+		current_date(get_current_ymd()),
+		header_read(format != Format::Csv),
+		fetching(false),
+		fetching_by_group_id(false),
+		record_unfinished(false),
+		unfinished_quote_count(0),
+		record_offset(0),
+		record_line_number(0),
+		fed_size(0),
+		line_number(0)
+	{
+		if(format == Format::TaskFile)
+			throw std::invalid_argument("task_exchange.cpp: Reader::Reader(): task files are parsed with TaskFileParser.");
+	}
+	
+	void Reader::feed(const char* const data, const std::size_t size){
+		const std::string_view chunk(data, size);
+		const std::size_t chunk_offset = this->fed_size;
+		this->fed_size += size;
+		
+		const auto count_quotes = [&](const std::string_view line) -> std::size_t{
+			return (this->format == Format::Csv) ? std::count(line.begin(), line.end(), '"') : 0;
+		};
+		
+		std::string_view::size_type line_start = 0;
+		while(true){
+			const std::string_view::size_type line_end = byte_scan::find(chunk, '\n', line_start);
+			if(line_end == std::string_view::npos) break;
+			
+			const std::string_view line = chunk.substr(line_start, line_end - line_start);
+			const std::size_t quote_count = this->unfinished_quote_count + count_quotes(line);
+			
+			//Most records are a line in the chunk, which are parsed in place.
+			if(!this->record_unfinished && quote_count % 2 == 0){
+				this->record_line_number = this->line_number;
+				this->parse_record(line, chunk_offset + line_start);
+			}else{
+				if(!this->record_unfinished){
+					this->record_offset = chunk_offset + line_start;
+					this->record_line_number = this->line_number;
+				}
+				this->unfinished_record.append(line);
+				
+				//An odd count of quotes means the newline is in a quoted field.
+				if(quote_count % 2 == 0){
+					this->parse_record(this->unfinished_record, this->record_offset);
+					this->unfinished_record.clear();
+					this->record_unfinished = false;
+					this->unfinished_quote_count = 0;
+				}else{
+					this->unfinished_record += '\n';
+					this->record_unfinished = true;
+					this->unfinished_quote_count = quote_count;
+				}
+			}
+			
+			line_start = line_end + 1;
+			this->line_number++;
+		}
+		
+		if(line_start < chunk.size()){
+			if(!this->record_unfinished){
+				this->record_offset = chunk_offset + line_start;
+				this->record_line_number = this->line_number;
+				this->record_unfinished = true;
+			}
+			const std::string_view rest = chunk.substr(line_start);
+			this->unfinished_record.append(rest);
+			this->unfinished_quote_count += count_quotes(rest);
+		}
+	}
+	
+	void Reader::finish(){
+		if(this->record_unfinished){
+			if(this->unfinished_quote_count % 2 != 0) this->throw_invalid_record("a double quote is not closed.");
+			
+			this->parse_record(this->unfinished_record, this->record_offset);
+			this->unfinished_record.clear();
+			this->record_unfinished = false;
+			this->unfinished_quote_count = 0;
+		}
+		this->save_fetching_taskgroup();
+		
+		this->header_read = (this->format != Format::Csv);
+		this->fed_size = 0;
+		this->line_number = 0;
+	}
+	
+	void Reader::parse_record(std::string_view record, const std::size_t offset){
+		if(!record.empty() && record.back() == '\r') record.remove_suffix(1);
+		if(record.find_first_not_of(" \t") == std::string_view::npos) return;
+		
+		if(!this->header_read){
+			this->parse_csv_header(record);
+			this->header_read = true;
+			return;
+		}
+		
+		const Record parsed_record = (this->format == Format::Csv) ? this->parse_csv_record(record) : this->parse_json_record(record);
+		this->fetch_record(parsed_record, record, offset);
+	}
+	
+	std::size_t Reader::split_csv_fields(const std::string_view record){
+		std::size_t field_count = 0;
+		std::size_t i = 0;
+		while(true){
+			if(field_count == this->unescaped_fields.size()) this->unescaped_fields.emplace_back();
+			std::string& field = this->unescaped_fields[field_count++];
+			field.clear();
+			
+			if(i < record.size() && record[i] == '"'){
+				++i;
+				while(true){
+					const std::string_view::size_type quote = record.find('"', i);
+					if(quote == std::string_view::npos) this->throw_invalid_record("a double quote is not closed.");
+					
+					field.append(record.substr(i, quote - i));
+					i = quote + 1;
+					//a doubled quote is a quote in the field.
+					if(i < record.size() && record[i] == '"'){
+						field += '"';
+						++i;
+					}
+					else break;
+				}
+				
+				if(i < record.size() && record[i] != ',') this->throw_invalid_record("a quoted field continues after its closing double quote.");
+			}else{
+				const std::string_view::size_type comma = byte_scan::find(record, ',', i);
+				const std::size_t field_end = (comma == std::string_view::npos) ? record.size() : comma;
+				field.assign(record.substr(i, field_end - i));
+				i = field_end;
+			}
+			
+			if(i >= record.size()) return field_count;
+			//skips the comma.
+			++i;
+		}
+	}
+	
+	void Reader::parse_csv_header(std::string_view record){
+		//The byte order mark written by some spreadsheets.
+		if(record.starts_with("\xef\xbb\xbf")) record.remove_prefix(3);
+		
+		const std::size_t field_count = this->split_csv_fields(record);
+		for(std::size_t i = 0; i < field_count; ++i){
+			const std::string& field = this->unescaped_fields[i];
+			if(field == "group_id") this->group_id_column = i;
+			else if(field == "group") this->group_column = i;
+			else if(field == "due_date") this->due_date_column = i;
+			else if(field == "name") this->name_column = i;
+		}
+		
+		if(!this->due_date_column || !this->name_column) this->throw_invalid_record("the header has no due_date or name column.");
+	}
+	
+	Reader::Record Reader::parse_csv_record(const std::string_view record){
+		const std::size_t field_count = this->split_csv_fields(record);
+		const auto field = [&](const std::optional<std::size_t>& column) -> std::optional<std::string_view>{
+			if(!column || *column >= field_count) return std::nullopt;
+			return std::string_view(this->unescaped_fields[*column]);
+		};
+		
+		return {field(this->group_id_column), field(this->group_column).value_or(""), field(this->due_date_column), field(this->name_column)};
+	}
+	
+	Reader::Record Reader::parse_json_record(const std::string_view record){
+		//The fields are indices of this->unescaped_fields until every string is unescaped, as adding a string may move the others.
+		constexpr std::size_t no_field = std::string_view::npos;
+		std::size_t group_id_field = no_field, group_field = no_field, due_date_field = no_field, name_field = no_field;
+		std::optional<std::string_view> numeric_group_id;
+		std::size_t field_count = 0;
+		
+		const auto parse_string = [&](std::size_t& i) -> std::size_t{
+			if(field_count == this->unescaped_fields.size()) this->unescaped_fields.emplace_back();
+			std::string& str = this->unescaped_fields[field_count];
+			str.clear();
+			
+			//i is after the opening quote.
+			while(true){
+				const std::string_view::size_type special = byte_scan::find(record, byte_scan::ScanSet('"', '\\'), i);
+				if(special == std::string_view::npos) this->throw_invalid_record("a string is not closed.");
+				
+				str.append(record.substr(i, special - i));
+				i = special + 1;
+				if(record[special] == '"') break;
+				
+				if(i == record.size()) this->throw_invalid_record("a string is not closed.");
+				const char escaped = record[i++];
+				switch(escaped){
+					case '"': case '\\': case '/': str += escaped; break;
+					case 'b': str += '\b'; break;
+					case 'f': str += '\f'; break;
+					case 'n': str += '\n'; break;
+					case 'r': str += '\r'; break;
+					case 't': str += '\t'; break;
+					case 'u':{
+						std::optional<std::uint32_t> code_point = parse_hex4(record, i);
+						if(!code_point) this->throw_invalid_record("an invalid \\u escape.");
+						i += 4;
+						
+						//a code point past the basic multilingual plane is a pair of surrogates.
+						if(*code_point >= 0xd800 && *code_point < 0xdc00){
+							const std::optional<std::uint32_t> low_surrogate = (record.substr(i, 2) == "\\u") ? parse_hex4(record, i + 2) : std::nullopt;
+							if(!low_surrogate || *low_surrogate < 0xdc00 || *low_surrogate >= 0xe000) this->throw_invalid_record("an unpaired surrogate.");
+							code_point = 0x10000 + ((*code_point - 0xd800) << 10) + (*low_surrogate - 0xdc00);
+							i += 6;
+						}
+						append_utf8(str, *code_point);
+						break;
+					}
+					default:
+					this->throw_invalid_record("an invalid escape in a string.");
+				}
+			}
+			return field_count++;
+		};
+		
+		std::size_t i = skip_json_whitespace(record, 0);
+		if(i == record.size() || record[i] != '{') this->throw_invalid_record("the record is not a JSON object.");
+		i = skip_json_whitespace(record, i + 1);
+		
+		bool object_closed = (i < record.size() && record[i] == '}');
+		if(object_closed) ++i;
+		while(!object_closed){
+			if(i == record.size() || record[i] != '"') this->throw_invalid_record("expected the name of a member.");
+			++i;
+			const std::size_t key_field = parse_string(i);
+			
+			i = skip_json_whitespace(record, i);
+			if(i == record.size() || record[i] != ':') this->throw_invalid_record("expected a colon after the name of a member.");
+			i = skip_json_whitespace(record, i + 1);
+			if(i == record.size()) this->throw_invalid_record("expected a value.");
+			
+			const std::string key = this->unescaped_fields[key_field];
+			if(record[i] == '"'){
+				++i;
+				const std::size_t value_field = parse_string(i);
+				if(key == "group_id"){group_id_field = value_field; numeric_group_id.reset();}
+				else if(key == "group") group_field = value_field;
+				else if(key == "due_date") due_date_field = value_field;
+				else if(key == "name") name_field = value_field;
+			}else if(record[i] == '{' || record[i] == '['){
+				this->throw_invalid_record("objects and arrays are not supported as values.");
+			}else{
+				//a number, true, false or null, which is only kept as group_id.
+				const std::string_view::size_type value_end = std::min(record.find_first_of(",} \t", i), record.size());
+				const std::string_view value = record.substr(i, value_end - i);
+				if(key == "group_id"){
+					group_id_field = no_field;
+					if(value == "null") numeric_group_id.reset();
+					else numeric_group_id = value;
+				}
+				i = value_end;
+			}
+			
+			i = skip_json_whitespace(record, i);
+			if(i == record.size()) this->throw_invalid_record("the object is not closed.");
+			if(record[i] == '}') object_closed = true;
+			else if(record[i] != ',') this->throw_invalid_record("expected a comma or the end of the object.");
+			i = skip_json_whitespace(record, i + 1);
+		}
+		
+		if(skip_json_whitespace(record, i) != record.size()) this->throw_invalid_record("characters after the end of the object.");
+		
+		const auto field = [&](const std::size_t field_index) -> std::optional<std::string_view>{
+			if(field_index == no_field) return std::nullopt;
+			return std::string_view(this->unescaped_fields[field_index]);
+		};
+		const std::optional<std::string_view> group_id = numeric_group_id ? numeric_group_id : field(group_id_field);
+		return {group_id, field(group_field).value_or(""), field(due_date_field), field(name_field)};
+	}
+	
+	void Reader::fetch_record(const Record& record, const std::string_view record_text, const std::size_t offset){
+		if(!record.due_date || !record.name) this->throw_invalid_record("the record has no due_date or name.");
+		//the same restrictions as the task names of the GUI, which would be a group definition or break the line in the task file.
+		if(record.name->empty() || record.name->back() == '{' || record.name->find('\n') != std::string_view::npos)
+			this->throw_invalid_record("the name is empty, ends with an open curly bracket or has a newline.");
+		if(record.group_name.find('\n') != std::string_view::npos)
+			this->throw_invalid_record("the group name has a newline.");
+		
+		const bool same_group = this->fetching && (record.group_id.has_value() == this->fetching_by_group_id)
+								&& (record.group_id ? (*record.group_id == this->fetching_group_id) 
+													: (!record.group_name.empty() && record.group_name == this->fetching_taskgroup.group_name));
+		if(!same_group){
+			this->save_fetching_taskgroup();
+			this->fetching = true;
+			this->fetching_by_group_id = record.group_id.has_value();
+			this->fetching_group_id.assign(record.group_id.value_or(""));
+			this->fetching_taskgroup.group_name.assign(record.group_name);
+		}
+		
+		//yyyy-mm-dd is converted to the yyyy/mm/dd of parse_ymd().
+		std::string_view due_date_str = *record.due_date;
+		char slashed_due_date[16];
+		if(due_date_str.size() <= sizeof(slashed_due_date) && due_date_str.find('-') != std::string_view::npos){
+			std::replace_copy(due_date_str.begin(), due_date_str.end(), slashed_due_date, '-', '/');
+			due_date_str = std::string_view(slashed_due_date, due_date_str.size());
+		}
+		
+		const YmdParseResult due_date = parse_ymd(due_date_str);
+		if(!due_date.ok()){
+			if(this->diagnostics){
+				this->diagnostics->record(parse_diagnostics::Kind::InvalidDueDate, this->record_line_number + 1, offset, record_text);
+			}else{
+				const std::string msg = std::string(__FILE__) + ":" + std::to_string(__LINE__) + ": Task " + std::string(*record.name) + " due to invalid due date.";
+				task_io_report::alert(msg.c_str());
+			}
+			return;
+		}
+		
+		this->fetching_taskgroup.tasks.emplace_back(due_date.ymd, *record.name, this->current_date);
+	}
+	
+	void Reader::save_fetching_taskgroup(){
+		if(this->fetching && !this->fetching_taskgroup.tasks.empty())
+			this->taskgroup_callback(std::move(this->fetching_taskgroup));
+		
+		this->fetching_taskgroup = TaskGroup();
+		this->fetching = false;
+	}
+	
+	void Reader::throw_invalid_record(const std::string& message) const{
+		throw std::invalid_argument("line " + std::to_string(this->record_line_number + 1) + ": " + message);
+	}
+	
+	
+	Writer::Writer(std::ostream& stream, const Format format)
+	:	stream(stream), format(format), group_id(0)
+	{
+		if(format == Format::TaskFile)
+			throw std::invalid_argument("task_exchange.cpp: Writer::Writer(): task files are written with taskgroups_to_str().");
+		
+		this->buffer.reserve(writer_flush_size + 1024);
+		if(format == Format::Csv) this->buffer += csv_header;
+	}
+	
+	Writer::~Writer() noexcept{
+		if(!this->buffer.empty()) this->stream.write(this->buffer.data(), this->buffer.size());
+	}
+	
+	void Writer::write(const TaskGroup& taskgroup){
+		const std::string group_id_str = std::to_string(this->group_id++);
+		
+		for(const Task& task : taskgroup.tasks){
+			if(this->format == Format::Csv){
+				this->buffer += group_id_str;
+				this->buffer += ',';
+				append_csv_field(this->buffer, taskgroup.group_name);
+				this->buffer += ',';
+				this->buffer += ymd_to_string(task.due_date());
+				this->buffer += ',';
+				append_csv_field(this->buffer, task.name());
+				this->buffer += '\n';
+			}else{
+				this->buffer += "{\"group_id\":";
+				this->buffer += group_id_str;
+				this->buffer += ",\"group\":";
+				append_json_string(this->buffer, taskgroup.group_name);
+				this->buffer += ",\"due_date\":\"";
+				this->buffer += ymd_to_string(task.due_date());
+				this->buffer += "\",\"name\":";
+				append_json_string(this->buffer, task.name());
+				this->buffer += "}\n";
+			}
+			
+			if(this->buffer.size() >= writer_flush_size) this->flush();
+		}
+	}
+	
+	void Writer::flush(){
+		this->stream.write(this->buffer.data(), this->buffer.size());
+		this->buffer.clear();
+		
+		if(!this->stream)
+			throw std::ios_base::failure("task_exchange.cpp: Writer::flush(): the stream could not be written.");
+	}
+	
+	
+	void read(std::istream& stream, const Format format, std::function<void(TaskGroup&&)> taskgroup_callback, parse_diagnostics::Collector* const diagnostics){
+		//Task files are parsed entirely before the callback, as TaskFileParser returns the groups at the end.
+		if(format == Format::TaskFile){
+			std::vector<TaskGroup> taskgroups;
+			try{
+				taskgroups = get_tasks_from_stream(stream, task_io_internal::default_nested_group_callback, diagnostics);
+			}
+			catch(const std::ios_base::failure& stream_error) {throw;}
+			
+			for(TaskGroup& taskgroup : taskgroups) taskgroup_callback(std::move(taskgroup));
+			return;
+		}
+		
+		constexpr std::size_t chunk_size = 64 * 1024;
+		std::unique_ptr<char[]> chunk(new char[chunk_size]);
+		
+		Reader reader(format, std::move(taskgroup_callback), diagnostics);
+		while(stream){
+			stream.read(chunk.get(), chunk_size);
+			reader.feed(chunk.get(), stream.gcount());
+		}
+		
+		if(stream.bad())
+			throw std::ios_base::failure("task_exchange.cpp: read(): stream lost integrity while reading.");
+		
+		reader.finish();
+	}
+	
+	std::vector<TaskGroup> read(std::istream& stream, const Format format, parse_diagnostics::Collector* const diagnostics){
+		std::vector<TaskGroup> taskgroups;
+		read(stream, format, [&](TaskGroup&& taskgroup){taskgroups.push_back(std::move(taskgroup));}, diagnostics);
+		return taskgroups;
+	}
+	
+	void write(std::ostream& stream, const Format format, const std::vector<TaskGroup>& taskgroups){
+		if(format == Format::TaskFile){
+			const std::string buffer = taskgroups_to_str(taskgroups);
+			stream.write(buffer.data(), buffer.size());
+			if(!stream)
+				throw std::ios_base::failure("task_exchange.cpp: write(): the stream could not be written.");
+			return;
+		}
+		
+		Writer writer(stream, format);
+		for(const TaskGroup& taskgroup : taskgroups) writer.write(taskgroup);
+		writer.flush();
+	}
+}
@@ -0,0 +1,210 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "task_index.hpp"
+
+#include "Task.hpp"
+#include "task_io.hpp"
+#include "byte_scan.hpp"
+#include "task_journal.hpp"
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+
+namespace task_index{
+	std::vector<Span> build(const std::string_view task_file){
+		using LineType = task_io_internal::ParsedLine::Type;
+		constexpr std::int32_t no_task_yet = std::numeric_limits<std::int32_t>::max();
+
+		std::vector<Span> spans;
+		std::size_t span_start = 0;
+		std::size_t span_line_number = 0;
+		//The line after the one being classified, where the span saved after the line starts.
+		std::size_t line_number = 0;
+		std::int32_t nearest_due_date = no_task_yet;
+
+		//The state of TaskFileParser::fetch_line(), without the group being fetched itself.
+		std::size_t fetched_task_line_count = 0;
+		bool fetching_group = false;
+		bool last_line_is_task = false;
+
+		//The equivalent of TaskFileParser::save_fetching_taskgroup(), the parser is back to its initial state after the span.
+		const auto save_span = [&](const std::size_t span_end){
+			if(fetched_task_line_count == 0) return;
+
+			spans.push_back({span_start, span_end - span_start, (nearest_due_date == no_task_yet) ? no_due_date : nearest_due_date, span_line_number});
+			span_start = span_end;
+			span_line_number = line_number;
+			nearest_due_date = no_task_yet;
+			fetched_task_line_count = 0;
+		};
+
+		std::size_t line_start = 0;
+		while(line_start < task_file.size()){
+			std::size_t line_end = byte_scan::find(task_file, '\n', line_start);
+			if(line_end == std::string_view::npos) line_end = task_file.size();
+			const std::size_t next_line_start = std::min(line_end + 1, task_file.size());
+
+			const std::string_view line = task_file.substr(line_start, line_end - line_start);
+			line_start = next_line_start;
+			line_number++;
+			if(line.empty()) continue;
+
+			const task_io_internal::ScannedLine scanned_line = task_io_internal::scan_line(line);
+			last_line_is_task = false;
+
+			//A nested group definition is skipped by the parser.
+			if(scanned_line.type == LineType::GroupDefinition && fetching_group) continue;
+
+			switch(scanned_line.type){
+				case LineType::GroupDefinition:
+				fetching_group = true;
+				continue;
+
+				case LineType::ScopeEnd:
+				fetching_group = false;
+				break;
+
+				case LineType::Task:
+				nearest_due_date = std::min(nearest_due_date, std::int32_t(std::chrono::sys_days(scanned_line.due_date).time_since_epoch().count()));
+				fetched_task_line_count++;
+				last_line_is_task = true;
+				break;
+
+				case LineType::InvalidTask:
+				fetched_task_line_count++;
+				last_line_is_task = true;
+				break;
+
+				case LineType::MissingComma:
+				throw std::out_of_range("task_index.cpp: build(): task line has no comma and space after its due date.");
+			}
+
+			if(!fetching_group) save_span(next_line_start);
+		}
+
+		//TaskFileParser::finish() saves a group without a scope end if the last line is a task.
+		if(fetching_group && last_line_is_task) save_span(task_file.size());
+
+		return spans;
+	}
+
+	TaskGroup load(const std::string_view task_file, const Span& span,
+					void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&),
+					parse_diagnostics::Collector* const diagnostics)
+	{
+		TaskFileParser parser(nested_group_callback, diagnostics);
+		parser.start_at(span.offset, span.line_number);
+		parser.feed(task_file.data() + span.offset, span.size);
+		std::vector<TaskGroup> taskgroups = parser.finish();
+
+		//A span parses to a single group by how it is built.
+		return taskgroups.empty() ? TaskGroup() : std::move(taskgroups.front());
+	}
+
+	LazyTaskFile index(std::string&& task_file){
+		LazyTaskFile lazy_task_file;
+		lazy_task_file.text = std::move(task_file);
+
+		const std::vector<Span> spans = build(lazy_task_file.text);
+		lazy_task_file.taskgroups.reserve(spans.size());
+		for(const Span& span : spans)
+			lazy_task_file.taskgroups.push_back({std::nullopt, span});
+
+		return lazy_task_file;
+	}
+
+	bool apply(LazyTaskFile& task_file, const task_journal::Operation& operation,
+				void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&),
+				parse_diagnostics::Collector* const diagnostics)
+	{
+		using task_journal::Operation;
+		std::vector<LazyTaskGroup>& taskgroups = task_file.taskgroups;
+
+		if(operation.type == Operation::Type::Add){
+			taskgroups.push_back({operation.taskgroup, {0, 0, no_due_date}});
+			return true;
+		}
+		if(operation.index >= taskgroups.size()) return false;
+
+		LazyTaskGroup& taskgroup = taskgroups[operation.index];
+		switch(operation.type){
+			case Operation::Type::Modify:
+			taskgroup.taskgroup = operation.taskgroup;
+			return true;
+
+			case Operation::Type::Delete:
+			taskgroups.erase(taskgroups.begin() + operation.index);
+			return true;
+
+			case Operation::Type::Rename:
+			if(!taskgroup.taskgroup) taskgroup.taskgroup = load(task_file.text, taskgroup.span, nested_group_callback, diagnostics);
+			taskgroup.taskgroup->group_name = operation.taskgroup.group_name;
+			return true;
+
+			default:
+			return false;
+		}
+	}
+
+	void as_loaded_from_task_file(LazyTaskFile& task_file,
+								void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&),
+								parse_diagnostics::Collector* const diagnostics)
+	{
+		std::vector<LazyTaskGroup> loaded_taskgroups;
+		loaded_taskgroups.reserve(task_file.taskgroups.size());
+
+		//The same as task_journal::as_loaded_from_task_file(), for the loaded groups.
+		std::optional<std::string> lent_group_name;
+		for(LazyTaskGroup& taskgroup : task_file.taskgroups){
+			//a group with a valid due date has a task, only the others can be without tasks.
+			if(!taskgroup.taskgroup && !lent_group_name && taskgroup.span.nearest_due_date != no_due_date){
+				loaded_taskgroups.push_back(std::move(taskgroup));
+				continue;
+			}
+
+			if(!taskgroup.taskgroup) taskgroup.taskgroup = load(task_file.text, taskgroup.span, nested_group_callback, diagnostics);
+			if(taskgroup.taskgroup->tasks.empty()){
+				lent_group_name = std::move(taskgroup.taskgroup->group_name);
+				continue;
+			}
+
+			if(taskgroup.taskgroup->tasks.size() == 1) taskgroup.taskgroup->group_name = lent_group_name.value_or("");
+			lent_group_name.reset();
+			loaded_taskgroups.push_back(std::move(taskgroup));
+		}
+
+		task_file.taskgroups = std::move(loaded_taskgroups);
+	}
+
+	std::vector<TaskGroup> to_taskgroups(const LazyTaskFile& task_file,
+										void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&),
+										parse_diagnostics::Collector* const diagnostics)
+	{
+		std::vector<TaskGroup> taskgroups;
+		taskgroups.reserve(task_file.taskgroups.size());
+
+		for(const LazyTaskGroup& taskgroup : task_file.taskgroups){
+			if(taskgroup.taskgroup) taskgroups.push_back(*taskgroup.taskgroup);
+			else taskgroups.push_back(load(task_file.text, taskgroup.span, nested_group_callback, diagnostics));
+		}
+
+		return taskgroups;
+	}
+}
@@ -14,16 +14,65 @@ You should have received a copy of the GNU General Public License along with Wor
 
 #include "Task.hpp"
 #include "time_calc.hpp"
+#include "byte_scan.hpp"
+#include "task_index.hpp"
+#include "mapped_file.hpp"
+#include "task_journal.hpp"
+#include "task_snapshot.hpp"
+#include "parse_diagnostics.hpp"
 
-#include <FL/fl_ask.H>
-
+#include <array>
+#include <atomic>
 #include <memory>
+#include <thread>
 #include <vector>
 #include <string>
 #include <chrono>
+#include <limits>
+#include <cstdint>
+#include <cstring>
 #include <utility>
 #include <fstream>
+#include <iostream>
+#include <charconv>
+#include <optional>
+#include <algorithm>
+#include <exception>
+#include <filesystem>
 #include <stdexcept>
+#include <string_view>
+
+namespace task_io_report{
+	namespace{
+		void write_to_cerr(const char* const message){
+			std::cerr << message << '\n';
+		}
+		
+		bool never_retry(const char* const question){
+			std::cerr << question << " (not retried)\n";
+			return false;
+		}
+		
+		std::atomic<AlertFunction> alert_function = write_to_cerr;
+		std::atomic<RetryFunction> retry_function = never_retry;
+	}
+	
+	void set_alert_function(const AlertFunction alert_function) noexcept{
+		task_io_report::alert_function = alert_function;
+	}
+	
+	void set_retry_function(const RetryFunction retry_function) noexcept{
+		task_io_report::retry_function = retry_function;
+	}
+	
+	void alert(const char* const message){
+		task_io_report::alert_function.load()(message);
+	}
+	
+	bool ask_retry(const char* const question){
+		return task_io_report::retry_function.load()(question);
+	}
+}
 
 namespace task_io_internal{
 	TaskStr::TaskStr(const std::string& due_date, const std::string& name)
@@ -58,27 +107,27 @@ namespace task_io_internal{
 	}
 
 	std::vector<std::string> buffer_to_separated_lines(const file_buffer& buffer){
-		const char* const data = buffer.first.get();
-		const int character_count = buffer.second;
+		const std::vector<std::string_view> line_views = buffer_to_line_views(std::string_view(buffer.first.get(), buffer.second));
+		return std::vector<std::string>(line_views.begin(), line_views.end());
+	}
+	
+	std::vector<std::string_view> buffer_to_line_views(const std::string_view buffer){
+		std::vector<std::string_view> lines;
+		//a task line is usually around 20 characters, so this saves most of the reallocation without scanning the buffer twice.
+		lines.reserve(buffer.size() / 20 + 1);
 		
-		std::vector<std::string> lines;
-		lines.reserve(20);
-		std::string fetch_line;
-
-		for(auto i = 0; i < character_count; ++i){
-			const char c = data[i];
+		std::string_view::size_type line_start = 0;
+		while(line_start < buffer.size()){
+			std::string_view::size_type line_end = byte_scan::find(buffer, '\n', line_start);
+			if(line_end == std::string_view::npos) line_end = buffer.size();
 			
-			if(c != '\n') fetch_line += c;
+			if(line_end != line_start)
+				lines.push_back(buffer.substr(line_start, line_end - line_start));
 			
-			const bool end_of_file = ((i+1) == character_count);
-			
-			if((c == '\n' || end_of_file) && !fetch_line.empty()){
-				lines.emplace_back(fetch_line);
-				fetch_line.clear();
-			}
+			//+1 for skipping the newline character.
+			line_start = line_end + 1;
 		}
 		
-		lines.shrink_to_fit();
 		return lines;
 	}
 	
@@ -86,38 +135,54 @@ namespace task_io_internal{
 										const std::string& first_taskgroup_name, const std::string& second_taskgroup_name)
 		{
 		const std::string msg = std::string(callsite_filename) + ":" + std::to_string(callsite_line) + ": Detected nested task group " + second_taskgroup_name + ". Tasks will be in  " + first_taskgroup_name + ".";
-		fl_alert(msg.c_str());
+		task_io_report::alert(msg.c_str());
 	}
 
 	
 	TaskStr line_to_TaskStr(const std::string& line){
-		std::string date_str; date_str.reserve(10);
-		std::string name_str; name_str.reserve(20);
-		
-		const auto line_length = line.size();
-		auto date_str_end_index = line_length;
-		
-		for(std::size_t i = 0; i < line_length; ++i){
-			if(line[i] == ','){
-				date_str_end_index = i;
-				break;
-			}
-			else date_str += line[i];
-		}
+		const TaskStrView taskstr_view = line_to_TaskStrView(line);
+		return {std::string(taskstr_view.due_date), std::string(taskstr_view.name)};
+	}
+	
+	TaskStrView line_to_TaskStrView(const std::string_view line){
+		auto date_str_end_index = byte_scan::find(line, ',');
+		if(date_str_end_index == std::string_view::npos) date_str_end_index = line.size();
 		
 		//+2 for skipping the comma then space. starts at the first character of the task name.
-		name_str += line.substr(date_str_end_index+2, line_length);	
-		return {date_str, name_str};
+		return {line.substr(0, date_str_end_index), line.substr(date_str_end_index+2)};
 	}
 
 	std::vector<TaskStrGroup> lines_to_TaskStrGroup(const std::vector<std::string>& lines, 
-													void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&))
+													void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&),
+													parse_diagnostics::Collector* const diagnostics)
 	{
-		//this keeps all the TaskStrGroups fetched, which each can either be a single task in TaskStrGroup or a multiple.
+		const std::vector<std::string_view> line_views(lines.begin(), lines.end());
+		const std::vector<TaskStrViewGroup> taskstr_view_groups = lines_to_TaskStrViewGroup(line_views, nested_group_callback, diagnostics);
+		
 		std::vector<TaskStrGroup> task_str_groups; 
+		task_str_groups.reserve(taskstr_view_groups.size());
+		
+		for(const TaskStrViewGroup& taskstr_view_group : taskstr_view_groups){
+			TaskStrGroup& task_str_group = task_str_groups.emplace_back();
+			task_str_group.group_name = taskstr_view_group.group_name;
+			task_str_group.taskstrs.reserve(taskstr_view_group.taskstrs.size());
+			
+			for(const TaskStrView& taskstr_view : taskstr_view_group.taskstrs)
+				task_str_group.taskstrs.emplace_back(std::string(taskstr_view.due_date), std::string(taskstr_view.name));
+		}
+		
+		return task_str_groups;
+	}
+
+	std::vector<TaskStrViewGroup> lines_to_TaskStrViewGroup(const std::vector<std::string_view>& lines, 
+															void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&),
+															parse_diagnostics::Collector* const diagnostics)
+	{
+		//this keeps all the TaskStrViewGroups fetched, which each can either be a single task in TaskStrViewGroup or a multiple.
+		std::vector<TaskStrViewGroup> task_str_groups; 
 		task_str_groups.reserve(lines.size());
 		
-		TaskStrGroup fetching_taskstr_group;
+		TaskStrViewGroup fetching_taskstr_group;
 		
 		bool fetching_group = false;
 		const std::size_t line_count = lines.size();
@@ -131,7 +196,7 @@ namespace task_io_internal{
 			3. If we either reached a group end character in this line or was fetching an independent task, or reached the last line:
 			   we save the fetching_taskstr_group to task_str_groups.
 			*/
-			const std::string& line = lines[line_i];
+			const std::string_view line = lines[line_i];
 
 			//1. (if either condition is met, move on to next line)		
 			//We check if this line has the { indicating the line is defining a new group,
@@ -141,8 +206,13 @@ namespace task_io_internal{
 			
 			const bool nested_group = (line.back() == '{') && fetching_group;
 			if(nested_group){
-				const std::string nested_group_name = line.substr(0, line.size() - 1);;
-				nested_group_callback(__FILE__, __LINE__, fetching_taskstr_group.group_name, nested_group_name);
+				if(diagnostics){
+					diagnostics->record(parse_diagnostics::Kind::NestedGroup, parse_diagnostics::unknown_position, parse_diagnostics::unknown_position, line);
+					continue;
+				}
+				
+				const std::string nested_group_name(line.substr(0, line.size() - 1));
+				nested_group_callback(__FILE__, __LINE__, std::string(fetching_taskstr_group.group_name), nested_group_name);
 				continue;
 			}
 			
@@ -154,7 +224,7 @@ namespace task_io_internal{
 			
 			//2. 
 			if(line == "}") fetching_group = false;
-			else fetching_taskstr_group.taskstrs.push_back(line_to_TaskStr(line));
+			else fetching_taskstr_group.taskstrs.push_back(line_to_TaskStrView(line));
 			
 			//3.(fallthrough from 2. for both cases)
 			const bool last_line = line_i + 1 == line_count;
@@ -162,7 +232,7 @@ namespace task_io_internal{
 				if(fetching_taskstr_group.taskstrs.size() > 0){
 					task_str_groups.push_back(fetching_taskstr_group);
 					fetching_taskstr_group.taskstrs.clear();
-					fetching_taskstr_group.group_name.clear();
+					fetching_taskstr_group.group_name = std::string_view();
 				}
 			}
 		}
@@ -171,149 +241,770 @@ namespace task_io_internal{
 		return task_str_groups;
 	}
 	
-	std::vector<TaskGroup> TaskStrGroups_to_TaskGroups(const std::vector<TaskStrGroup>& taskstr_groups){
-		std::vector<TaskGroup> taskgroups; 
-		taskgroups.reserve(taskstr_groups.size());
+	namespace{
+		///Constructs a Task from the provided strings and appends it to taskgroup. 
+		///If the due date is invalid, the task is not appended and it is recorded to diagnostics, or a window is displayed without diagnostics.
+		void append_task(TaskGroup& taskgroup, const std::string_view due_date_str, const std::string_view name, const std::chrono::year_month_day& current_date,
+						parse_diagnostics::Collector* const diagnostics)
+		{
+			const YmdParseResult due_date = parse_ymd(due_date_str);
+			if(due_date.ok()){
+				taskgroup.tasks.emplace_back(due_date.ymd, name, current_date);
+			}else if(diagnostics){
+				const std::string line = std::string(due_date_str) + ", " + std::string(name);
+				diagnostics->record(parse_diagnostics::Kind::InvalidDueDate, parse_diagnostics::unknown_position, parse_diagnostics::unknown_position, line);
+			}else{
+				const std::string msg = std::string(__FILE__) + ":" + std::to_string(__LINE__) + ": Task " + std::string(name) + " due to invalid due date.";
+				task_io_report::alert(msg.c_str());
+			}
+		}
+		
+		///Converts either TaskStrGroup or TaskStrViewGroup to TaskGroup, as both are accessed the same way.
+		template<typename TaskStrGroupType>
+		std::vector<TaskGroup> convert_taskstr_groups(const std::vector<TaskStrGroupType>& taskstr_groups, parse_diagnostics::Collector* const diagnostics){
+			std::vector<TaskGroup> taskgroups; 
+			taskgroups.reserve(taskstr_groups.size());
+		
+			const std::chrono::year_month_day current_date = get_current_ymd();
+		
+			//A loop iterating over each TaskStrGroup to convert it to TaskGroup and appends it to the return vector.
+			for(const TaskStrGroupType& current_taskstr_group : taskstr_groups){
+				TaskGroup fetching_taskgroup;
+				fetching_taskgroup.group_name = std::string(current_taskstr_group.group_name);
+			
+				//A loop iterating over each TaskStr in TaskStrGroup which converts it to Task and appends it to the TaskGroup.
+				for(const auto& current_taskstr : current_taskstr_group.taskstrs)
+					append_task(fetching_taskgroup, current_taskstr.due_date, current_taskstr.name, current_date, diagnostics);
+			
+				taskgroups.push_back(std::move(fetching_taskgroup));
+			}
+
+			return taskgroups;
+		}
+	}
+	
+	std::vector<TaskGroup> TaskStrGroups_to_TaskGroups(const std::vector<TaskStrGroup>& taskstr_groups, parse_diagnostics::Collector* const diagnostics){
+		return convert_taskstr_groups(taskstr_groups, diagnostics);
+	}
+	
+	std::vector<TaskGroup> TaskStrViewGroups_to_TaskGroups(const std::vector<TaskStrViewGroup>& taskstr_groups, parse_diagnostics::Collector* const diagnostics){
+		return convert_taskstr_groups(taskstr_groups, diagnostics);
+	}
+	
+	ScannedLine scan_line(const std::string_view line) noexcept{
+		if(line.back() == '{') return {ParsedLine::Type::GroupDefinition, line.substr(0, line.size() - 1), {}};
+		if(line == "}") return {ParsedLine::Type::ScopeEnd, std::string_view(), {}};
+		
+		//The same separation as line_to_TaskStrView(), without throwing for a line which has no comma and space after its due date.
+		auto date_str_end_index = byte_scan::find(line, ',');
+		if(date_str_end_index == std::string_view::npos) date_str_end_index = line.size();
+		if(date_str_end_index + 2 > line.size()) return {ParsedLine::Type::MissingComma, line, {}};
+		
+		const std::string_view name = line.substr(date_str_end_index + 2);
+		const YmdParseResult due_date = parse_ymd(line.substr(0, date_str_end_index));
+		if(!due_date.ok()) return {ParsedLine::Type::InvalidTask, line, {}};
+		
+		return {ParsedLine::Type::Task, name, due_date.ymd};
+	}
+	
+	ParsedLine parse_line(const std::string_view line) noexcept{
+		const ScannedLine scanned_line = scan_line(line);
+		return {scanned_line.type, scanned_line.text, scanned_line.due_date};
+	}
+	
+	std::vector<ParsedLine> parse_lines(const std::string_view chars, std::size_t& line_count){
+		std::vector<ParsedLine> parsed_lines;
+		//a task line is usually around 20 characters, see buffer_to_line_views().
+		parsed_lines.reserve(chars.size() / 20 + 1);
+		
+		line_count = 0;
+		std::string_view::size_type line_start = 0;
+		while(line_start < chars.size()){
+			std::string_view::size_type line_end = byte_scan::find(chars, '\n', line_start);
+			if(line_end == std::string_view::npos) line_end = chars.size();
+			
+			if(line_end != line_start){
+				ParsedLine& parsed_line = parsed_lines.emplace_back(parse_line(chars.substr(line_start, line_end - line_start)));
+				parsed_line.line_number = line_count;
+				parsed_line.offset = line_start;
+				if(parsed_line.type == ParsedLine::Type::MissingComma) break;
+			}
+			
+			line_start = line_end + 1;
+			line_count++;
+		}
 		
-		const std::chrono::year_month_day current_date = get_current_ymd();
+		return parsed_lines;
+	}
+	
+	std::vector<std::string_view> split_at_lines(const std::string_view buffer, const std::size_t chunk_count){
+		std::vector<std::string_view> chunks;
+		if(buffer.empty() || chunk_count == 0) return chunks;
+		chunks.reserve(chunk_count);
 		
-		//A loop iterating over each TaskStrGroup to convert it to TaskGroup and appends it to the return vector.
-		for(const TaskStrGroup& current_taskstr_group : taskstr_groups){
-			TaskGroup fetching_taskgroup;
-			fetching_taskgroup.group_name = current_taskstr_group.group_name;
+		const std::size_t target_chunk_size = buffer.size() / chunk_count + 1;
+		std::string_view::size_type chunk_start = 0;
+		while(chunk_start < buffer.size()){
+			//The chunk continues past its target size to the end of the line it is in.
+			std::string_view::size_type chunk_end = byte_scan::find(buffer, '\n', chunk_start + target_chunk_size - 1);
+			chunk_end = (chunk_end == std::string_view::npos) ? buffer.size() : chunk_end + 1;
 			
-			//A loop iterating over each TaskStr in TaskStrGroup which converts it to Task and appends it to the TaskGroup.
-			for(const TaskStr& current_taskstr : current_taskstr_group.taskstrs){
+			chunks.push_back(buffer.substr(chunk_start, chunk_end - chunk_start));
+			chunk_start = chunk_end;
+		}
+		
+		return chunks;
+	}
+	
+	std::vector<TaskGroup> parse_chunks_parallel(const std::vector<std::string_view>& chunks, const unsigned thread_count,
+												void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&),
+												parse_diagnostics::Collector* const diagnostics)
+	{
+		TaskFileParser parser(nested_group_callback, diagnostics);
+		
+		//Each thread takes the next chunk not yet taken until every chunk is parsed. 
+		//An exception is kept with its chunk and rethrown below, so it is thrown in the order of the lines.
+		std::vector<std::vector<ParsedLine>> parsed_chunks(chunks.size());
+		std::vector<std::size_t> chunk_line_counts(chunks.size());
+		std::vector<std::exception_ptr> chunk_exceptions(chunks.size());
+		std::atomic<std::size_t> next_chunk_index = 0;
+		
+		const auto parse_remaining_chunks = [&](){
+			for(std::size_t i = next_chunk_index++; i < chunks.size(); i = next_chunk_index++){
 				try{
-					const std::chrono::year_month_day due_date = str_to_ymd(current_taskstr.due_date);
-					fetching_taskgroup.tasks.emplace_back(due_date, current_taskstr.name, current_date);
+					parsed_chunks[i] = parse_lines(chunks[i], chunk_line_counts[i]);
 				}
-				catch(std::invalid_argument& invalid_ymd){
-					const std::string msg = std::string(__FILE__) + ":" + std::to_string(__LINE__) + ": Task " + current_taskstr.name + " due to invalid due date.";
-					fl_alert(msg.c_str());
+				catch(...){
+					chunk_exceptions[i] = std::current_exception();
 				}
 			}
+		};
+		
+		{
+			//std::jthread joins on destruction, so the threads started are joined even if starting another one throws.
+			std::vector<std::jthread> threads;
+			const std::size_t started_thread_count = std::min<std::size_t>(thread_count, chunks.size());
+			if(started_thread_count > 1) threads.reserve(started_thread_count - 1);
 			
-			taskgroups.push_back(fetching_taskgroup);
+			for(std::size_t i = 1; i < started_thread_count; ++i)
+				threads.emplace_back(parse_remaining_chunks);
+			parse_remaining_chunks();
 		}
-
-		return taskgroups;
+		
+		//The reconciliation pass: the state of the group being fetched carries on from one chunk to the next,
+		//which puts together the groups defined in one chunk and ended in another.
+		//The positions of the lines are from the start of their chunk until then.
+		//The tasks are constructed as their lines are fetched, so the names are only interned into name_pool from this thread.
+		std::size_t chunk_line_number = 0;
+		for(std::size_t i = 0; i < chunks.size(); ++i){
+			if(chunk_exceptions[i]) std::rethrow_exception(chunk_exceptions[i]);
+			const std::size_t chunk_offset = chunks[i].data() - chunks.front().data();
+			
+			for(ParsedLine& parsed_line : parsed_chunks[i]){
+				parsed_line.line_number += chunk_line_number;
+				parsed_line.offset += chunk_offset;
+				parser.fetch_line(std::move(parsed_line));
+			}
+			chunk_line_number += chunk_line_counts[i];
+			
+			//the parsed lines are no longer needed once fetched.
+			std::vector<ParsedLine>().swap(parsed_chunks[i]);
+		}
+		
+		return parser.finish();
 	}
 }//namespace task_io_internal
 
-std::vector<TaskGroup> get_tasks(void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&)){
-	task_io_internal::file_buffer raw_file_data;
+TaskFileParser::TaskFileParser(void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&),
+								parse_diagnostics::Collector* const diagnostics)
+:	nested_group_callback(nested_group_callback),
+	diagnostics(diagnostics),
+	fetched_task_line_count(0),
+	fetching_group(false),
+	last_line_is_task(false),
+	unfinished_line_offset(0),
+	fed_size(0),
+	line_number(0),
+	current_date(get_current_ymd())
+{
+}
+
+void TaskFileParser::start_at(const std::size_t offset, const std::size_t line_number) noexcept{
+	this->fed_size = offset;
+	this->unfinished_line_offset = offset;
+	this->line_number = line_number;
+}
+
+void TaskFileParser::feed(const char* const data, const std::size_t size){
+	std::string_view chunk(data, size);
+	std::size_t chunk_offset = this->fed_size;
+	this->fed_size += size;
+	
+	//The line left unfinished from the previous chunk is completed with the characters before the first newline of this chunk.
+	if(!this->unfinished_line.empty()){
+		const std::string_view::size_type first_newline = byte_scan::find(chunk, '\n');
+		if(first_newline == std::string_view::npos){
+			this->unfinished_line.append(chunk);
+			return;
+		}
+		
+		this->unfinished_line.append(chunk.substr(0, first_newline));
+		this->parse_line(this->unfinished_line, this->unfinished_line_offset);
+		this->unfinished_line.clear();
+		this->line_number++;
+		chunk.remove_prefix(first_newline + 1);
+		chunk_offset += first_newline + 1;
+	}
+	
+	//Every complete line is parsed directly from the chunk.
+	std::string_view::size_type line_start = 0;
+	while(true){
+		const std::string_view::size_type line_end = byte_scan::find(chunk, '\n', line_start);
+		if(line_end == std::string_view::npos) break;
+		
+		if(line_end != line_start)
+			this->parse_line(chunk.substr(line_start, line_end - line_start), chunk_offset + line_start);
+		line_start = line_end + 1;
+		this->line_number++;
+	}
+	
+	this->unfinished_line.assign(chunk.substr(line_start));
+	this->unfinished_line_offset = chunk_offset + line_start;
+}
+
+std::vector<TaskGroup> TaskFileParser::finish(){
+	if(!this->unfinished_line.empty()){
+		this->parse_line(this->unfinished_line, this->unfinished_line_offset);
+		this->unfinished_line.clear();
+	}
+	
+	//lines_to_TaskStrGroup() saves the group being fetched when it reaches the last line, 
+	//but only if the last line is a task, as a group definition continues to the next line.
+	if(this->fetching_group && this->last_line_is_task)
+		this->save_fetching_taskgroup();
+	//the group left unsaved is never converted by TaskStrGroups_to_TaskGroups(), so the due dates of its tasks are not checked either.
+	this->invalid_task_lines.clear();
+	
+	std::vector<TaskGroup> parsed_taskgroups = std::move(this->taskgroups);
+	
+	this->taskgroups.clear();
+	this->fetching_taskgroup = TaskGroup();
+	this->fetched_task_line_count = 0;
+	this->fetching_group = false;
+	this->last_line_is_task = false;
+	this->start_at(0, 0);
+	
+	return parsed_taskgroups;
+}
+
+void TaskFileParser::parse_line(const std::string_view line, const std::size_t offset){
+	task_io_internal::ParsedLine parsed_line = task_io_internal::parse_line(line);
+	parsed_line.line_number = this->line_number;
+	parsed_line.offset = offset;
+	this->fetch_line(std::move(parsed_line));
+}
+
+void TaskFileParser::fetch_line(task_io_internal::ParsedLine&& parsed_line){
+	using LineType = task_io_internal::ParsedLine::Type;
+	this->last_line_is_task = false;
+	
+	//A group definition inside of a group, warn and move on to fetching tasks to the former group.
+	const bool nested_group = (parsed_line.type == LineType::GroupDefinition) && this->fetching_group;
+	if(nested_group){
+		const std::string nested_group_name(parsed_line.text);
+		if(this->diagnostics)
+			this->diagnostics->record(parse_diagnostics::Kind::NestedGroup, parsed_line.line_number + 1, parsed_line.offset, nested_group_name + '{');
+		else
+			this->nested_group_callback(__FILE__, __LINE__, this->fetching_taskgroup.group_name, nested_group_name);
+		return;
+	}
+	
+	switch(parsed_line.type){
+		case LineType::GroupDefinition:
+		this->fetching_group = true;
+		this->fetching_taskgroup.group_name.assign(parsed_line.text);
+		return;
+		
+		case LineType::ScopeEnd:
+		this->fetching_group = false;
+		break;
+		
+		case LineType::Task:
+		this->fetching_taskgroup.tasks.emplace_back(parsed_line.due_date, parsed_line.text, this->current_date);
+		this->fetched_task_line_count++;
+		this->last_line_is_task = true;
+		break;
+		
+		case LineType::InvalidTask:
+		this->invalid_task_lines.push_back({std::string(parsed_line.text), parsed_line.line_number, parsed_line.offset});
+		this->fetched_task_line_count++;
+		this->last_line_is_task = true;
+		break;
+		
+		case LineType::MissingComma:
+		//throws the same std::out_of_range as task_io_internal::lines_to_TaskStrGroup() would for the line.
+		task_io_internal::line_to_TaskStrView(parsed_line.text);
+		throw std::out_of_range("task_io.cpp: TaskFileParser::fetch_line(): task line has no comma and space after its due date.");
+	}
+	
+	//A single task is saved right away, a group is saved once its scope ends.
+	if(!this->fetching_group)
+		this->save_fetching_taskgroup();
+}
+
+void TaskFileParser::save_fetching_taskgroup(){
+	this->report_invalid_task_lines();
+	
+	//A group is saved if it has task lines, even if every task in it had an invalid due date.
+	//Like lines_to_TaskStrGroup(), a group without task lines keeps its name for the next task fetched.
+	if(this->fetched_task_line_count == 0) return;
+	
+	this->taskgroups.push_back(std::move(this->fetching_taskgroup));
+	this->fetching_taskgroup = TaskGroup();
+	this->fetched_task_line_count = 0;
+}
+
+
+void TaskFileParser::report_invalid_task_lines(){
+	for(const InvalidTaskLine& invalid_task_line : this->invalid_task_lines){
+		if(this->diagnostics){
+			this->diagnostics->record(parse_diagnostics::Kind::InvalidDueDate, invalid_task_line.line_number + 1, invalid_task_line.offset, invalid_task_line.line);
+		}else{
+			const std::string_view name = task_io_internal::line_to_TaskStrView(invalid_task_line.line).name;
+			const std::string msg = std::string(__FILE__) + ":" + std::to_string(__LINE__) + ": Task " + std::string(name) + " due to invalid due date.";
+			task_io_report::alert(msg.c_str());
+		}
+	}
+	this->invalid_task_lines.clear();
+}
+
+namespace{
+	///Loads the groups of the task file from its snapshot, or parses the mapped task file with parse_task_file if the snapshot is not valid.
+	template<typename ParseFunction>
+	std::vector<TaskGroup> load_taskgroups(ParseFunction&& parse_task_file){
+		std::optional<std::vector<TaskGroup>> snapshot_taskgroups = task_snapshot::load(task_snapshot_filename, "tasks.txt");
+		if(snapshot_taskgroups) return std::move(*snapshot_taskgroups);
+		
+		MappedFile task_file;
+		try{
+			task_file = MappedFile("tasks.txt");
+		}
+		catch(const std::ios_base::failure& file_io_error) {throw;}
+		catch(const std::runtime_error& file_not_opened) {throw;}
+		
+		return parse_task_file(task_file.view());
+	}
+	
+	/**
+	Loads the groups of the task file with load_taskgroups(), then replays the journal over the groups.
+	
+	If the journal could not be replayed entirely, a window is displayed and the groups replayed so far are written to the task file,
+	so the journal starts over from the groups loaded. A stale journal is kept with task_journal::reject() instead.
+	If replay_status is provided, the status is stored to it instead, and nothing is written or displayed.
+	*/
+	template<typename ParseFunction>
+	std::vector<TaskGroup> load_task_file(ParseFunction&& parse_task_file, task_journal::ReplayStatus* const replay_status){
+		task_journal::ReplayResult replayed = task_journal::replay_file(load_taskgroups(parse_task_file), task_journal_filename, "tasks.txt");
+		if(replay_status){
+			*replay_status = replayed.status;
+			return std::move(replayed.taskgroups);
+		}
+		
+		switch(replayed.status){
+			case task_journal::ReplayStatus::NoJournal:
+			case task_journal::ReplayStatus::Replayed:
+			break;
+			
+			//kept aside rather than started over by the next save, as it has the changes saved since the last full save.
+			case task_journal::ReplayStatus::StaleJournal:
+			task_journal::reject(task_journal_filename);
+			task_io_report::alert(task_journal::replay_status_message(replayed.status));
+			break;
+			
+			case task_journal::ReplayStatus::IncompleteBatch:
+			case task_journal::ReplayStatus::CorruptedBatch:
+			task_io_report::alert(task_journal::replay_status_message(replayed.status));
+			overwrite_taskfile(replayed.taskgroups);
+			break;
+		}
+		
+		return std::move(replayed.taskgroups);
+	}
+}
+
+std::vector<TaskGroup> get_tasks(void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&),
+								parse_diagnostics::Collector* const diagnostics, task_journal::ReplayStatus* const replay_status)
+{
+	return load_task_file([&](const std::string_view task_file){
+		//The mapped file is parsed in place, so nothing is copied until the tasks are constructed.
+		TaskFileParser parser(nested_group_callback, diagnostics);
+		parser.feed(task_file.data(), task_file.size());
+		return parser.finish();
+	}, replay_status);
+}
+
+bool should_load_lazily() noexcept{
+	std::error_code error;
+	const std::uintmax_t task_file_size = std::filesystem::file_size("tasks.txt", error);
+	return !error && (task_file_size >= task_index::lazy_load_min_size);
+}
+
+task_index::LazyTaskFile get_tasks_lazily(void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&),
+										parse_diagnostics::Collector* const diagnostics)
+{
+	MappedFile task_file;
 	try{
-		raw_file_data = task_io_internal::get_raw_file("tasks.txt");
+		task_file = MappedFile("tasks.txt");
 	}
 	catch(const std::ios_base::failure& file_io_error) {throw;}
 	catch(const std::runtime_error& file_not_opened) {throw;}
+	
+	//The text is copied, as the groups are loaded from it after tasks.txt is rewritten by saving.
+	task_index::LazyTaskFile lazy_task_file = task_index::index(std::string(task_file.view()));
+	task_file = MappedFile();
+	//normalized before replaying as task_journal::replay() does, the indices of the journal are of the normalized groups.
+	task_index::as_loaded_from_task_file(lazy_task_file, nested_group_callback, diagnostics);
+	
+	MappedFile journal_file;
+	try{
+		journal_file = MappedFile(task_journal_filename);
+	}
+	catch(const std::ios_base::failure& file_io_error) {return lazy_task_file;}
+	catch(const std::runtime_error& file_not_opened) {return lazy_task_file;}
+	
+	//The same as task_journal::replay(), over the index.
+	const task_journal::ReplayStatus status = task_journal::replay_batches(journal_file.view(), "tasks.txt", lazy_task_file.taskgroups.size(), 
+		[&](const std::vector<task_journal::Operation>& operations){
+			for(const task_journal::Operation& operation : operations)
+				task_index::apply(lazy_task_file, operation, nested_group_callback, diagnostics);
+		});
+	
+	switch(status){
+		case task_journal::ReplayStatus::NoJournal:
+		break;
+		
+		case task_journal::ReplayStatus::Replayed:
+		task_index::as_loaded_from_task_file(lazy_task_file, nested_group_callback, diagnostics);
+		break;
+		
+		case task_journal::ReplayStatus::StaleJournal:
+		task_journal::reject(task_journal_filename);
+		task_io_report::alert(task_journal::replay_status_message(status));
+		break;
+		
+		case task_journal::ReplayStatus::IncompleteBatch:
+		case task_journal::ReplayStatus::CorruptedBatch:
+		task_io_report::alert(task_journal::replay_status_message(status));
+		task_index::as_loaded_from_task_file(lazy_task_file, nested_group_callback, diagnostics);
+		overwrite_taskfile(task_index::to_taskgroups(lazy_task_file, nested_group_callback, diagnostics));
+		break;
+	}
+	
+	return lazy_task_file;
+}
+
+unsigned default_parse_thread_count() noexcept{
+	const unsigned hardware_thread_count = std::thread::hardware_concurrency();
+	return (hardware_thread_count == 0) ? 1 : hardware_thread_count;
+}
+
+std::vector<TaskGroup> parse_tasks_parallel(const std::string_view buffer, const unsigned thread_count,
+											void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&),
+											parse_diagnostics::Collector* const diagnostics)
+{
+	//a few chunks for each thread, so a thread which finishes early takes over the remaining chunks.
+	constexpr std::size_t chunks_per_thread = 4;
+	const std::size_t chunk_count = std::min<std::size_t>(std::size_t(thread_count) * chunks_per_thread, buffer.size() / parallel_parse_min_chunk_size);
+	
+	if(thread_count <= 1 || chunk_count <= 1){
+		TaskFileParser parser(nested_group_callback, diagnostics);
+		parser.feed(buffer.data(), buffer.size());
+		return parser.finish();
+	}
+	
+	return task_io_internal::parse_chunks_parallel(task_io_internal::split_at_lines(buffer, chunk_count), thread_count, nested_group_callback, diagnostics);
+}
 
-	const std::vector<std::string> lines = task_io_internal::buffer_to_separated_lines(raw_file_data);
-	const std::vector<task_io_internal::TaskStrGroup> taskstr_groups = task_io_internal::lines_to_TaskStrGroup(lines, nested_group_callback);
+std::vector<TaskGroup> get_tasks_parallel(const unsigned thread_count, void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&),
+										parse_diagnostics::Collector* const diagnostics, task_journal::ReplayStatus* const replay_status)
+{
+	return load_task_file([&](const std::string_view task_file){
+		return parse_tasks_parallel(task_file, thread_count, nested_group_callback, diagnostics);
+	}, replay_status);
+}
 
-	return task_io_internal::TaskStrGroups_to_TaskGroups(taskstr_groups);
+bool compact_task_file(parse_diagnostics::Collector* const diagnostics){
+	std::error_code error;
+	if(!std::filesystem::exists(task_journal_filename, error)) return false;
+	
+	std::vector<TaskGroup> taskgroups = load_taskgroups([&](const std::string_view task_file){
+		return parse_tasks_parallel(task_file, default_parse_thread_count(), task_io_internal::default_nested_group_callback, diagnostics);
+	});
+	
+	const task_journal::ReplayResult replayed = task_journal::replay_file(std::move(taskgroups), task_journal_filename, "tasks.txt");
+	if(replayed.status == task_journal::ReplayStatus::NoJournal || replayed.status == task_journal::ReplayStatus::StaleJournal) return false;
+	
+	write_taskfile(replayed.taskgroups);
+	return true;
 }
 
+std::vector<TaskGroup> get_tasks_from_stream(std::istream& stream, void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&),
+											parse_diagnostics::Collector* const diagnostics)
+{
+	constexpr std::size_t chunk_size = 64 * 1024;
+	std::unique_ptr<char[]> chunk(new char[chunk_size]);
+	
+	TaskFileParser parser(nested_group_callback, diagnostics);
+	while(stream){
+		stream.read(chunk.get(), chunk_size);
+		parser.feed(chunk.get(), stream.gcount());
+	}
+	
+	if(stream.bad())
+		throw std::ios_base::failure("task_io.cpp: get_tasks_from_stream(): stream lost integrity while reading.");
+	
+	return parser.finish();
+}
+
+
+namespace{
+	///The 2 digit form of 0 to 99, "00" to "99", so writing a month or day is a copy of 2 characters instead of 2 divisions.
+	constexpr auto two_digits_table = [](){
+		std::array<char, 200> table{};
+		for(int i = 0; i < 100; ++i){
+			table[i * 2] = char('0' + i / 10);
+			table[i * 2 + 1] = char('0' + i % 10);
+		}
+		return table;
+	}();
+	
+	///The maximum characters of the year written by std::to_chars(), which is a sign and the 5 digits of std::chrono::year::max().
+	constexpr std::size_t max_year_size = 6;
+	
+	std::size_t decimal_digit_count(unsigned num) noexcept{
+		std::size_t digit_count = 1;
+		for(; num >= 10; num /= 10) digit_count++;
+		return digit_count;
+	}
+	
+	///The characters written by write_task(), as in int_to_2char() and task_to_str().
+	std::size_t task_str_size(const Task& task) noexcept{
+		const int year = int(task.due_date().year());
+		const std::size_t year_size = decimal_digit_count(unsigned(year < 0 ? -year : year)) + (year < 0);
+		const std::size_t month_size = std::max<std::size_t>(2, decimal_digit_count(unsigned(task.due_date().month())));
+		const std::size_t day_size = std::max<std::size_t>(2, decimal_digit_count(unsigned(task.due_date().day())));
+		
+		//the 2 slashes of the due date, and the comma and space after it.
+		return year_size + month_size + day_size + 4 + task.name().size();
+	}
+	
+	char* write_2_digits(char* out, const unsigned num) noexcept{
+		if(num < 100){
+			std::memcpy(out, two_digits_table.data() + num * 2, 2);
+			return out + 2;
+		}
+		//an invalid month or day, or a number of int_to_2char() with more than 2 digits, written in full.
+		return std::to_chars(out, out + std::numeric_limits<unsigned>::digits10 + 1, num).ptr;
+	}
+	
+	///Writes the task as in task_to_str(), and returns the end of the written characters. out must have task_str_size() characters.
+	char* write_task(char* out, const Task& task) noexcept{
+		out = std::to_chars(out, out + max_year_size, int(task.due_date().year())).ptr;
+		*out++ = '/';
+		out = write_2_digits(out, unsigned(task.due_date().month()));
+		*out++ = '/';
+		out = write_2_digits(out, unsigned(task.due_date().day()));
+		*out++ = ',';
+		*out++ = ' ';
+		
+		std::memcpy(out, task.name().data(), task.name().size());
+		return out + task.name().size();
+	}
+	
+	///The characters written by taskgroups_to_str().
+	std::size_t taskgroups_str_size(const std::vector<TaskGroup>& taskgroups) noexcept{
+		std::size_t size = 0;
+		
+		for(const TaskGroup& taskgroup : taskgroups){
+			//"{\n" after the group name and "}\n" after the tasks.
+			if(taskgroup.tasks.size() != 1) size += taskgroup.group_name.size() + 4;
+			//the newline after each task.
+			for(const Task& task : taskgroup.tasks) size += task_str_size(task) + 1;
+		}
+		
+		return size;
+	}
+}
 
 std::string int_to_2char(const unsigned num){
-	const std::string num_str = std::to_string(num);
-	//anything less than 10 is written with only 1 number, so we put a 0 in the front.
-	if(num < 10) return "0" + num_str;
-	else return num_str;
+	std::string num_str(std::max<std::size_t>(2, decimal_digit_count(num)), '0');
+	write_2_digits(num_str.data(), num);
+	return num_str;
 }
 
-void overwrite_taskfile(const std::vector<TaskGroup>& taskgroups){
-	std::string buffer; 
-	buffer.reserve(400);
+std::string taskgroups_to_str(const std::vector<TaskGroup>& taskgroups){
+	//The exact size is counted first, so the tasks are written straight into the buffer without reallocating or making temporary strings.
+	std::string buffer(taskgroups_str_size(taskgroups), '\0');
+	char* out = buffer.data();
 	
 	for(const TaskGroup& taskgroup : taskgroups){
 		if(taskgroup.tasks.size() == 1){
-			buffer += task_to_str(taskgroup.tasks[0]) + '\n';
+			out = write_task(out, taskgroup.tasks[0]);
+			*out++ = '\n';
 		}
 		else{
-			buffer += taskgroup.group_name + "{\n";
+			std::memcpy(out, taskgroup.group_name.data(), taskgroup.group_name.size());
+			out += taskgroup.group_name.size();
+			*out++ = '{';
+			*out++ = '\n';
+			
 			for(const Task& task : taskgroup.tasks){
-				buffer += task_to_str(task) + '\n';
+				out = write_task(out, task);
+				*out++ = '\n';
 			}
-			buffer += "}\n";
+			
+			*out++ = '}';
+			*out++ = '\n';
 		}
 	}
 	
-	const int resave_requested = 0;
-	int user_decision = resave_requested;
-	do{
+	return buffer;
+}
+
+void write_taskfile(const std::vector<TaskGroup>& taskgroups){
+	const std::string buffer = taskgroups_to_str(taskgroups);
+	
+	//The snapshot of the old task file must not be loaded if the new one fails to be written.
+	task_snapshot::remove(task_snapshot_filename);
+	
+	{
 		std::ofstream file("tasks.txt", std::ofstream::out);
 		file.write(buffer.c_str(), buffer.size());
+		file.close();
 		
 		//file.bad() trips when writing an empty file, so a buffer size check is added.
-		if(file.bad() && buffer.size() != 0){
-			user_decision = fl_choice("Anomaly detected while saving task. Try resaving?", "Resave", "Keep anomaly", 0);
-		}else break;
-		
-	}while(user_decision == resave_requested);
+		if((file.bad() || file.fail()) && buffer.size() != 0)
+			throw std::ios_base::failure("task_io.cpp: write_taskfile(): tasks.txt could not be written.");
+	}
+	
+	//The task file has every change of the journal now.
+	task_journal::remove(task_journal_filename);
+	task_snapshot::save(taskgroups, task_snapshot_filename, "tasks.txt");
+}
+
+void overwrite_taskfile(const std::vector<TaskGroup>& taskgroups){
+	bool resave_requested = true;
+	do{
+		try{
+			write_taskfile(taskgroups);
+			break;
+		}
+		catch(const std::ios_base::failure& file_io_error){
+			resave_requested = task_io_report::ask_retry("Anomaly detected while saving task. Try resaving?");
+		}
+	}while(resave_requested);
 }
 
 
 std::string task_to_str(const Task& task){
-	const std::string year_str = std::to_string(int(task.due_date().year()));
-	const std::string month_str = int_to_2char(unsigned(task.due_date().month()));
-	const std::string day_str = int_to_2char(unsigned(task.due_date().day()));
-	const std::string ymd_str = year_str + "/" + month_str + "/" + day_str;	
-	
-	return ymd_str + ", " + task.name();
+	std::string task_str(task_str_size(task), '\0');
+	write_task(task_str.data(), task);
+	return task_str;
 }
 
-std::chrono::year_month_day str_to_ymd(const std::string& str){
-	const auto str_length = str.size();
-	std::string buffer; 
-	
-	buffer.reserve(5);
+const char* ymd_parse_status_message(const YmdParseStatus status) noexcept{
+	switch(status){
+		case YmdParseStatus::Ok:
+		return "Valid ymd.";
+		
+		case YmdParseStatus::TooShort:
+		return "string of ymd is too short. Minimum is 8 characters.";
+		
+		case YmdParseStatus::NonNumericYmd:
+		return "ymd must only contain numbers or forward slash '/'.";
+		
+		case YmdParseStatus::MonthNotProvided:
+		return "Month section not provided.";
+		
+		case YmdParseStatus::NonNumericDay:
+		return "Days must only contain numbers.";
+		
+		case YmdParseStatus::DayNotProvided:
+		return "Day section not provided.";
+		
+		case YmdParseStatus::InvalidYmd:
+		return "Invalid ymd.";
+		
+		default:
+		return "Unknown ymd error.";
+	}
+}
+
+namespace{
+	///Returns true if all 4 characters packed in the integer are between ASCII '0' to '9', checking them all at once.
+	///The check is the same for every byte, so the byte order of the integer does not matter.
+	constexpr bool chars_are_numbers(const std::uint32_t four_chars) noexcept{
+		//'0' to '9' is 0x30 to 0x39: the high nibble must be 3, and adding 6 to the low nibble must not carry into the high nibble.
+		const bool high_nibbles_are_3 = (four_chars & 0xF0F0F0F0u) == 0x30303030u;
+		const bool low_nibbles_below_10 = ((four_chars + 0x06060606u) & 0xF0F0F0F0u) == 0x30303030u;
+		return high_nibbles_are_3 && low_nibbles_below_10;
+	}
+}
+
+YmdParseResult parse_ymd(const std::string_view str) noexcept{
+	const std::chrono::year_month_day invalid_ymd{};
 	
 	//includes 4 characters for yyyy, 2 for slashes, 1 for month and 1 for day.
-	constexpr decltype(str_length) min_str_length = 8;
-	if(str_length < min_str_length) throw std::invalid_argument("string of ymd is too short. Minimum is 8 characters.");
-	
-	decltype(str.size()) i = 0;
+	constexpr std::string_view::size_type min_str_length = 8;
+	if(str.size() < min_str_length) return {invalid_ymd, YmdParseStatus::TooShort};
 	
-	//fetching year
-	for(; i < 4; ++i){
-		const char& c = str[i];
-		
-		if(char_is_number(c)) buffer += c;
-		else throw std::invalid_argument("ymd must only contain numbers or forward slash '/'.");
-	}
-	const auto year = std::chrono::year(std::stoi(buffer));
-	buffer.clear();	
+	//fetching year, the yyyy is always 4 characters, so they are checked at once.
+	std::uint32_t year_chars;
+	std::memcpy(&year_chars, str.data(), sizeof(year_chars));
+	if(!chars_are_numbers(year_chars)) return {invalid_ymd, YmdParseStatus::NonNumericYmd};
 	
+	int year = 0;
+	std::from_chars(str.data(), str.data() + 4, year);
 	
-	//+1 to skip '/' between year and month
-	for(i += 1; i < 7; ++i){
+	//+1 to skip '/' between year and month. The month is either 1 or 2 digits, ending at '/' or at the 7th character.
+	std::string_view::size_type i = 5;
+	for(; i < 7; ++i){
 		const char c = str[i];
 		
-		if(char_is_number(c)) buffer += c;
+		if(char_is_number(c)) continue;
 		else if(c == '/') break;
-		else throw std::invalid_argument("ymd must only contain numbers or forward slash '/'.");
+		else return {invalid_ymd, YmdParseStatus::NonNumericYmd};
 	}
-	if(buffer.empty()) throw std::invalid_argument("Month section not provided.");
-	const auto month = std::chrono::month(std::stoi(buffer));
-	buffer.clear();	
 	
+	constexpr std::string_view::size_type month_start = 5;
+	if(i == month_start) return {invalid_ymd, YmdParseStatus::MonthNotProvided};
 	
-	//+1 to skip '/' between month and day
-	for(i += 1; i < str_length; ++i){
-		const char c = str[i];
-		
-		if(char_is_number(c)) buffer += c;
-		else throw std::invalid_argument("Days must only contain numbers.");
+	unsigned month = 0;
+	std::from_chars(str.data() + month_start, str.data() + i, month);
+	
+	//+1 to skip '/' between month and day, the rest of the string is the day.
+	const std::string_view::size_type day_start = i + 1;
+	for(i = day_start; i < str.size(); ++i){
+		if(!char_is_number(str[i])) return {invalid_ymd, YmdParseStatus::NonNumericDay};
 	}
-	const auto day = std::chrono::day(std::stoi(buffer));
-	buffer.clear();
+	if(day_start >= str.size()) return {invalid_ymd, YmdParseStatus::DayNotProvided};
 	
+	unsigned day = 0;
+	const std::from_chars_result day_result = std::from_chars(str.data() + day_start, str.data() + str.size(), day);
+	//std::chrono::day only keeps 8 bits, so a day too large is rejected here instead of wrapping around to a valid day.
+	constexpr unsigned max_day = 31;
+	if(day_result.ec != std::errc() || day > max_day) return {invalid_ymd, YmdParseStatus::InvalidYmd};
+	
+	const auto ymd = std::chrono::year_month_day(std::chrono::year(year), std::chrono::month(month), std::chrono::day(day));
+	if(ymd.ok()) return {ymd, YmdParseStatus::Ok};
+	else return {invalid_ymd, YmdParseStatus::InvalidYmd};
+}
+
+std::chrono::year_month_day str_to_ymd(const std::string_view str){
+	const YmdParseResult result = parse_ymd(str);
 	
-	const auto ymd = std::chrono::year_month_day(year, month, day);
-	if(ymd.ok()) return ymd;
-	else throw std::invalid_argument("Invalid ymd.");
+	if(result.ok()) return result.ymd;
+	else throw std::invalid_argument(ymd_parse_status_message(result.status));
 }
 
 std::string ymd_to_string(const std::chrono::year_month_day& ymd){
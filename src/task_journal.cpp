@@ -0,0 +1,471 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "task_journal.hpp"
+
+#include "Task.hpp"
+#include "time_calc.hpp"
+#include "task_snapshot.hpp"
+#include "mapped_file.hpp"
+
+#include <ios>
+#include <limits>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <utility>
+#include <optional>
+#include <stdexcept>
+#include <filesystem>
+#include <functional>
+#include <string_view>
+#include <system_error>
+
+namespace task_journal{
+	namespace{
+		constexpr char magic[8] = {'W', 'T', 'J', 'R', 'N', 'L', '\0', '\0'};
+		
+		struct Header{
+			char magic[8];
+			std::uint32_t version;
+			std::uint32_t reserved;
+			std::uint64_t source_size;
+			std::int64_t source_last_write_time;
+		};
+		
+		struct BatchHeader{
+			///The checksum of the encoded operations, from task_snapshot::checksum().
+			std::uint64_t checksum;
+			std::uint32_t size;
+			std::uint32_t reserved;
+		};
+		
+		Header make_header(const task_snapshot::SourceStamp& source) noexcept{
+			Header header = {};
+			std::memcpy(header.magic, magic, sizeof(magic));
+			header.version = format_version;
+			header.source_size = source.size;
+			header.source_last_write_time = source.last_write_time;
+			return header;
+		}
+		
+		///Returns true if the header is of this version of the format, and was made for the task file of the provided stamp.
+		bool header_matches(const Header& header, const task_snapshot::SourceStamp& source) noexcept{
+			return (std::memcmp(header.magic, magic, sizeof(magic)) == 0) && (header.version == format_version)
+				&& (task_snapshot::SourceStamp{header.source_size, header.source_last_write_time} == source);
+		}
+		
+		template<typename T>
+		void append_value(std::string& buffer, const T& value){
+			buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+		
+		void append_string(std::string& buffer, const std::string_view str){
+			append_value(buffer, std::uint32_t(str.size()));
+			buffer.append(str);
+		}
+		
+		///Reads the encoded values from the start of the provided characters. Reading past the end fails every read after it.
+		class Reader{
+			public:
+			explicit Reader(const std::string_view chars) noexcept : chars(chars), failed(false) {}
+			
+			template<typename T>
+			T value() noexcept{
+				T value{};
+				if(this->chars.size() < sizeof(T)){
+					this->failed = true;
+					return value;
+				}
+				
+				std::memcpy(&value, this->chars.data(), sizeof(T));
+				this->chars.remove_prefix(sizeof(T));
+				return value;
+			}
+			
+			std::string_view string() noexcept{
+				const std::uint32_t size = this->value<std::uint32_t>();
+				if(this->failed || this->chars.size() < size){
+					this->failed = true;
+					return std::string_view();
+				}
+				
+				const std::string_view str = this->chars.substr(0, size);
+				this->chars.remove_prefix(size);
+				return str;
+			}
+			
+			bool at_end() const noexcept {return this->chars.empty();}
+			bool has_failed() const noexcept {return this->failed;}
+			
+			private:
+			std::string_view chars;
+			bool failed;
+		};
+		
+		void append_taskgroup(std::string& buffer, const TaskGroup& taskgroup){
+			append_string(buffer, taskgroup.group_name);
+			append_value(buffer, std::uint32_t(taskgroup.tasks.size()));
+			
+			for(const Task& task : taskgroup.tasks){
+				append_value(buffer, std::int32_t(std::chrono::sys_days(task.due_date()).time_since_epoch().count()));
+				append_string(buffer, task.name());
+			}
+		}
+		
+		std::optional<TaskGroup> read_taskgroup(Reader& reader, const std::chrono::year_month_day& current_date){
+			TaskGroup taskgroup;
+			taskgroup.group_name = reader.string();
+			
+			const std::uint32_t task_count = reader.value<std::uint32_t>();
+			for(std::uint32_t i = 0; i < task_count && !reader.has_failed(); ++i){
+				const auto due_date = std::chrono::year_month_day(std::chrono::sys_days(std::chrono::days(reader.value<std::int32_t>())));
+				const std::string_view name = reader.string();
+				if(reader.has_failed() || !due_date.ok()) return std::nullopt;
+				
+				taskgroup.tasks.emplace_back(due_date, name, current_date);
+			}
+			
+			if(reader.has_failed()) return std::nullopt;
+			return taskgroup;
+		}
+	}
+	
+	namespace{
+		///Returns true if the index of every operation is in range when applied in order to a list of the provided size,
+		///and sets the size to of the list after the operations. The size is left as is if an index is out of range.
+		bool indices_in_range(const std::vector<Operation>& operations, std::size_t& taskgroup_count) noexcept{
+			std::size_t count = taskgroup_count;
+			for(const Operation& operation : operations){
+				if(operation.type == Operation::Type::Add){
+					count++;
+					continue;
+				}
+				
+				if(operation.index >= count) return false;
+				if(operation.type == Operation::Type::Delete) count--;
+			}
+			
+			taskgroup_count = count;
+			return true;
+		}
+	}
+	
+	Operation Operation::add(const TaskGroup& taskgroup){
+		return {Type::Add, 0, taskgroup};
+	}
+	
+	Operation Operation::modify(const std::size_t index, const TaskGroup& taskgroup){
+		return {Type::Modify, std::uint32_t(index), taskgroup};
+	}
+	
+	Operation Operation::erase(const std::size_t index){
+		return {Type::Delete, std::uint32_t(index), TaskGroup()};
+	}
+	
+	Operation Operation::rename(const std::size_t index, const std::string& group_name){
+		return {Type::Rename, std::uint32_t(index), TaskGroup{group_name, {}}};
+	}
+	
+	std::string encode(const std::vector<Operation>& operations){
+		std::string encoded_operations;
+		
+		for(const Operation& operation : operations){
+			append_value(encoded_operations, operation.type);
+			
+			switch(operation.type){
+				case Operation::Type::Add:
+				append_taskgroup(encoded_operations, operation.taskgroup);
+				break;
+				
+				case Operation::Type::Modify:
+				append_value(encoded_operations, operation.index);
+				append_taskgroup(encoded_operations, operation.taskgroup);
+				break;
+				
+				case Operation::Type::Delete:
+				append_value(encoded_operations, operation.index);
+				break;
+				
+				case Operation::Type::Rename:
+				append_value(encoded_operations, operation.index);
+				append_string(encoded_operations, operation.taskgroup.group_name);
+				break;
+			}
+		}
+		
+		return encoded_operations;
+	}
+	
+	std::optional<std::vector<Operation>> decode(const std::string_view encoded_operations){
+		const std::chrono::year_month_day current_date = get_current_ymd();
+		std::vector<Operation> operations;
+		Reader reader(encoded_operations);
+		
+		while(!reader.at_end()){
+			Operation operation = {reader.value<Operation::Type>(), 0, TaskGroup()};
+			
+			switch(operation.type){
+				case Operation::Type::Add:{
+					std::optional<TaskGroup> taskgroup = read_taskgroup(reader, current_date);
+					if(!taskgroup) return std::nullopt;
+					operation.taskgroup = std::move(*taskgroup);
+					break;
+				}
+				
+				case Operation::Type::Modify:{
+					operation.index = reader.value<std::uint32_t>();
+					std::optional<TaskGroup> taskgroup = read_taskgroup(reader, current_date);
+					if(!taskgroup) return std::nullopt;
+					operation.taskgroup = std::move(*taskgroup);
+					break;
+				}
+				
+				case Operation::Type::Delete:
+				operation.index = reader.value<std::uint32_t>();
+				break;
+				
+				case Operation::Type::Rename:
+				operation.index = reader.value<std::uint32_t>();
+				operation.taskgroup.group_name = reader.string();
+				break;
+				
+				default:
+				return std::nullopt;
+			}
+			
+			if(reader.has_failed()) return std::nullopt;
+			operations.push_back(std::move(operation));
+		}
+		
+		return operations;
+	}
+	
+	std::vector<Operation> coalesce(std::vector<Operation>&& operations){
+		std::vector<Operation> coalesced_operations;
+		coalesced_operations.reserve(operations.size());
+		
+		for(Operation& operation : operations){
+			if(!coalesced_operations.empty()){
+				Operation& previous = coalesced_operations.back();
+				//After an Add or a Delete, the same index may refer to another group.
+				const bool same_group = (previous.type == Operation::Type::Modify || previous.type == Operation::Type::Rename)
+										&& (operation.type != Operation::Type::Add) && (previous.index == operation.index);
+				
+				//A Modify or Delete overwrites everything done to the group before it.
+				if(same_group && operation.type != Operation::Type::Rename){
+					previous = std::move(operation);
+					continue;
+				}
+				if(same_group){
+					previous.taskgroup.group_name = std::move(operation.taskgroup.group_name);
+					continue;
+				}
+			}
+			
+			coalesced_operations.push_back(std::move(operation));
+		}
+		
+		return coalesced_operations;
+	}
+	
+	bool apply(std::vector<TaskGroup>& taskgroups, const Operation& operation){
+		const bool index_in_range = operation.index < taskgroups.size();
+		
+		switch(operation.type){
+			case Operation::Type::Add:
+			taskgroups.push_back(operation.taskgroup);
+			return true;
+			
+			case Operation::Type::Modify:
+			if(!index_in_range) return false;
+			taskgroups[operation.index] = operation.taskgroup;
+			return true;
+			
+			case Operation::Type::Delete:
+			if(!index_in_range) return false;
+			taskgroups.erase(taskgroups.begin() + operation.index);
+			return true;
+			
+			case Operation::Type::Rename:
+			if(!index_in_range) return false;
+			taskgroups[operation.index].group_name = operation.taskgroup.group_name;
+			return true;
+			
+			default:
+			return false;
+		}
+	}
+	
+	std::vector<TaskGroup> as_loaded_from_task_file(std::vector<TaskGroup>&& taskgroups){
+		std::vector<TaskGroup> loaded_taskgroups;
+		loaded_taskgroups.reserve(taskgroups.size());
+		
+		std::string lent_group_name;
+		for(TaskGroup& taskgroup : taskgroups){
+			if(taskgroup.tasks.empty()){
+				lent_group_name = std::move(taskgroup.group_name);
+				continue;
+			}
+			
+			if(taskgroup.tasks.size() == 1) taskgroup.group_name = std::move(lent_group_name);
+			lent_group_name.clear();
+			loaded_taskgroups.push_back(std::move(taskgroup));
+		}
+		
+		return loaded_taskgroups;
+	}
+	
+	const char* replay_status_message(const ReplayStatus status) noexcept{
+		switch(status){
+			case ReplayStatus::NoJournal:
+			return "There is no journal of saved changes.";
+			
+			case ReplayStatus::Replayed:
+			return "The journal of saved changes is replayed.";
+			
+			case ReplayStatus::StaleJournal:
+			return "tasks.txt was changed outside of WorkTable since the last save. The changes saved after the last full save are not loaded,"
+					" the journal of those changes is kept as tasks.journal.rejected.";
+			
+			case ReplayStatus::IncompleteBatch:
+			return "The last save was not completed. The changes of the last save are not loaded.";
+			
+			case ReplayStatus::CorruptedBatch:
+			return "The journal of saved changes is corrupted. Only the changes before the corruption are loaded.";
+			
+			default:
+			return "Unknown journal replay status.";
+		}
+	}
+	
+	ReplayStatus replay_batches(const std::string_view journal, const std::string& source_filename, std::size_t taskgroup_count,
+								const std::function<void(const std::vector<Operation>&)>& apply_batch)
+	{
+		if(journal.empty()) return ReplayStatus::NoJournal;
+		
+		Header header;
+		const std::optional<task_snapshot::SourceStamp> source = task_snapshot::get_source_stamp(source_filename);
+		if(journal.size() < sizeof(Header)) return ReplayStatus::StaleJournal;
+		std::memcpy(&header, journal.data(), sizeof(Header));
+		if(!source || !header_matches(header, *source)) return ReplayStatus::StaleJournal;
+		
+		std::string_view batches = journal.substr(sizeof(Header));
+		while(!batches.empty()){
+			if(batches.size() < sizeof(BatchHeader)) return ReplayStatus::IncompleteBatch;
+			
+			BatchHeader batch_header;
+			std::memcpy(&batch_header, batches.data(), sizeof(BatchHeader));
+			batches.remove_prefix(sizeof(BatchHeader));
+			if(batches.size() < batch_header.size) return ReplayStatus::IncompleteBatch;
+			
+			const std::string_view encoded_operations = batches.substr(0, batch_header.size);
+			batches.remove_prefix(batch_header.size);
+			
+			std::optional<std::vector<Operation>> operations;
+			if(task_snapshot::checksum(encoded_operations) == batch_header.checksum) 
+				operations = decode(encoded_operations);
+			if(!operations) return ReplayStatus::CorruptedBatch;
+			
+			//The indices are checked before applying any operation, so a batch is replayed either entirely or not at all.
+			if(!indices_in_range(*operations, taskgroup_count)) return ReplayStatus::CorruptedBatch;
+			apply_batch(*operations);
+		}
+		
+		return ReplayStatus::Replayed;
+	}
+	
+	ReplayResult replay(std::vector<TaskGroup>&& taskgroups, const std::string_view journal, const std::string& source_filename){
+		//A group without tasks, such as a group of only invalid due dates, is dropped from the list the indices of the journal were taken from.
+		//The batches do not leave a group without tasks, as BarGroup rewrites the task file instead, so the indices stay the same afterwards.
+		taskgroups = as_loaded_from_task_file(std::move(taskgroups));
+		const ReplayStatus status = replay_batches(journal, source_filename, taskgroups.size(), [&taskgroups](const std::vector<Operation>& operations){
+			for(const Operation& operation : operations)
+				apply(taskgroups, operation);
+		});
+		
+		if(status == ReplayStatus::NoJournal || status == ReplayStatus::StaleJournal) 
+			return {std::move(taskgroups), status};
+		return {as_loaded_from_task_file(std::move(taskgroups)), status};
+	}
+	
+	ReplayResult replay_file(std::vector<TaskGroup>&& taskgroups, const std::string& journal_filename, const std::string& source_filename){
+		MappedFile journal_file;
+		try{
+			journal_file = MappedFile(journal_filename);
+		}
+		catch(const std::ios_base::failure& file_io_error) {return replay(std::move(taskgroups), std::string_view(), source_filename);}
+		catch(const std::runtime_error& file_not_opened) {return replay(std::move(taskgroups), std::string_view(), source_filename);}
+		
+		return replay(std::move(taskgroups), journal_file.view(), source_filename);
+	}
+	
+	void append(const std::vector<Operation>& operations, const std::string& journal_filename, const std::string& source_filename,
+				const task_snapshot::SourceStamp& loaded_source){
+		const std::optional<task_snapshot::SourceStamp> source = task_snapshot::get_source_stamp(source_filename);
+		if(!source)
+			throw std::ios_base::failure("task_journal.cpp: append(): unable to get the size of " + source_filename + ".");
+		//The operations were made to the groups loaded from loaded_source, their indices do not apply to another version of the task file.
+		if(*source != loaded_source)
+			throw std::ios_base::failure("task_journal.cpp: append(): " + source_filename + " was changed since it was loaded.");
+		
+		//The journal is continued only if it was made for the current task file.
+		Header existing_header = {};
+		std::ifstream existing_journal(journal_filename, std::ifstream::in | std::ifstream::binary);
+		existing_journal.read(reinterpret_cast<char*>(&existing_header), sizeof(Header));
+		const bool continue_journal = existing_journal.gcount() == sizeof(Header) && header_matches(existing_header, *source);
+		existing_journal.close();
+		
+		const std::string encoded_operations = encode(operations);
+		if(encoded_operations.size() > std::numeric_limits<std::uint32_t>::max())
+			throw std::ios_base::failure("task_journal.cpp: append(): the operations are too large for a single batch.");
+		
+		std::string buffer;
+		buffer.reserve(sizeof(Header) + sizeof(BatchHeader) + encoded_operations.size());
+		if(!continue_journal) append_value(buffer, make_header(*source));
+		append_value(buffer, BatchHeader{task_snapshot::checksum(encoded_operations), std::uint32_t(encoded_operations.size()), 0});
+		buffer += encoded_operations;
+		
+		const auto open_mode = std::ofstream::out | std::ofstream::binary | (continue_journal ? std::ofstream::app : std::ofstream::trunc);
+		std::ofstream file(journal_filename, open_mode);
+		file.write(buffer.data(), buffer.size());
+		file.flush();
+		
+		if(!file)
+			throw std::ios_base::failure("task_journal.cpp: append(): unable to write to " + journal_filename + ".");
+	}
+	
+	bool should_compact(const std::string& journal_filename, const std::string& source_filename) noexcept{
+		std::error_code error;
+		const std::uintmax_t journal_size = std::filesystem::file_size(journal_filename, error);
+		if(error) return false;
+		
+		const std::uintmax_t source_size = std::filesystem::file_size(source_filename, error);
+		if(error) return true;
+		
+		return (journal_size >= min_compaction_size) && (journal_size >= source_size / 4);
+	}
+	
+	void remove(const std::string& journal_filename) noexcept{
+		std::error_code error;
+		std::filesystem::remove(journal_filename, error);
+	}
+	
+	bool reject(const std::string& journal_filename) noexcept{
+		std::error_code error;
+		std::filesystem::rename(journal_filename, rejected_filename(journal_filename), error);
+		return !error;
+	}
+}
@@ -0,0 +1,263 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "task_snapshot.hpp"
+
+#include "Task.hpp"
+#include "time_calc.hpp"
+#include "byte_scan.hpp"
+#include "mapped_file.hpp"
+
+#include <limits>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+
+namespace task_snapshot{
+	namespace{
+		constexpr char magic[8] = {'W', 'T', 'S', 'N', 'A', 'P', '\0', '\0'};
+		
+		///task_to_str() writes the year with std::to_string(), and parse_ymd() only takes a year of 4 digits.
+		constexpr int min_text_year = 1000;
+		constexpr int max_text_year = 9999;
+		
+		bool name_is_single_line(const std::string_view name) noexcept{
+			return byte_scan::find(name, '\n') == std::string_view::npos;
+		}
+		
+		///Returns true if the task line written by task_to_str() loads back as the same task.
+		bool task_survives_text(const Task& task) noexcept{
+			const std::string_view name = task.name();
+			//a task line ending with '{' is loaded as a group definition.
+			if(!name.empty() && name.back() == '{') return false;
+			if(!name_is_single_line(name)) return false;
+			
+			const int year = int(task.due_date().year());
+			return (year >= min_text_year) && (year <= max_text_year);
+		}
+		
+		///Copies the value to the cursor and moves the cursor past it.
+		template<typename T>
+		void write_value(char*& cursor, const T& value) noexcept{
+			std::memcpy(cursor, &value, sizeof(T));
+			cursor += sizeof(T);
+		}
+		
+		template<typename T>
+		T read_value(const char* const source) noexcept{
+			T value;
+			std::memcpy(&value, source, sizeof(T));
+			return value;
+		}
+	}
+	
+	std::optional<SourceStamp> get_source_stamp(const std::string& filename) noexcept{
+		std::error_code error;
+		const std::uintmax_t size = std::filesystem::file_size(filename, error);
+		if(error) return std::nullopt;
+		
+		const std::filesystem::file_time_type last_write_time = std::filesystem::last_write_time(filename, error);
+		if(error) return std::nullopt;
+		
+		return SourceStamp{std::uint64_t(size), std::int64_t(last_write_time.time_since_epoch().count())};
+	}
+	
+	std::uint64_t checksum(const std::string_view bytes) noexcept{
+		//FNV-1a over 8 bytes at a time instead of a byte at a time, so checking the snapshot costs little next to loading it.
+		constexpr std::uint64_t fnv_offset_basis = 0xcbf29ce484222325;
+		constexpr std::uint64_t fnv_prime = 0x100000001b3;
+		
+		std::uint64_t hash = fnv_offset_basis;
+		std::string_view::size_type i = 0;
+		for(; i + sizeof(std::uint64_t) <= bytes.size(); i += sizeof(std::uint64_t))
+			hash = (hash ^ read_value<std::uint64_t>(bytes.data() + i)) * fnv_prime;
+		for(; i < bytes.size(); ++i)
+			hash = (hash ^ static_cast<unsigned char>(bytes[i])) * fnv_prime;
+		
+		return hash ^ bytes.size();
+	}
+	
+	std::string serialize(const std::vector<TaskGroup>& taskgroups, const SourceStamp& source){
+		//The groups as they are loaded from the task file, with the name they are loaded with.
+		struct LoadedGroup{
+			const TaskGroup* taskgroup;
+			const std::string* group_name;
+		};
+		std::vector<LoadedGroup> loaded_groups;
+		loaded_groups.reserve(taskgroups.size());
+		
+		const std::string no_group_name;
+		const std::string* lent_group_name = &no_group_name;
+		std::uint64_t task_count = 0;
+		std::uint64_t string_pool_size = 0;
+		
+		for(const TaskGroup& taskgroup : taskgroups){
+			if(!name_is_single_line(taskgroup.group_name)) return std::string();
+			
+			//overwrite_taskfile() writes a group without tasks as a group definition then its scope end, 
+			//which leaves its name to the next single task loaded.
+			if(taskgroup.tasks.empty()){
+				lent_group_name = &taskgroup.group_name;
+				continue;
+			}
+			
+			//a single task is written without its group.
+			const std::string* const group_name = (taskgroup.tasks.size() == 1) ? lent_group_name : &taskgroup.group_name;
+			lent_group_name = &no_group_name;
+			
+			for(const Task& task : taskgroup.tasks){
+				if(!task_survives_text(task)) return std::string();
+				string_pool_size += task.name().size();
+			}
+			
+			loaded_groups.push_back({&taskgroup, group_name});
+			task_count += taskgroup.tasks.size();
+			string_pool_size += group_name->size();
+		}
+		
+		constexpr std::uint64_t max_count = std::numeric_limits<std::uint32_t>::max();
+		if(loaded_groups.size() > max_count || task_count > max_count || string_pool_size > max_count) return std::string();
+		
+		//Every size is known up front, so the snapshot is written in a single allocation.
+		const std::size_t groups_start = sizeof(Header);
+		const std::size_t tasks_start = groups_start + loaded_groups.size() * sizeof(GroupRecord);
+		const std::size_t string_pool_start = tasks_start + task_count * sizeof(TaskRecord);
+		std::string snapshot(string_pool_start + string_pool_size, '\0');
+		
+		char* group_cursor = snapshot.data() + groups_start;
+		char* task_cursor = snapshot.data() + tasks_start;
+		char* const string_pool = snapshot.data() + string_pool_start;
+		std::uint32_t string_pool_used = 0;
+		std::uint32_t tasks_written = 0;
+		
+		const auto add_to_string_pool = [&](const std::string_view name){
+			std::memcpy(string_pool + string_pool_used, name.data(), name.size());
+			string_pool_used += std::uint32_t(name.size());
+		};
+		
+		for(const LoadedGroup& loaded_group : loaded_groups){
+			write_value(group_cursor, GroupRecord{string_pool_used, std::uint32_t(loaded_group.group_name->size()), 
+												tasks_written, std::uint32_t(loaded_group.taskgroup->tasks.size())});
+			add_to_string_pool(*loaded_group.group_name);
+			
+			for(const Task& task : loaded_group.taskgroup->tasks){
+				const std::int32_t due_date = std::int32_t(std::chrono::sys_days(task.due_date()).time_since_epoch().count());
+				write_value(task_cursor, TaskRecord{due_date, string_pool_used, std::uint32_t(task.name().size())});
+				add_to_string_pool(task.name());
+				tasks_written++;
+			}
+		}
+		
+		Header header;
+		std::memcpy(header.magic, magic, sizeof(magic));
+		header.version = format_version;
+		header.group_count = std::uint32_t(loaded_groups.size());
+		header.task_count = std::uint32_t(task_count);
+		header.string_pool_size = std::uint32_t(string_pool_size);
+		header.source_size = source.size;
+		header.source_last_write_time = source.last_write_time;
+		header.checksum = checksum(std::string_view(snapshot).substr(sizeof(Header)));
+		
+		char* header_cursor = snapshot.data();
+		write_value(header_cursor, header);
+		
+		return snapshot;
+	}
+	
+	std::optional<std::vector<TaskGroup>> deserialize(const std::string_view snapshot, const SourceStamp& source, const std::chrono::year_month_day& current_date){
+		if(snapshot.size() < sizeof(Header)) return std::nullopt;
+		
+		const Header header = read_value<Header>(snapshot.data());
+		if(std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != format_version) return std::nullopt;
+		if(SourceStamp{header.source_size, header.source_last_write_time} != source) return std::nullopt;
+		
+		//the counts are 32 bits, so the sizes cannot overflow 64 bits.
+		const std::uint64_t groups_start = sizeof(Header);
+		const std::uint64_t tasks_start = groups_start + std::uint64_t(header.group_count) * sizeof(GroupRecord);
+		const std::uint64_t string_pool_start = tasks_start + std::uint64_t(header.task_count) * sizeof(TaskRecord);
+		if(string_pool_start + header.string_pool_size != snapshot.size()) return std::nullopt;
+		if(checksum(snapshot.substr(sizeof(Header))) != header.checksum) return std::nullopt;
+		
+		const char* const string_pool = snapshot.data() + string_pool_start;
+		const auto name_in_string_pool = [&](const std::uint32_t offset, const std::uint32_t size){
+			return std::uint64_t(offset) + size <= header.string_pool_size;
+		};
+		
+		std::vector<TaskGroup> taskgroups;
+		taskgroups.reserve(header.group_count);
+		
+		for(std::uint32_t group_i = 0; group_i < header.group_count; ++group_i){
+			const GroupRecord group = read_value<GroupRecord>(snapshot.data() + groups_start + group_i * sizeof(GroupRecord));
+			if(!name_in_string_pool(group.name_offset, group.name_size)) return std::nullopt;
+			if(std::uint64_t(group.first_task) + group.task_count > header.task_count) return std::nullopt;
+			
+			TaskGroup& taskgroup = taskgroups.emplace_back();
+			taskgroup.group_name.assign(string_pool + group.name_offset, group.name_size);
+			taskgroup.tasks.reserve(group.task_count);
+			
+			for(std::uint32_t task_i = group.first_task; task_i < group.first_task + group.task_count; ++task_i){
+				const TaskRecord task = read_value<TaskRecord>(snapshot.data() + tasks_start + std::uint64_t(task_i) * sizeof(TaskRecord));
+				if(!name_in_string_pool(task.name_offset, task.name_size)) return std::nullopt;
+				
+				const auto due_date = std::chrono::year_month_day(std::chrono::sys_days(std::chrono::days(task.due_date)));
+				if(!due_date.ok()) return std::nullopt;
+				
+				taskgroup.tasks.emplace_back(due_date, std::string_view(string_pool + task.name_offset, task.name_size), current_date);
+			}
+		}
+		
+		return taskgroups;
+	}
+	
+	void save(const std::vector<TaskGroup>& taskgroups, const std::string& snapshot_filename, const std::string& source_filename){
+		const std::optional<SourceStamp> source = get_source_stamp(source_filename);
+		const std::string snapshot = source ? serialize(taskgroups, *source) : std::string();
+		if(snapshot.empty()){
+			remove(snapshot_filename);
+			return;
+		}
+		
+		std::ofstream file(snapshot_filename, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+		file.write(snapshot.data(), snapshot.size());
+		file.close();
+		
+		//a partly written snapshot fails its checksum anyway, but there is no reason to keep it.
+		if(file.fail()) remove(snapshot_filename);
+	}
+	
+	std::optional<std::vector<TaskGroup>> load(const std::string& snapshot_filename, const std::string& source_filename){
+		const std::optional<SourceStamp> source = get_source_stamp(source_filename);
+		if(!source) return std::nullopt;
+		
+		MappedFile snapshot_file;
+		try{
+			snapshot_file = MappedFile(snapshot_filename);
+		}
+		catch(const std::ios_base::failure& file_io_error) {return std::nullopt;}
+		catch(const std::runtime_error& file_not_opened) {return std::nullopt;}
+		
+		return deserialize(snapshot_file.view(), *source, get_current_ymd());
+	}
+	
+	void remove(const std::string& snapshot_filename) noexcept{
+		std::error_code error;
+		std::filesystem::remove(snapshot_filename, error);
+	}
+}
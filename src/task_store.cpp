@@ -0,0 +1,216 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "task_store.hpp"
+#include "Task.hpp"
+#include "name_pool.hpp"
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+#include <string_view>
+
+namespace{
+	std::int32_t to_day_count(const std::chrono::year_month_day& ymd) noexcept{
+		return std::int32_t(std::chrono::sys_days(ymd).time_since_epoch().count());
+	}
+}
+
+TaskStore::TaskStore(const std::chrono::year_month_day& current_ymd)
+:	current_day(to_day_count(current_ymd))
+{
+	//nothing here :D
+}
+
+TaskStore::GroupId TaskStore::add_group(const TaskGroup& taskgroup){
+	GroupId group;
+	if(this->free_group_ids.empty()){
+		group = GroupId(this->group_names.size());
+		this->group_names.push_back(taskgroup.group_name);
+		this->group_task_ids.emplace_back();
+		this->group_generations.push_back(0);
+	}else{
+		group = this->free_group_ids.back();
+		this->free_group_ids.pop_back();
+		this->group_names[group] = taskgroup.group_name;
+	}
+	this->group_generations[group] = this->next_generation++;
+	
+	this->group_task_ids[group].reserve(taskgroup.tasks.size());
+	for(const Task& task : taskgroup.tasks) this->add_task(group, task);
+	return group;
+}
+
+void TaskStore::erase_group(const GroupId group){
+	for(const TaskId task : this->group_task_ids[group]){
+		this->task_groups[task] = no_id;
+		this->names[task] = name_pool::Name();
+		this->task_generations[task] = 0;
+		this->free_task_ids.push_back(task);
+	}
+	
+	//the memory of the name and the tasks is released, rather than kept for the next group reusing the ID.
+	this->group_task_ids[group] = std::vector<TaskId>();
+	this->group_names[group] = std::string();
+	this->group_generations[group] = 0;
+	this->free_group_ids.push_back(group);
+}
+
+void TaskStore::rename_group(const GroupId group, const std::string_view group_name){
+	this->group_names[group] = group_name;
+}
+
+void TaskStore::merge_groups(const GroupId into, const GroupId from){
+	std::vector<TaskId>& tasks = this->group_task_ids[into];
+	std::vector<TaskId>& moved_tasks = this->group_task_ids[from];
+	for(const TaskId task : moved_tasks) this->task_groups[task] = into;
+	
+	//both groups are sorted already, so they are merged in linear time. The merge is stable, the tasks of into stay before the moved ones with the same due date.
+	const std::size_t sorted_size = tasks.size();
+	tasks.insert(tasks.end(), moved_tasks.begin(), moved_tasks.end());
+	std::inplace_merge(tasks.begin(), tasks.begin() + sorted_size, tasks.end(), [this](const TaskId lhs, const TaskId rhs){return this->due_days[lhs] < this->due_days[rhs];});
+	
+	moved_tasks.clear();
+}
+
+TaskGroup TaskStore::taskgroup(const GroupId group) const{
+	TaskGroup taskgroup{this->group_names[group], {}};
+	
+	const std::vector<TaskId>& tasks = this->group_task_ids[group];
+	taskgroup.tasks.reserve(tasks.size());
+	for(const TaskId task : tasks) taskgroup.tasks.push_back(this->task(task));
+	
+	return taskgroup;
+}
+
+std::vector<TaskGroup> TaskStore::taskgroups(const std::vector<GroupId>& groups) const{
+	std::vector<TaskGroup> taskgroups;
+	taskgroups.reserve(groups.size());
+	for(const GroupId group : groups) taskgroups.push_back(this->taskgroup(group));
+	return taskgroups;
+}
+
+TaskStore::TaskId TaskStore::add_task(const GroupId group, const Task& task){
+	TaskId task_id;
+	if(this->free_task_ids.empty()){
+		task_id = TaskId(this->due_days.size());
+		this->due_days.push_back(to_day_count(task.due_date()));
+		this->names.push_back(task.interned_name());
+		this->task_groups.push_back(no_id);
+		this->task_generations.push_back(0);
+	}else{
+		task_id = this->free_task_ids.back();
+		this->free_task_ids.pop_back();
+		this->due_days[task_id] = to_day_count(task.due_date());
+		this->names[task_id] = task.interned_name();
+	}
+	this->task_generations[task_id] = this->next_generation++;
+	
+	this->insert_sorted(task_id, group);
+	return task_id;
+}
+
+void TaskStore::erase_task(const TaskId task){
+	this->remove_from_group(task);
+	this->task_groups[task] = no_id;
+	this->names[task] = name_pool::Name();
+	this->task_generations[task] = 0;
+	this->free_task_ids.push_back(task);
+}
+
+void TaskStore::set_task(const TaskId task, const std::chrono::year_month_day& due_date, const std::string_view name){
+	std::vector<TaskId>& tasks = this->group_task_ids[this->task_groups[task]];
+	this->names[task] = name_pool::intern(name);
+	
+	const auto position = this->find_in_group(task);
+	const std::int32_t old_due_day = this->due_days[task];
+	const std::int32_t new_due_day = to_day_count(due_date);
+	this->due_days[task] = new_due_day;
+	
+	//the task is rotated to its new place, only the tasks between its old and new place move.
+	//As if it was added again, it goes after the tasks with the same due date.
+	const auto due_after = [this](const std::int32_t day, const TaskId other){return day < this->due_days[other];};
+	if(new_due_day < old_due_day){
+		const auto new_position = std::upper_bound(tasks.begin(), position, new_due_day, due_after);
+		std::rotate(new_position, position, position + 1);
+	}else{
+		const auto new_position = std::upper_bound(position + 1, tasks.end(), new_due_day, due_after);
+		std::rotate(position, position + 1, new_position);
+	}
+}
+
+void TaskStore::move_task(const TaskId task, const GroupId group){
+	this->remove_from_group(task);
+	this->insert_sorted(task, group);
+}
+
+Task TaskStore::task(const TaskId task) const{
+	return Task(this->due_date(task), this->names[task], this->current_ymd());
+}
+
+std::chrono::year_month_day TaskStore::due_date(const TaskId task) const noexcept{
+	return std::chrono::year_month_day(std::chrono::sys_days(std::chrono::days(this->due_days[task])));
+}
+
+TaskStore::TaskId TaskStore::find_task(const TaskHandle& handle) const noexcept{
+	//erased IDs have generation 0, which no handle of a task in the store has.
+	if(handle.id >= this->task_generations.size() || handle.generation == 0 || this->task_generations[handle.id] != handle.generation) return no_id;
+	return handle.id;
+}
+
+TaskStore::GroupId TaskStore::find_group(const GroupHandle& handle) const noexcept{
+	if(handle.id >= this->group_generations.size() || handle.generation == 0 || this->group_generations[handle.id] != handle.generation) return no_id;
+	return handle.id;
+}
+
+void TaskStore::clear() noexcept{
+	this->due_days.clear();
+	this->names.clear();
+	this->task_groups.clear();
+	this->task_generations.clear();
+	this->free_task_ids.clear();
+	this->group_names.clear();
+	this->group_task_ids.clear();
+	this->group_generations.clear();
+	this->free_group_ids.clear();
+}
+
+//private
+std::chrono::year_month_day TaskStore::current_ymd() const noexcept{
+	return std::chrono::year_month_day(std::chrono::sys_days(std::chrono::days(this->current_day)));
+}
+
+void TaskStore::insert_sorted(const TaskId task, const GroupId group){
+	std::vector<TaskId>& tasks = this->group_task_ids[group];
+	const std::int32_t due_day = this->due_days[task];
+	
+	//tasks are mostly added in order of due date, such as from a saved task file, so the place is checked from the end first.
+	const auto place = (tasks.empty() || this->due_days[tasks.back()] <= due_day) ? tasks.end()
+						: std::upper_bound(tasks.begin(), tasks.end(), due_day, [this](const std::int32_t day, const TaskId other){return day < this->due_days[other];});
+	tasks.insert(place, task);
+	this->task_groups[task] = group;
+}
+
+void TaskStore::remove_from_group(const TaskId task){
+	this->group_task_ids[this->task_groups[task]].erase(this->find_in_group(task));
+}
+
+std::vector<TaskStore::TaskId>::iterator TaskStore::find_in_group(const TaskId task){
+	std::vector<TaskId>& tasks = this->group_task_ids[this->task_groups[task]];
+	const std::int32_t due_day = this->due_days[task];
+	
+	//only the tasks with the same due date are searched.
+	const auto same_due_date = std::lower_bound(tasks.begin(), tasks.end(), due_day, [this](const TaskId other, const std::int32_t day){return this->due_days[other] < day;});
+	return std::find(same_due_date, tasks.end(), task);
+}
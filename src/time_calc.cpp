@@ -11,7 +11,7 @@ You should have received a copy of the GNU General Public License along with Wor
 */
 
 #include "time_calc.hpp"
-#include "Timescale.hpp"
+#include "timescale.hpp"
 
 #include <chrono>
 #include <string>
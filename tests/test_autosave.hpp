@@ -0,0 +1,66 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef test_autosave_hpp
+#define test_autosave_hpp
+
+#include "autosave.hpp"
+
+#include <chrono>
+#include <cassert>
+
+namespace test_autosave_internal{
+	inline void test_edits_are_coalesced(){
+		using namespace std::chrono_literals;
+		autosave::Scheduler scheduler({2s, 10s});
+		const autosave::Clock::time_point start = autosave::Clock::now();
+		
+		assert(!scheduler.save_pending());
+		assert(!scheduler.save_due(start + 1h));
+		
+		//a burst of edits moves the save to a quiet period after the last of them.
+		assert(scheduler.record_edit(start) == start + 2s);
+		assert(scheduler.record_edit(start + 1s) == start + 3s);
+		assert(scheduler.record_edit(start + 1500ms) == start + 3500ms);
+		assert(!scheduler.save_due(start + 3s));
+		assert(scheduler.save_due(start + 3500ms));
+		
+		scheduler.record_save(start + 3500ms);
+		assert(!scheduler.save_pending());
+	}
+	
+	inline void test_saves_are_at_least_an_interval_apart(){
+		using namespace std::chrono_literals;
+		autosave::Scheduler scheduler({2s, 10s});
+		const autosave::Clock::time_point start = autosave::Clock::now();
+		
+		scheduler.record_edit(start);
+		scheduler.record_save(start + 2s);
+		
+		//quiet after 2 seconds, but the last save was less than 10 seconds before.
+		assert(scheduler.record_edit(start + 3s) == start + 12s);
+		assert(!scheduler.save_due(start + 5s));
+		assert(scheduler.save_due(start + 12s));
+		
+		//long after the last save, only the quiet period is left.
+		scheduler.record_save(start + 12s);
+		assert(scheduler.record_edit(start + 1min) == start + 1min + 2s);
+	}
+}
+
+inline void test_suite_autosave(){
+	test_autosave_internal::test_edits_are_coalesced();
+	test_autosave_internal::test_saves_are_at_least_an_interval_apart();
+}
+
+#endif
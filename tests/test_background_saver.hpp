@@ -0,0 +1,136 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef test_background_saver_hpp
+#define test_background_saver_hpp
+
+#include "background_saver.hpp"
+#include "task_snapshot.hpp"
+
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <thread>
+#include <cassert>
+#include <optional>
+#include <stdexcept>
+#include <condition_variable>
+
+namespace test_background_saver_internal{
+	inline void _test_count_notification(void* const data){
+		static_cast<std::atomic<int>*>(data)->fetch_add(1);
+	}
+	
+	inline void test_jobs_run_in_order(){
+		std::atomic<int> notification_count = 0;
+		std::vector<int> written;
+		
+		BackgroundSaver saver(_test_count_notification, &notification_count);
+		for(int i = 0; i < 5; ++i)
+			saver.submit([&written, i](){
+				written.push_back(i);
+				return std::nullopt;
+			});
+		saver.wait_until_idle();
+		
+		assert(!saver.busy());
+		assert((written == std::vector<int>{0, 1, 2, 3, 4}));
+		//the saver is idle before the notification of the last job, so the notified thread sees it as idle.
+		while(notification_count != 5) std::this_thread::yield();
+		
+		const std::vector<BackgroundSaver::Result> results = saver.take_results();
+		assert(results.size() == 5);
+		for(const BackgroundSaver::Result& result : results){
+			assert(result.status == BackgroundSaver::Result::Status::Saved);
+			assert(!result.written_stamp);
+		}
+		assert(saver.take_results().empty());
+	}
+	
+	inline void test_written_stamp_is_returned(){
+		const task_snapshot::SourceStamp stamp = {1234, 5678};
+		
+		BackgroundSaver saver;
+		saver.submit([stamp](){return std::optional<task_snapshot::SourceStamp>(stamp);});
+		saver.submit([](){return std::nullopt;});
+		saver.wait_until_idle();
+		
+		const std::vector<BackgroundSaver::Result> results = saver.take_results();
+		assert(results.size() == 2);
+		assert(results[0].written_stamp == stamp);
+		assert(!results[1].written_stamp);
+	}
+	
+	inline void test_failed_job_cancels_queued_jobs(){
+		//the first job holds the worker until the rest are queued, so they are all cancelled by the failure.
+		std::mutex mutex;
+		std::condition_variable jobs_queued;
+		bool all_jobs_submitted = false;
+		bool cancelled_job_ran = false;
+		
+		BackgroundSaver saver;
+		saver.submit([&]() -> std::optional<task_snapshot::SourceStamp> {
+			std::unique_lock<std::mutex> lock(mutex);
+			jobs_queued.wait(lock, [&](){return all_jobs_submitted;});
+			throw std::runtime_error("disk full");
+		});
+		for(int i = 0; i < 2; ++i){
+			saver.submit([&](){
+				cancelled_job_ran = true;
+				return std::nullopt;
+			});
+		}
+		{
+			const std::lock_guard<std::mutex> lock(mutex);
+			all_jobs_submitted = true;
+		}
+		jobs_queued.notify_one();
+		saver.wait_until_idle();
+		
+		const std::vector<BackgroundSaver::Result> results = saver.take_results();
+		assert(!cancelled_job_ran);
+		assert(results.size() == 3);
+		assert(results[0].status == BackgroundSaver::Result::Status::Failed);
+		assert(results[0].error_message == "disk full");
+		assert(results[1].status == BackgroundSaver::Result::Status::Cancelled);
+		assert(results[2].status == BackgroundSaver::Result::Status::Cancelled);
+		
+		//the jobs submitted after the failure was reported run as usual.
+		saver.submit([](){return std::nullopt;});
+		saver.wait_until_idle();
+		assert(saver.take_results().front().status == BackgroundSaver::Result::Status::Saved);
+	}
+	
+	inline void test_queued_jobs_finish_on_destruction(){
+		std::atomic<int> finished_job_count = 0;
+		{
+			BackgroundSaver saver;
+			for(int i = 0; i < 3; ++i)
+				saver.submit([&finished_job_count](){
+					finished_job_count++;
+					return std::nullopt;
+				});
+		}
+		assert(finished_job_count == 3);
+	}
+}
+
+inline void test_suite_background_saver(){
+	test_background_saver_internal::test_jobs_run_in_order();
+	test_background_saver_internal::test_written_stamp_is_returned();
+	test_background_saver_internal::test_failed_job_cancels_queued_jobs();
+	test_background_saver_internal::test_queued_jobs_finish_on_destruction();
+}
+
+#endif
@@ -0,0 +1,80 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef test_byte_scan_hpp
+#define test_byte_scan_hpp
+
+#include "byte_scan.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+#include <cassert>
+#include <string_view>
+
+namespace test_byte_scan_internal{
+	inline const std::vector<byte_scan::Kernel> _test_kernels = {
+		byte_scan::Kernel::Scalar, byte_scan::Kernel::SSE2, byte_scan::Kernel::AVX2
+	};
+	
+	inline void test_find_first_of__differential(){
+		const std::vector<byte_scan::ScanSet> sets = {
+			{'\n'}, {','}, {'\n', ','}, {'\n', ',', '{', '}'}
+		};
+		//mostly task file characters, so the delimiters are sparse but do appear.
+		constexpr std::string_view alphabet = "0123456789/ abcdefghijklmnopqrstuvwxyz,\n{}";
+		
+		std::mt19937 rng(20240501);
+		std::uniform_int_distribution<std::size_t> length_distribution(0, 200);
+		std::uniform_int_distribution<std::size_t> sparse_distribution(0, alphabet.size() * 8);
+		
+		for(int iteration = 0; iteration < 2000; ++iteration){
+			std::string buffer(length_distribution(rng), ' ');
+			for(char& c : buffer){
+				const std::size_t i = sparse_distribution(rng);
+				c = (i < alphabet.size()) ? alphabet[i] : 'x';
+			}
+			
+			//every starting position, so the kernels are tested with unaligned blocks and every tail length.
+			for(std::size_t start = 0; start <= buffer.size(); ++start){
+				const char* const first = buffer.data() + start;
+				const char* const last = buffer.data() + buffer.size();
+				
+				for(const byte_scan::ScanSet& set : sets){
+					const char* const expected_result = byte_scan::find_first_of(byte_scan::Kernel::Scalar, first, last, set);
+					
+					for(const byte_scan::Kernel kernel : _test_kernels){
+						if(!byte_scan::kernel_supported(kernel)) continue;
+						assert(byte_scan::find_first_of(kernel, first, last, set) == expected_result);
+					}
+					assert(byte_scan::find_first_of(first, last, set) == expected_result);
+				}
+			}
+		}
+	}
+	
+	inline void test_find(){
+		constexpr std::string_view str = "2025/05/03, cookies, and milk\n";
+		assert(byte_scan::find(str, ',') == str.find(','));
+		assert(byte_scan::find(str, ',', 11) == str.find(',', 11));
+		assert(byte_scan::find(str, '{') == std::string_view::npos);
+		assert(byte_scan::find(str, '\n', str.size()) == std::string_view::npos);
+		assert(byte_scan::find(std::string_view(), '\n') == std::string_view::npos);
+	}
+}
+
+inline void test_suite_byte_scan(){
+	test_byte_scan_internal::test_find_first_of__differential();
+	test_byte_scan_internal::test_find();
+}
+
+#endif
@@ -0,0 +1,78 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef test_file_watch_hpp
+#define test_file_watch_hpp
+
+#include "file_watch.hpp"
+#include "task_snapshot.hpp"
+
+#include <string>
+#include <cassert>
+#include <fstream>
+#include <filesystem>
+
+namespace test_file_watch_internal{
+	inline void _test_write(const std::string& filename, const std::string& contents){
+		std::ofstream file(filename, std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+		file << contents;
+	}
+	
+	inline void test_file_watcher(){
+		const std::filesystem::path directory = std::filesystem::temp_directory_path();
+		const std::string filename = (directory / "worktable_test_watched_tasks.txt").string();
+		_test_write(filename, "2025/1/1, a\n");
+		
+		FileWatcher watcher(filename);
+		assert(!watcher.changed());
+		
+		//a different size changes the stamp, even if the last write time is within the resolution of the file system.
+		_test_write(filename, "2025/1/1, a\n2025/1/2, b\n");
+		assert(watcher.changed());
+		assert(!watcher.changed());
+		
+		//a write acknowledged as made by WorkTable itself is not a change.
+		_test_write(filename, "2025/1/1, a\n");
+		watcher.acknowledge_change();
+		assert(!watcher.changed());
+		_test_write(filename, "2025/1/1, a\n2025/1/4, d\n");
+		watcher.acknowledge_write(*task_snapshot::get_source_stamp(filename));
+		assert(!watcher.changed());
+		
+		//a change made by another program after WorkTable wrote the file is still reported once the write is acknowledged.
+		_test_write(filename, "2025/1/1, a\n2025/1/4, d\n");
+		const task_snapshot::SourceStamp written_stamp = *task_snapshot::get_source_stamp(filename);
+		_test_write(filename, "2025/1/1, a\n2025/1/4, d\n2025/1/5, e\n");
+		watcher.acknowledge_write(written_stamp);
+		assert(watcher.changed());
+		assert(!watcher.changed());
+		
+		//a change deferred while WorkTable is writing the file is still reported afterwards.
+		_test_write(filename, "2025/1/1, a\n");
+		watcher.defer_change();
+		assert(watcher.changed());
+		
+		//a missing file is not a change, until it is written again.
+		std::filesystem::remove(filename);
+		assert(!watcher.changed());
+		_test_write(filename, "2025/1/3, c\n2025/1/2, b\n2025/1/1, a\n");
+		assert(watcher.changed());
+		
+		std::filesystem::remove(filename);
+	}
+}
+
+inline void test_suite_file_watch(){
+	test_file_watch_internal::test_file_watcher();
+}
+
+#endif
@@ -11,6 +11,19 @@ You should have received a copy of the GNU General Public License along with Wor
 */
 
 #include "test_task_io.hpp"
+#include "test_byte_scan.hpp"
+#include "test_task_snapshot.hpp"
+#include "test_task_journal.hpp"
+#include "test_background_saver.hpp"
+#include "test_autosave.hpp"
+#include "test_task_index.hpp"
+#include "test_task_diff.hpp"
+#include "test_file_watch.hpp"
+#include "test_parse_diagnostics.hpp"
+#include "test_task_batch.hpp"
+#include "test_task_exchange.hpp"
+#include "test_name_pool.hpp"
+#include "test_task_store.hpp"
 
 #include <iostream>
 
@@ -18,6 +31,19 @@ int main(){
 	try{	
 		std::clog << "Initiating test. If an [ALL CLEAR] is not displayed, the test has failed.\n";
 		test_suite_task_io();
+		test_suite_byte_scan();
+		test_suite_task_snapshot();
+		test_suite_task_journal();
+		test_suite_background_saver();
+		test_suite_autosave();
+		test_suite_task_index();
+		test_suite_task_diff();
+		test_suite_file_watch();
+		test_suite_parse_diagnostics();
+		test_suite_task_batch();
+		test_suite_task_exchange();
+		test_suite_name_pool();
+		test_suite_task_store();
 		std::clog << "[ALL CLEAR]: all tests verified.\n";
 		return 0;
 	}
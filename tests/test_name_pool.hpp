@@ -0,0 +1,159 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef test_name_pool_hpp
+#define test_name_pool_hpp
+
+#include "Task.hpp"
+#include "name_pool.hpp"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cassert>
+#include <utility>
+#include <string_view>
+
+namespace test_name_pool_internal{
+	inline void test_intern(){
+		assert(name_pool::intern("").handle() == name_pool::empty_name);
+		assert(name_pool::view(name_pool::empty_name).empty());
+		
+		const std::string name = "name pool test: cookies";
+		const name_pool::Name interned = name_pool::intern(name);
+		assert(interned.handle() != name_pool::empty_name);
+		assert(name_pool::intern(std::string_view(name)) == interned);
+		assert(name_pool::intern("name pool test: milk") != interned);
+		
+		const std::string_view viewed_name = interned.view();
+		assert(viewed_name == name && viewed_name.data() != name.data());
+		assert(viewed_name.data()[viewed_name.size()] == '\0');
+		assert(name_pool::view(interned.handle()) == viewed_name);
+		
+		//a name longer than the text chunks share.
+		const std::string long_name(100000, 'x');
+		const name_pool::Name interned_long_name = name_pool::intern(long_name);
+		assert(interned_long_name.view() == long_name);
+		assert(interned_long_name == name_pool::intern(std::string(100000, 'x')));
+	}
+	
+	inline void test_release(){
+		const std::size_t name_count = name_pool::name_count();
+		{
+			const name_pool::Name interned = name_pool::intern("name pool release test");
+			name_pool::Name copied = interned;
+			name_pool::Name moved = std::move(copied);
+			assert(moved == interned && name_pool::name_count() == name_count + 1);
+			
+			//assigning a Name to itself keeps the name.
+			moved = *&moved;
+			assert(moved.view() == "name pool release test");
+		}
+		assert(name_pool::name_count() == name_count);
+		
+		//the names of a replaced list of tasks are released, along with the names left behind by renaming.
+		{
+			std::vector<Task> tasks;
+			for(int i = 0; i < 5000; ++i) tasks.emplace_back(std::chrono::year_month_day(std::chrono::year(2025), std::chrono::month(1), std::chrono::day(1)), "name pool release test " + std::to_string(i));
+			for(Task& task : tasks) task.name(std::string(task.name()) + " renamed");
+			assert(name_pool::name_count() == name_count + 5000);
+			
+			std::vector<Task> copied_tasks = tasks;
+			tasks.clear();
+			assert(name_pool::name_count() == name_count + 5000);
+			assert(copied_tasks.back().name() == "name pool release test 4999 renamed");
+		}
+		assert(name_pool::name_count() == name_count);
+		
+		//a released name is interned again as any other.
+		assert(name_pool::intern("name pool release test").view() == "name pool release test");
+		assert(name_pool::name_count() == name_count);
+	}
+	
+	///Names interned from several threads at once, past the first segment of handles, have one handle each.
+	inline void test_intern__threads(){
+		constexpr int thread_count = 4;
+		constexpr int name_count = 3000;
+		
+		std::vector<std::vector<name_pool::Name>> names(thread_count, std::vector<name_pool::Name>(name_count));
+		std::vector<std::thread> threads;
+		for(int t = 0; t < thread_count; ++t){
+			threads.emplace_back([&names, t](){
+				for(int i = 0; i < name_count; ++i) names[t][i] = name_pool::intern("name pool thread test " + std::to_string(i));
+			});
+		}
+		for(std::thread& thread : threads) thread.join();
+		
+		for(int i = 0; i < name_count; ++i){
+			for(int t = 1; t < thread_count; ++t) assert(names[t][i] == names[0][i]);
+			assert(names[0][i].view() == "name pool thread test " + std::to_string(i));
+		}
+		assert(name_pool::name_count() > std::size_t(name_count));
+	}
+	
+	///The same few names dropped and interned again from several threads at once, so names are interned again while being released.
+	inline void test_release__threads(){
+		constexpr int thread_count = 4;
+		const std::size_t name_count = name_pool::name_count();
+		
+		std::vector<std::thread> threads;
+		for(int t = 0; t < thread_count; ++t){
+			threads.emplace_back([](){
+				for(int i = 0; i < 20000; ++i){
+					const std::string name = "name pool churn test " + std::to_string(i % 8);
+					name_pool::Name interned = name_pool::intern(name);
+					const name_pool::Name copied = interned;
+					interned = name_pool::Name();
+					assert(copied.view() == name);
+				}
+			});
+		}
+		for(std::thread& thread : threads) thread.join();
+		
+		assert(name_pool::name_count() == name_count);
+	}
+	
+	inline void test_task(){
+		using namespace std::chrono;
+		const year_month_day due_date(year(2025), month(3), day(1));
+		
+		Task task(due_date, "dishes", year_month_day(year(2025), month(2), day(27)));
+		assert(task.name() == "dishes" && task.due_date() == due_date);
+		assert(task.days_remaining() == days(2));
+		
+		//the old name stays valid while a copy of the task keeps it.
+		const Task task_before_renaming = task;
+		const std::string_view old_name = task.name();
+		task.name("laundry");
+		assert(task.name() == "laundry" && old_name == "dishes");
+		assert(task == Task(due_date, std::string("laundry")));
+		assert(task != Task(due_date, "dishes"));
+		assert(task_before_renaming == Task(due_date, "dishes"));
+		
+		const Task far_task(year_month_day(year(-32767), month(1), day(1)), "far");
+		assert(far_task.due_date() == year_month_day(year(-32767), month(1), day(1)));
+		assert(Task::due_date_is_earlier(far_task, task) && Task::due_date_is_later(task, far_task));
+		
+		assert(Task().name().empty() && Task().days_remaining() == days(0));
+	}
+}
+
+inline void test_suite_name_pool(){
+	test_name_pool_internal::test_intern();
+	test_name_pool_internal::test_release();
+	test_name_pool_internal::test_intern__threads();
+	test_name_pool_internal::test_release__threads();
+	test_name_pool_internal::test_task();
+}
+
+#endif
@@ -0,0 +1,140 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef test_parse_diagnostics_hpp
+#define test_parse_diagnostics_hpp
+
+#include "task_io.hpp"
+#include "task_index.hpp"
+#include "parse_diagnostics.hpp"
+#include "test_task_io.hpp"
+
+#include <vector>
+#include <string>
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+
+namespace test_parse_diagnostics_internal{
+	using parse_diagnostics::Kind;
+	using parse_diagnostics::Diagnostic;
+	
+	//a nested group on line 4 and invalid due dates on lines 5 and 8, with the empty lines counted in between.
+	const std::string _test_task_file = "g{\n2025/1/2, y\n\nh{\n2025/13/1, bad\n}\n\n2025/99/9, also bad\n2025/1/1, z";
+	
+	inline std::vector<Diagnostic> _test_expected_diagnostics(){
+		return {
+			{Kind::NestedGroup, 4, _test_task_file.find("h{"), "h{"},
+			{Kind::InvalidDueDate, 5, _test_task_file.find("2025/13/1"), "2025/13/1, bad"},
+			{Kind::InvalidDueDate, 8, _test_task_file.find("2025/99/9"), "2025/99/9, also bad"}
+		};
+	}
+	
+	inline bool _test_same_diagnostics(const std::vector<Diagnostic>& a, const std::vector<Diagnostic>& b){
+		return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const Diagnostic& x, const Diagnostic& y){
+			return (x.kind == y.kind) && (x.line_number == y.line_number) && (x.byte_offset == y.byte_offset) && (x.text == y.text);
+		});
+	}
+	
+	inline std::vector<TaskGroup> _test_expected_result(){
+		parse_diagnostics::Collector collector;
+		TaskFileParser parser(test_task_io_internal::_test_nested_group_callback, &collector);
+		parser.feed(_test_task_file.data(), _test_task_file.size());
+		return parser.finish();
+	}
+	
+	inline void test_feed(){
+		const int warning_count_before = test_task_io_internal::_test_nested_group_warning_count;
+		
+		//every chunk size, which splits the lines with errors at every possible position.
+		for(std::size_t chunk_size = 1; chunk_size <= _test_task_file.size() + 1; ++chunk_size){
+			parse_diagnostics::Collector collector;
+			TaskFileParser parser(test_task_io_internal::_test_nested_group_callback, &collector);
+			for(std::size_t i = 0; i < _test_task_file.size(); i += chunk_size)
+				parser.feed(_test_task_file.data() + i, std::min(chunk_size, _test_task_file.size() - i));
+			
+			assert(parser.finish() == _test_expected_result());
+			assert(_test_same_diagnostics(collector.diagnostics(), _test_expected_diagnostics()));
+		}
+		
+		//the errors are recorded instead of calling the callback.
+		assert(test_task_io_internal::_test_nested_group_warning_count == warning_count_before);
+	}
+	
+	inline void test_parse_chunks_parallel(){
+		for(std::size_t chunk_count = 1; chunk_count <= 8; ++chunk_count){
+			parse_diagnostics::Collector collector;
+			const std::vector<TaskGroup> taskgroups = task_io_internal::parse_chunks_parallel(task_io_internal::split_at_lines(_test_task_file, chunk_count), 4,
+																								test_task_io_internal::_test_nested_group_callback, &collector);
+			assert(taskgroups == _test_expected_result());
+			assert(_test_same_diagnostics(collector.diagnostics(), _test_expected_diagnostics()));
+		}
+	}
+	
+	///Loading the groups of the index one by one records the same positions as parsing the task file entirely.
+	inline void test_task_index_load(){
+		parse_diagnostics::Collector collector;
+		const std::vector<task_index::Span> spans = task_index::build(_test_task_file);
+		for(const task_index::Span& span : spans)
+			task_index::load(_test_task_file, span, test_task_io_internal::_test_nested_group_callback, &collector);
+		
+		assert(_test_same_diagnostics(collector.diagnostics(), _test_expected_diagnostics()));
+	}
+	
+	///A group without its scope ending is dropped if its last line is not a task, and so are the invalid due dates of its tasks,
+	///while its nested groups are still recorded as lines_to_TaskStrGroup() records them.
+	inline void test_dropped_group(){
+		const std::string task_file = "2025/1/1, kept\ng{\n2025/13/1, bad\nh{\n2025/1/2, dropped\ni{";
+		
+		parse_diagnostics::Collector collector;
+		TaskFileParser parser(test_task_io_internal::_test_nested_group_callback, &collector);
+		parser.feed(task_file.data(), task_file.size());
+		const std::vector<TaskGroup> taskgroups = parser.finish();
+		assert(taskgroups.size() == 1 && taskgroups.front().tasks.front().name() == "kept");
+		
+		assert(collector.count(Kind::InvalidDueDate) == 0);
+		assert(collector.count(Kind::NestedGroup) == 2);
+		assert(collector.diagnostics().front().line_number == 4);
+	}
+	
+	inline void test_collector(){
+		parse_diagnostics::Collector collector(2);
+		for(std::size_t i = 1; i <= 4; ++i)
+			collector.record(Kind::InvalidDueDate, i, i * 10, "2025/13/1, bad");
+		collector.record(Kind::NestedGroup, 5, 50, "h{");
+		
+		//the errors past the ones kept are still counted.
+		assert(collector.diagnostics().size() == 2);
+		assert(collector.count() == 5);
+		assert(collector.count(Kind::InvalidDueDate) == 4);
+		assert(collector.count(Kind::NestedGroup) == 1);
+		
+		const std::string summary = parse_diagnostics::summary(collector, 1);
+		assert(summary.find("line 1 (byte 10): invalid due date: 2025/13/1, bad") != std::string::npos);
+		assert(summary.find("line 2 ") == std::string::npos);
+		assert(summary.find("...and 4 more.") != std::string::npos);
+		
+		collector.clear();
+		assert(collector.empty());
+		assert(collector.diagnostics().empty());
+	}
+}
+
+inline void test_suite_parse_diagnostics(){
+	test_parse_diagnostics_internal::test_feed();
+	test_parse_diagnostics_internal::test_parse_chunks_parallel();
+	test_parse_diagnostics_internal::test_task_index_load();
+	test_parse_diagnostics_internal::test_dropped_group();
+	test_parse_diagnostics_internal::test_collector();
+}
+
+#endif
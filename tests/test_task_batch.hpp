@@ -0,0 +1,213 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef test_task_batch_hpp
+#define test_task_batch_hpp
+
+#include "task_batch.hpp"
+#include "task_io.hpp"
+#include "test_task_io.hpp"
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cassert>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+
+namespace test_task_batch_internal{
+	inline std::chrono::year_month_day _test_ymd(const int y, const unsigned m, const unsigned d){
+		return std::chrono::year_month_day(std::chrono::year(y), std::chrono::month(m), std::chrono::day(d));
+	}
+	
+	inline void _test_run(task_batch::Batch& batch, const std::string& line, std::string& output){
+		batch.run(task_batch::split_arguments(line), output);
+	}
+	
+	///Returns true if the line throws std::invalid_argument, and the groups are left as is.
+	inline bool _test_run_throws(task_batch::Batch& batch, const std::string& line){
+		const std::vector<TaskGroup> taskgroups_before = batch.taskgroups();
+		std::string output;
+		try{
+			_test_run(batch, line, output);
+		}catch(const std::invalid_argument& invalid_command){
+			return batch.taskgroups() == taskgroups_before;
+		}
+		return false;
+	}
+	
+	inline void test_split_arguments(){
+		assert((task_batch::split_arguments("  add\t2025/1/1 \"a \\\"quoted\\\" name\"\r") == std::vector<std::string>{"add", "2025/1/1", "a \"quoted\" name"}));
+		assert((task_batch::split_arguments("group \"\" x") == std::vector<std::string>{"group", "", "x"}));
+		assert(task_batch::split_arguments(" \t ").empty());
+		
+		try{
+			task_batch::split_arguments("add \"unclosed");
+		}catch(const std::invalid_argument& unclosed_quote){
+			return;
+		}
+		const bool unclosed_quote_throws = true;
+		assert(!unclosed_quote_throws);
+	}
+	
+	inline void test_add_and_list(){
+		task_batch::Batch batch({}, _test_ymd(2025, 1, 1));
+		std::string output;
+		_test_run(batch, "add 2025/1/20 \"far away\"", output);
+		_test_run(batch, "add --group chores 2025/1/3 dishes", output);
+		_test_run(batch, "add --group chores 2024/12/31 laundry", output);
+		_test_run(batch, "add 2025/1/3 groceries", output);
+		assert(batch.modified());
+		assert(batch.taskgroups().size() == 3);
+		assert(batch.taskgroups()[1].group_name == "chores" && batch.taskgroups()[1].tasks.size() == 2);
+		assert(output.empty());
+		
+		//sorted by due date, the tasks due on the same day in the order they were added, and the overdue ones are listed.
+		_test_run(batch, "list --due-within 1w", output);
+		assert(output == "2024/12/31\tchores\tlaundry\n2025/1/3\tchores\tdishes\n2025/1/3\t\tgroceries\n");
+		
+		output.clear();
+		_test_run(batch, "list --due-within 18", output);
+		assert(output.find("far away") == std::string::npos);
+		output.clear();
+		_test_run(batch, "list --due-within 3w --group chores", output);
+		assert(output == "2024/12/31\tchores\tlaundry\n2025/1/3\tchores\tdishes\n");
+		
+		assert(_test_run_throws(batch, "add 2025/13/1 invalid"));
+		assert(_test_run_throws(batch, "add 2025/1/1 \"group{\""));
+		assert(_test_run_throws(batch, "add 2025/1/1"));
+		assert(_test_run_throws(batch, "add --group \"\" 2025/1/1 x"));
+		assert(_test_run_throws(batch, "list --due-within soon"));
+		assert(_test_run_throws(batch, "list --sort"));
+		assert(_test_run_throws(batch, "remove x"));
+	}
+	
+	inline void test_group(){
+		const std::chrono::year_month_day current_date = _test_ymd(2025, 1, 1);
+		std::vector<TaskGroup> taskgroups{
+			{"", {Task(_test_ymd(2025, 1, 2), "single")}},
+			{"a", {Task(_test_ymd(2025, 1, 3), "x"), Task(_test_ymd(2025, 1, 4), "y")}},
+			{"b", {Task(_test_ymd(2025, 1, 5), "x"), Task(_test_ymd(2025, 1, 6), "z")}}
+		};
+		task_batch::Batch batch(std::move(taskgroups), current_date);
+		std::string output;
+		
+		//the single task is moved to the group, and is removed from the list as its own group is left without tasks.
+		_test_run(batch, "group a single", output);
+		assert(batch.taskgroups().size() == 2);
+		assert(batch.taskgroups()[0].group_name == "a" && batch.taskgroups()[0].tasks.back().name() == "single");
+		
+		//the first task of the name, or the one in the group of --from.
+		_test_run(batch, "group --from b c x", output);
+		assert(batch.taskgroups()[1].tasks.size() == 1 && batch.taskgroups()[1].tasks.front().name() == "z");
+		assert(batch.taskgroups()[2].group_name == "c" && batch.taskgroups()[2].tasks.front().due_date() == _test_ymd(2025, 1, 5));
+		
+		//the group names are indexed again once a group is removed.
+		_test_run(batch, "group c z", output);
+		assert(batch.taskgroups().size() == 2);
+		_test_run(batch, "group --from c a z", output);
+		assert(batch.taskgroups()[0].tasks.back().name() == "z");
+		
+		assert(_test_run_throws(batch, "group a missing"));
+		assert(_test_run_throws(batch, "group --from missing a x"));
+		assert(_test_run_throws(batch, "group \"\" x"));
+	}
+	
+	///The groups left without tasks are only erased once the groups are read, so the indices of the task and group names are kept up to date between the moves.
+	inline void test_group__without_reading_the_groups(){
+		task_batch::Batch batch({
+			{"d", {Task(_test_ymd(2025, 1, 2), "p")}},
+			{"", {Task(_test_ymd(2025, 1, 3), "q")}},
+			{"d", {Task(_test_ymd(2025, 1, 4), "r"), Task(_test_ymd(2025, 1, 5), "q")}},
+			{"e", {Task(_test_ymd(2025, 1, 6), "s")}}
+		}, _test_ymd(2025, 1, 1));
+		const auto names = [](const std::vector<TaskGroup>& taskgroups){
+			std::string names;
+			for(const TaskGroup& taskgroup : taskgroups){
+				names += taskgroup.group_name + ':';
+				for(const Task& task : taskgroup.tasks) names += task.name();
+				names += ' ';
+			}
+			return names;
+		};
+		std::string output;
+		
+		//the second group named d is the first one once the first one is left without tasks.
+		_test_run(batch, "group e p", output);
+		_test_run(batch, "add --group d 2025/1/9 t", output);
+		_test_run(batch, "group e q", output);
+		_test_run(batch, "group --from d f q", output);
+		_test_run(batch, "group d s", output);
+		_test_run(batch, "group e r", output);
+		_test_run(batch, "list --group d", output);
+		assert(output == "2025/1/6\td\ts\n2025/1/9\td\tt\n");
+		_test_run(batch, "group --from d e t", output);
+		_test_run(batch, "group --from d e s", output);
+		_test_run(batch, "group d q", output);
+		assert(names(batch.taskgroups()) == "e:prts f:q d:q ");
+		
+		//the names are indexed again once the groups are read.
+		assert(_test_run_throws(batch, "group --from f e p"));
+		_test_run(batch, "group --from f e q", output);
+		_test_run(batch, "group f q", output);
+		assert(names(batch.taskgroups()) == "e:prts d:q f:q ");
+	}
+	
+	inline void test_import(){
+		task_batch::Batch batch({{"group", {Task(_test_ymd(2025, 1, 1), "existing"), Task(_test_ymd(2025, 1, 2), "other")}}}, _test_ymd(2025, 1, 1));
+		std::string output;
+		_test_run(batch, "import ./tests/grouping_test.txt", output);
+		
+		const std::vector<TaskGroup> imported = test_task_io_internal::_test_parse_in_stages(std::string(MappedFile("./tests/grouping_test.txt").view()), 
+																							test_task_io_internal::_test_nested_group_callback);
+		assert(batch.taskgroups().size() == imported.size() + 1);
+		assert(std::equal(imported.begin(), imported.end(), batch.taskgroups().begin() + 1));
+		
+		//the group of the name in the task file before importing is still the one added to.
+		_test_run(batch, "add --group group 2025/3/3 added", output);
+		assert(batch.taskgroups().front().tasks.back().name() == "added");
+		
+		try{
+			_test_run(batch, "import ./tests/non_existent_file.txt", output);
+		}catch(const std::runtime_error& cant_open_file){
+			return;
+		}
+		const bool non_existent_file_throws = true;
+		assert(!non_existent_file_throws);
+	}
+	
+	inline void test_export(){
+		task_batch::Batch batch({{"group", {Task(_test_ymd(2025, 1, 1), "x"), Task(_test_ymd(2025, 1, 2), "y, z")}}}, _test_ymd(2025, 1, 1));
+		std::string output;
+		_test_run(batch, "export --format csv -", output);
+		assert(output == "group_id,group,due_date,name\n0,group,2025/1/1,x\n0,group,2025/1/2,\"y, z\"\n");
+		
+		output.clear();
+		_test_run(batch, "export -", output);
+		assert(output == taskgroups_to_str(batch.taskgroups()));
+		assert(!batch.modified());
+		
+		assert(_test_run_throws(batch, "export --format xml -"));
+	}
+}
+
+inline void test_suite_task_batch(){
+	test_task_batch_internal::test_split_arguments();
+	test_task_batch_internal::test_add_and_list();
+	test_task_batch_internal::test_group();
+	test_task_batch_internal::test_group__without_reading_the_groups();
+	test_task_batch_internal::test_import();
+	test_task_batch_internal::test_export();
+}
+
+#endif
@@ -0,0 +1,91 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef test_task_diff_hpp
+#define test_task_diff_hpp
+
+#include "task_diff.hpp"
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cassert>
+
+namespace test_task_diff_internal{
+	inline TaskGroup _test_taskgroup(const std::string& name){
+		const std::chrono::year_month_day due_date(std::chrono::year(2025), std::chrono::month(1), std::chrono::day(1));
+		return {name, {Task(due_date, name + " task")}};
+	}
+	
+	inline std::vector<TaskGroup> _test_taskgroups(const std::vector<std::string>& names){
+		std::vector<TaskGroup> taskgroups;
+		for(const std::string& name : names)
+			taskgroups.push_back(_test_taskgroup(name));
+		return taskgroups;
+	}
+	
+	///Applies the changes as BarGroup applies them to its bars.
+	inline std::vector<TaskGroup> _test_apply(std::vector<TaskGroup> old_taskgroups, const std::vector<TaskGroup>& new_taskgroups, 
+											const std::vector<task_diff::Change>& changes)
+	{
+		for(const task_diff::Change& change : changes){
+			switch(change.type){
+				case task_diff::Change::Type::Update:
+				old_taskgroups[change.index] = new_taskgroups[change.new_index];
+				break;
+				
+				case task_diff::Change::Type::Insert:
+				old_taskgroups.insert(old_taskgroups.begin() + change.index, new_taskgroups[change.new_index]);
+				break;
+				
+				case task_diff::Change::Type::Remove:
+				old_taskgroups.erase(old_taskgroups.begin() + change.index);
+				break;
+			}
+		}
+		return old_taskgroups;
+	}
+	
+	inline void test_diff(){
+		const std::vector<std::vector<std::string>> lists = {
+			{}, {"a"}, {"b"}, {"a", "b", "c"}, {"a", "x", "c"}, {"a", "c"}, {"a", "b", "x", "c"}, {"c", "b", "a"}, {"a", "a", "a"}, {"a", "a"},
+		};
+		
+		for(const std::vector<std::string>& old_names : lists){
+			for(const std::vector<std::string>& new_names : lists){
+				const std::vector<TaskGroup> old_taskgroups = _test_taskgroups(old_names);
+				const std::vector<TaskGroup> new_taskgroups = _test_taskgroups(new_names);
+				
+				const std::vector<task_diff::Change> changes = task_diff::diff(old_taskgroups, new_taskgroups);
+				assert(_test_apply(old_taskgroups, new_taskgroups, changes) == new_taskgroups);
+				if(old_taskgroups == new_taskgroups) assert(changes.empty());
+			}
+		}
+		
+		//a group edited, inserted or removed in the middle changes only that group.
+		using Type = task_diff::Change::Type;
+		const std::vector<task_diff::Change> update = task_diff::diff(_test_taskgroups({"a", "b", "c"}), _test_taskgroups({"a", "x", "c"}));
+		assert(update.size() == 1 && update[0].type == Type::Update && update[0].index == 1);
+		
+		const std::vector<task_diff::Change> insert = task_diff::diff(_test_taskgroups({"a", "b", "c"}), _test_taskgroups({"a", "b", "x", "c"}));
+		assert(insert.size() == 1 && insert[0].type == Type::Insert && insert[0].index == 2 && insert[0].new_index == 2);
+		
+		const std::vector<task_diff::Change> remove = task_diff::diff(_test_taskgroups({"a", "b", "c"}), _test_taskgroups({"a", "c"}));
+		assert(remove.size() == 1 && remove[0].type == Type::Remove && remove[0].index == 1);
+	}
+}
+
+inline void test_suite_task_diff(){
+	test_task_diff_internal::test_diff();
+}
+
+#endif
@@ -0,0 +1,181 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef test_task_exchange_hpp
+#define test_task_exchange_hpp
+
+#include "task_exchange.hpp"
+#include "task_io.hpp"
+#include "mapped_file.hpp"
+#include "parse_diagnostics.hpp"
+#include "test_task_io.hpp"
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cassert>
+#include <cstddef>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+#include <functional>
+
+namespace test_task_exchange_internal{
+	using task_exchange::Format;
+	
+	inline std::chrono::year_month_day _test_ymd(const int y, const unsigned m, const unsigned d){
+		return std::chrono::year_month_day(std::chrono::year(y), std::chrono::month(m), std::chrono::day(d));
+	}
+	
+	///Reads the characters with a Reader fed chunks of chunk_size.
+	inline std::vector<TaskGroup> _test_read_in_chunks(const std::string& buffer, const Format format, const std::size_t chunk_size, 
+														parse_diagnostics::Collector* const diagnostics = nullptr)
+	{
+		std::vector<TaskGroup> taskgroups;
+		task_exchange::Reader reader(format, [&](TaskGroup&& taskgroup){taskgroups.push_back(std::move(taskgroup));}, diagnostics);
+		for(std::size_t i = 0; i < buffer.size(); i += chunk_size)
+			reader.feed(buffer.data() + i, std::min(chunk_size, buffer.size() - i));
+		reader.finish();
+		return taskgroups;
+	}
+	
+	///Returns true if reading the characters throws std::invalid_argument.
+	inline bool _test_read_throws(const std::string& buffer, const Format format){
+		try{
+			_test_read_in_chunks(buffer, format, buffer.size() + 1);
+		}catch(const std::invalid_argument& invalid_record){
+			return true;
+		}
+		return false;
+	}
+	
+	inline void test_round_trip(){
+		const std::vector<TaskGroup> taskgroups = test_task_io_internal::_test_parse_in_stages(std::string(MappedFile("./tests/grouping_test.txt").view()), 
+																								test_task_io_internal::_test_nested_group_callback);
+		
+		for(const Format format : {Format::Csv, Format::JsonLines}){
+			std::ostringstream written;
+			task_exchange::write(written, format, taskgroups);
+			const std::string buffer = written.str();
+			
+			//every chunk size, which splits the records at every possible position.
+			for(std::size_t chunk_size = 1; chunk_size <= buffer.size() + 1; ++chunk_size)
+				assert(_test_read_in_chunks(buffer, format, chunk_size) == taskgroups);
+			
+			std::istringstream stream(buffer);
+			assert(task_exchange::read(stream, format) == taskgroups);
+		}
+		
+		//a group of a single task keeps its name, and groups of the same name stay apart.
+		const std::vector<TaskGroup> same_names{
+			{"a", {Task(_test_ymd(2025, 1, 1), "x")}}, 
+			{"a", {Task(_test_ymd(2025, 1, 2), "y")}}, 
+			{"", {Task(_test_ymd(2025, 1, 3), "z")}}
+		};
+		for(const Format format : {Format::Csv, Format::JsonLines}){
+			std::stringstream stream;
+			task_exchange::write(stream, format, same_names);
+			assert(task_exchange::read(stream, format) == same_names);
+		}
+	}
+	
+	inline void test_csv(){
+		//quoted fields with delimiters and quotes are written and read back.
+		const std::vector<TaskGroup> quoted{{"a, \"b\"", {Task(_test_ymd(2025, 1, 1), "x,y"), Task(_test_ymd(2025, 1, 2), "\"quoted\"")}}};
+		std::ostringstream written;
+		task_exchange::write(written, Format::Csv, quoted);
+		assert(written.str() == "group_id,group,due_date,name\n0,\"a, \"\"b\"\"\",2025/1/1,\"x,y\"\n0,\"a, \"\"b\"\"\",2025/1/2,\"\"\"quoted\"\"\"\n");
+		for(std::size_t chunk_size = 1; chunk_size <= written.str().size(); ++chunk_size)
+			assert(_test_read_in_chunks(written.str(), Format::Csv, chunk_size) == quoted);
+		
+		//the columns in any order with others ignored, a byte order mark, CRLF, yyyy-mm-dd, blank lines and a quoted newline, 
+		//grouped by consecutive group names without group_id.
+		const std::string spreadsheet = "\xef\xbb\xbfname,notes,due_date,group\r\ndishes,,2025-01-03,chores\r\nlaundry,\"two\r\nlines\",2025/1/4,chores\r\n\r\n"
+										"groceries,,2025-01-05,\r\nmop,,2025-01-06,chores\r\n";
+		const std::vector<TaskGroup> expected{
+			{"chores", {Task(_test_ymd(2025, 1, 3), "dishes"), Task(_test_ymd(2025, 1, 4), "laundry")}},
+			{"", {Task(_test_ymd(2025, 1, 5), "groceries")}},
+			{"chores", {Task(_test_ymd(2025, 1, 6), "mop")}}
+		};
+		for(std::size_t chunk_size = 1; chunk_size <= spreadsheet.size(); ++chunk_size)
+			assert(_test_read_in_chunks(spreadsheet, Format::Csv, chunk_size) == expected);
+		
+		assert(_test_read_throws("group,name\nchores,dishes\n", Format::Csv));
+		assert(_test_read_throws("due_date,name\n2025/1/1,\"unclosed\n", Format::Csv));
+		assert(_test_read_throws("due_date,name\n2025/1/1,\"quoted\"after\n", Format::Csv));
+		assert(_test_read_throws("due_date,name\n2025/1/1\n", Format::Csv));
+		assert(_test_read_throws("due_date,name\n2025/1/1,group{\n", Format::Csv));
+		assert(_test_read_throws("due_date,name\n2025/1/1,\"two\nlines\"\n", Format::Csv));
+	}
+	
+	inline void test_json_lines(){
+		//the escapes of JSON, unknown members, null and a string group_id.
+		const std::string json_lines = "{\"group\": \"caf\\u00e9\", \"group_id\": \"g\", \"due_date\": \"2025-01-03\", \"name\": \"a \\\"b\\\" \\\\ \\ud83d\\ude00\"}\n"
+										"{ \"done\": false, \"group_id\":\"g\", \"name\":\"c\\/d\", \"due_date\":\"2025/1/4\", \"tags\": null }\n"
+										"\n"
+										"{\"group_id\":null,\"due_date\":\"2025/1/5\",\"name\":\"e\"}";
+		const std::vector<TaskGroup> expected{
+			{"caf\xc3\xa9", {Task(_test_ymd(2025, 1, 3), "a \"b\" \\ \xf0\x9f\x98\x80"), Task(_test_ymd(2025, 1, 4), "c/d")}},
+			{"", {Task(_test_ymd(2025, 1, 5), "e")}}
+		};
+		for(std::size_t chunk_size = 1; chunk_size <= json_lines.size(); ++chunk_size)
+			assert(_test_read_in_chunks(json_lines, Format::JsonLines, chunk_size) == expected);
+		
+		//control characters are escaped, so every record stays on its line.
+		std::ostringstream written;
+		task_exchange::write(written, Format::JsonLines, {{"\t\x01", {Task(_test_ymd(2025, 1, 1), "x")}}});
+		assert(written.str() == "{\"group_id\":0,\"group\":\"\\t\\u0001\",\"due_date\":\"2025/1/1\",\"name\":\"x\"}\n");
+		
+		assert(_test_read_throws("{\"due_date\":\"2025/1/1\"}", Format::JsonLines));
+		assert(_test_read_throws("[\"2025/1/1\", \"x\"]", Format::JsonLines));
+		assert(_test_read_throws("{\"due_date\":\"2025/1/1\",\"name\":\"x\",\"tags\":[]}", Format::JsonLines));
+		assert(_test_read_throws("{\"due_date\":\"2025/1/1\",\"name\":\"x\"", Format::JsonLines));
+		assert(_test_read_throws("{\"due_date\":\"2025/1/1\",\"name\":\"\\ud83d\"}", Format::JsonLines));
+		assert(_test_read_throws("{\"due_date\":\"2025/1/1\",\"name\":\"x\"} trailing", Format::JsonLines));
+	}
+	
+	inline void test_invalid_due_dates(){
+		//the tasks are skipped and recorded with their line and offset, the rest of the group is kept.
+		const std::string csv = "due_date,name,group\n2025/1/1,a,g\n2025/13/1,bad,g\n2025/1/2,b,g\n";
+		parse_diagnostics::Collector collector;
+		const std::vector<TaskGroup> taskgroups = _test_read_in_chunks(csv, Format::Csv, 5, &collector);
+		assert((taskgroups == std::vector<TaskGroup>{{"g", {Task(_test_ymd(2025, 1, 1), "a"), Task(_test_ymd(2025, 1, 2), "b")}}}));
+		
+		assert(collector.count(parse_diagnostics::Kind::InvalidDueDate) == 1);
+		const parse_diagnostics::Diagnostic& diagnostic = collector.diagnostics().front();
+		assert(diagnostic.line_number == 3);
+		assert(diagnostic.byte_offset == csv.find("2025/13/1"));
+		assert(diagnostic.text == "2025/13/1,bad,g");
+	}
+	
+	inline void test_formats(){
+		assert(task_exchange::format_from_name("csv") == Format::Csv);
+		assert(task_exchange::format_from_name("jsonl") == Format::JsonLines);
+		assert(task_exchange::format_from_name("tasks") == Format::TaskFile);
+		assert(!task_exchange::format_from_name("xml"));
+		
+		assert(task_exchange::format_of_filename("out/tasks.csv") == Format::Csv);
+		assert(task_exchange::format_of_filename("tasks.ndjson") == Format::JsonLines);
+		assert(task_exchange::format_of_filename("tasks.txt") == Format::TaskFile);
+	}
+}
+
+inline void test_suite_task_exchange(){
+	test_task_exchange_internal::test_formats();
+	test_task_exchange_internal::test_round_trip();
+	test_task_exchange_internal::test_csv();
+	test_task_exchange_internal::test_json_lines();
+	test_task_exchange_internal::test_invalid_due_dates();
+}
+
+#endif
@@ -0,0 +1,123 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef test_task_index_hpp
+#define test_task_index_hpp
+
+#include "task_index.hpp"
+#include "task_journal.hpp"
+#include "task_io.hpp"
+#include "parse_diagnostics.hpp"
+#include "test_task_io.hpp"
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cassert>
+#include <stdexcept>
+
+namespace test_task_index_internal{
+	inline std::vector<TaskGroup> _test_parse(const std::string& task_file){
+		TaskFileParser parser(test_task_io_internal::_test_nested_group_callback);
+		parser.feed(task_file.data(), task_file.size());
+		return parser.finish();
+	}
+	
+	inline void test_build(){
+		for(const std::string& task_file : test_task_io_internal::_test_task_files()){
+			const std::vector<TaskGroup> expected_result = _test_parse(task_file);
+			const std::vector<task_index::Span> spans = task_index::build(task_file);
+			assert(spans.size() == expected_result.size());
+			
+			//every span parses by itself to its group, including the ones with the name lent by a group without tasks.
+			for(std::size_t i = 0; i < spans.size(); ++i)
+				assert(task_index::load(task_file, spans[i], test_task_io_internal::_test_nested_group_callback) == expected_result[i]);
+		}
+		
+		//a task line without the comma after its due date throws, as in TaskFileParser.
+		try{
+			task_index::build("2025/01/01\n");
+		}catch(const std::out_of_range& no_comma){
+			return;
+		}
+		
+		const bool task_without_comma_throws = true;
+		assert(!task_without_comma_throws);
+	}
+	
+	inline void test_nearest_due_date(){
+		using namespace std::chrono;
+		const std::string task_file = "g{\n2025/3/4, a\n2025/3/2, b\n2025/13/1, invalid\n}\n2025/1/1, c\nh{\n2025/99/1, invalid\n}\n";
+		const std::vector<task_index::Span> spans = task_index::build(task_file);
+		assert(spans.size() == 3);
+		
+		const sys_days march_2nd = sys_days(year_month_day(year(2025), month(3), day(2)));
+		assert(spans[0].nearest_due_date == march_2nd.time_since_epoch().count());
+		assert(task_index::due_by(spans[0], march_2nd));
+		assert(!task_index::due_by(spans[0], march_2nd - days(1)));
+		assert(!task_index::due_by(spans[1], sys_days(year_month_day(year(2024), month(12), day(31)))));
+		
+		//a group without a valid due date is always due.
+		assert(spans[2].nearest_due_date == task_index::no_due_date);
+		assert(task_index::due_by(spans[2], sys_days(year_month_day(year(1970), month(1), day(1)))));
+	}
+	
+	///Replaying the operations over the index gives the same groups as replaying them over the parsed task file.
+	inline void test_apply(){
+		using task_journal::Operation;
+		const std::string task_file = "a{\n}\n2025/01/01, x\ng{\n2025/1/2, y\n2025/1/1, z\n}\n2025/2/2, w\n";
+		const std::vector<Operation> operations = {
+			Operation::rename(1, "renamed"),
+			Operation::modify(0, {"", {}}),
+			Operation::add({"added", {Task(std::chrono::year_month_day(std::chrono::year(2026), std::chrono::month(1), std::chrono::day(1)), "v")}}),
+			Operation::erase(3),
+		};
+		
+		std::vector<TaskGroup> expected_result = _test_parse(task_file);
+		for(const Operation& operation : operations)
+			assert(task_journal::apply(expected_result, operation));
+		expected_result = task_journal::as_loaded_from_task_file(std::move(expected_result));
+		
+		task_index::LazyTaskFile lazy_task_file = task_index::index(std::string(task_file));
+		for(const Operation& operation : operations)
+			assert(task_index::apply(lazy_task_file, operation, test_task_io_internal::_test_nested_group_callback));
+		task_index::as_loaded_from_task_file(lazy_task_file, test_task_io_internal::_test_nested_group_callback);
+		
+		assert(task_index::to_taskgroups(lazy_task_file, test_task_io_internal::_test_nested_group_callback) == expected_result);
+		//only the renamed group and the one lent the name of the emptied group are loaded.
+		assert(!lazy_task_file.taskgroups.back().taskgroup);
+		
+		assert(!task_index::apply(lazy_task_file, Operation::erase(lazy_task_file.taskgroups.size()), test_task_io_internal::_test_nested_group_callback));
+		
+		//a group of only invalid due dates has no valid due date, so it is loaded to be dropped. The groups after the one lent its name stay unloaded.
+		const std::string invalid_task_file = "bad{\n2024/13/40, x\n}\n2030/01/01, a\n2030/01/02, b\n";
+		parse_diagnostics::Collector diagnostics;
+		TaskFileParser parser(test_task_io_internal::_test_nested_group_callback, &diagnostics);
+		parser.feed(invalid_task_file.data(), invalid_task_file.size());
+		const std::vector<TaskGroup> invalid_taskgroups = task_journal::as_loaded_from_task_file(parser.finish());
+		
+		task_index::LazyTaskFile invalid_lazy_task_file = task_index::index(std::string(invalid_task_file));
+		task_index::as_loaded_from_task_file(invalid_lazy_task_file, test_task_io_internal::_test_nested_group_callback, &diagnostics);
+		assert(task_index::to_taskgroups(invalid_lazy_task_file, test_task_io_internal::_test_nested_group_callback) == invalid_taskgroups);
+		//the invalid due date is recorded by the parser, then again once the group is loaded from its span.
+		assert(invalid_taskgroups.size() == 2 && diagnostics.count() == 2);
+		assert(!invalid_lazy_task_file.taskgroups.back().taskgroup);
+	}
+}
+
+inline void test_suite_task_index(){
+	test_task_index_internal::test_build();
+	test_task_index_internal::test_nearest_due_date();
+	test_task_index_internal::test_apply();
+}
+
+#endif
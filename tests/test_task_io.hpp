@@ -14,11 +14,19 @@ You should have received a copy of the GNU General Public License along with Wor
 #define test_task_io_hpp
 
 #include "task_io.hpp"
+#include "mapped_file.hpp"
 
 #include <vector>
+#include <string>
+#include <chrono>
 #include <cassert>
+#include <stdexcept>
+#include <algorithm>
 #include <cstring>
+#include <fstream>
+#include <utility>
 #include <iostream>
+#include <filesystem>
 
 namespace test_task_io_internal{
 	static int _test_nested_group_warning_count = 0;
@@ -64,6 +72,50 @@ namespace test_task_io_internal{
 		assert(lines == expected_result);
 	}
 	
+	inline void test_MappedFile(){
+		constexpr const char* const expected_result = "abcdefg\nhijk";
+		
+		const MappedFile mapped_file("./tests/get_raw_file_test.txt");
+		assert(mapped_file.view() == expected_result);
+		assert(!mapped_file.is_mapped());
+		
+		//only a file of at least min_mapped_size is mapped, the same contents are viewed either way.
+		const std::string large_filename = (std::filesystem::temp_directory_path() / "worktable_test_mapped_file.txt").string();
+		const std::string large_file(min_mapped_size, 'x');
+		std::ofstream(large_filename, std::ios::binary) << large_file;
+		MappedFile large_mapped_file(large_filename);
+		assert(large_mapped_file.is_mapped() && large_mapped_file.view() == large_file);
+		
+		MappedFile moved_mapped_file(std::move(large_mapped_file));
+		assert(!large_mapped_file.is_mapped() && moved_mapped_file.view() == large_file);
+		moved_mapped_file = MappedFile("./tests/get_raw_file_test.txt");
+		assert(moved_mapped_file.view() == expected_result);
+		std::filesystem::remove(large_filename);
+		
+		try{
+			const MappedFile non_existent_file("ejoijedijdoij.mpeg");
+		}catch(const std::runtime_error& cant_open_file){
+			return;
+		}
+		
+		const bool cant_open_file = true;
+		assert(!cant_open_file);
+	}
+	
+	inline void test_buffer_to_line_views(){
+		constexpr std::string_view buffer_input = "h\n\n\n\ni, im ok!\n\nyep\n";
+		const std::vector<std::string_view> expected_result = {
+			"h",
+			"i, im ok!",
+			"yep"
+		};
+		
+		const std::vector<std::string_view> lines = task_io_internal::buffer_to_line_views(buffer_input);
+		assert(lines == expected_result);
+		//the lines should view the buffer, not a copy of it.
+		assert(lines[2].data() == buffer_input.data() + buffer_input.find("yep"));
+	}
+	
 	inline void test_lines_to_TaskStrGroup(){
 		const std::vector<task_io_internal::TaskStrGroup> expected_result{
 			{"", {{"2025/05/03", "cookies"}}},
@@ -94,6 +146,178 @@ namespace test_task_io_internal{
 		
 		assert(taskgroups == expected_result);
 	}
+	
+	///Parses the buffer with the functions of task_io_internal, one stage after another.
+	inline std::vector<TaskGroup> _test_parse_in_stages(const std::string& buffer, 
+										void(*nested_group_callback)(const char*, const int, const std::string&, const std::string&))
+	{
+		std::unique_ptr<char[]> unique_ptr_buffer(new char[buffer.size()]);
+		std::copy(buffer.begin(), buffer.end(), unique_ptr_buffer.get());
+		
+		const std::vector<std::string> lines = task_io_internal::buffer_to_separated_lines({std::move(unique_ptr_buffer), buffer.size()});
+		const std::vector<task_io_internal::TaskStrGroup> taskstr_groups = task_io_internal::lines_to_TaskStrGroup(lines, nested_group_callback);
+		return task_io_internal::TaskStrGroups_to_TaskGroups(taskstr_groups);
+	}
+	
+	///Task files which cover the quirks of lines_to_TaskStrGroup(), for the tests comparing the parsers against it.
+	inline std::vector<std::string> _test_task_files(){
+		return {
+			std::string(MappedFile("./tests/grouping_test.txt").view()),
+			std::string(MappedFile("./tests/nested_grouping_test.txt").view()),
+			//an empty group lends its name to the next single task, and an unclosed group is saved at the last line.
+			"a{\n}\n2025/01/01, x\ng{\n2025/1/2, y\n2025/1/1, z",
+			//an unclosed group with a nested group definition as the last line is not saved.
+			"g{\n2025/1/2, y\nh{\n",
+			"\n\n2025/12/01, stray scope end\n}\n\n",
+			"",
+		};
+	}
+	
+	inline void test_TaskFileParser(){
+		const std::vector<std::string> task_files = _test_task_files();
+		
+		for(const std::string& task_file : task_files){
+			const std::vector<TaskGroup> expected_result = _test_parse_in_stages(task_file, _test_nested_group_callback);
+			
+			//every chunk size, which splits lines at every possible position.
+			for(std::size_t chunk_size = 1; chunk_size <= task_file.size() + 1; ++chunk_size){
+				TaskFileParser parser(_test_nested_group_callback);
+				for(std::size_t i = 0; i < task_file.size(); i += chunk_size)
+					parser.feed(task_file.data() + i, std::min(chunk_size, task_file.size() - i));
+				
+				assert(parser.finish() == expected_result);
+			}
+		}
+		
+		//a task line without the comma after its due date throws, as in lines_to_TaskStrGroup().
+		TaskFileParser parser(_test_nested_group_callback);
+		try{
+			parser.feed("2025/01/01\n", 11);
+		}catch(const std::out_of_range& no_comma){
+			return;
+		}
+		
+		const bool task_without_comma_throws = true;
+		assert(!task_without_comma_throws);
+	}
+	
+	static std::vector<std::string> _test_nested_group_names;
+	
+	inline void _test_recording_nested_group_callback(const char* const callsite_filename, const int callsite_line, 
+													const std::string& first_taskgroup_name, const std::string& second_taskgroup_name)
+	{_test_nested_group_names.push_back(first_taskgroup_name + '/' + second_taskgroup_name);}
+	
+	inline void test_split_at_lines(){
+		const std::string_view buffer = "2025/1/1, a\n\nb{\n2025/1/2, c\n}\nlast line without newline";
+		
+		for(std::size_t chunk_count = 1; chunk_count <= buffer.size() + 1; ++chunk_count){
+			const std::vector<std::string_view> chunks = task_io_internal::split_at_lines(buffer, chunk_count);
+			assert(chunks.size() <= chunk_count);
+			
+			//the chunks are consecutive, and each ends at the end of a line.
+			std::string joined_chunks;
+			for(const std::string_view chunk : chunks){
+				assert(!chunk.empty());
+				assert(chunk.back() == '\n' || chunk.data() + chunk.size() == buffer.data() + buffer.size());
+				joined_chunks += chunk;
+			}
+			assert(joined_chunks == buffer);
+		}
+		
+		assert(task_io_internal::split_at_lines("", 4).empty());
+	}
+	
+	inline void test_parse_tasks_parallel(){
+		for(const std::string& task_file : _test_task_files()){
+			_test_nested_group_names.clear();
+			TaskFileParser parser(_test_recording_nested_group_callback);
+			parser.feed(task_file.data(), task_file.size());
+			const std::vector<TaskGroup> expected_result = parser.finish();
+			const std::vector<std::string> expected_nested_group_names = _test_nested_group_names;
+			
+			//every chunk count, down to a chunk for each line, which puts a chunk boundary between every pair of lines of a group.
+			const std::size_t line_count = std::count(task_file.begin(), task_file.end(), '\n') + 1;
+			for(std::size_t chunk_count = 1; chunk_count <= line_count; ++chunk_count){
+				const std::vector<std::string_view> chunks = task_io_internal::split_at_lines(task_file, chunk_count);
+				
+				for(const unsigned thread_count : {1u, 2u, 3u, 8u}){
+					_test_nested_group_names.clear();
+					assert(task_io_internal::parse_chunks_parallel(chunks, thread_count, _test_recording_nested_group_callback) == expected_result);
+					assert(_test_nested_group_names == expected_nested_group_names);
+				}
+			}
+			
+			_test_nested_group_names.clear();
+			assert(parse_tasks_parallel(task_file, 4, _test_recording_nested_group_callback) == expected_result);
+			assert(_test_nested_group_names == expected_nested_group_names);
+		}
+		
+		//a task line without the comma after its due date throws in a later chunk, after the chunks before it are fetched.
+		const std::vector<std::string_view> chunks = {"g{\n2025/1/1, a\n", "}\ng{\nh{\n", "2025/01/01\n2025/1/2, b\n"};
+		_test_nested_group_names.clear();
+		try{
+			task_io_internal::parse_chunks_parallel(chunks, 2, _test_recording_nested_group_callback);
+		}catch(const std::out_of_range& no_comma){
+			assert(_test_nested_group_names == std::vector<std::string>{"g/h"});
+			return;
+		}
+		
+		const bool task_without_comma_throws = true;
+		assert(!task_without_comma_throws);
+	}
+	
+	inline void test_parse_ymd(){
+		using namespace std::chrono;
+		
+		assert(parse_ymd("2025/05/07").ymd == year_month_day(year(2025), month(5), day(7)));
+		assert(parse_ymd("2025/5/07").ymd == year_month_day(year(2025), month(5), day(7)));
+		assert(parse_ymd("2025/12/7").ymd == year_month_day(year(2025), month(12), day(7)));
+		assert(parse_ymd("2024/2/29").ok());
+		
+		assert(parse_ymd("2025/1/").status == YmdParseStatus::TooShort);
+		assert(parse_ymd("20a5/1/10").status == YmdParseStatus::NonNumericYmd);
+		assert(parse_ymd("2025/a/10").status == YmdParseStatus::NonNumericYmd);
+		assert(parse_ymd("2025//100").status == YmdParseStatus::MonthNotProvided);
+		assert(parse_ymd("2025/1/1a").status == YmdParseStatus::NonNumericDay);
+		assert(parse_ymd("2025/123").status == YmdParseStatus::DayNotProvided);
+		assert(parse_ymd("2025/13/10").status == YmdParseStatus::InvalidYmd);
+		assert(parse_ymd("2023/2/29").status == YmdParseStatus::InvalidYmd);
+		//a day which wraps around in std::chrono::day's 8 bits is still invalid.
+		assert(parse_ymd("2025/1/257").status == YmdParseStatus::InvalidYmd);
+		assert(parse_ymd("2025/1/99999999999999999999").status == YmdParseStatus::InvalidYmd);
+		
+		try{
+			str_to_ymd("2025/13/10");
+		}catch(const std::invalid_argument& invalid_ymd){
+			assert(std::string(invalid_ymd.what()) == ymd_parse_status_message(YmdParseStatus::InvalidYmd));
+			return;
+		}
+		
+		const bool invalid_ymd_throws = true;
+		assert(!invalid_ymd_throws);
+	}
+	
+	inline void test_taskgroups_to_str(){
+		using namespace std::chrono;
+		
+		assert(int_to_2char(0) == "00");
+		assert(int_to_2char(7) == "07");
+		assert(int_to_2char(31) == "31");
+		assert(int_to_2char(255) == "255");
+		assert(int_to_2char(4294967295u) == "4294967295");
+		
+		assert(task_to_str(Task(year_month_day(year(2025), month(5), day(7)), "cookies")) == "2025/05/07, cookies");
+		assert(task_to_str(Task(year_month_day(year(-44), month(3), day(15)), "")) == "-44/03/15, ");
+		assert(task_to_str(Task(year_month_day(year(12345), month(12), day(31)), "far")) == "12345/12/31, far");
+		
+		const std::vector<TaskGroup> taskgroups = {
+			{"single task group", {Task(year_month_day(year(2025), month(1), day(1)), "waffles")}},
+			{"group", {Task(year_month_day(year(2025), month(11), day(3)), "tea"), Task(year_month_day(year(2024), month(2), day(29)), "coffee")}},
+			{"empty group", {}},
+		};
+		assert(taskgroups_to_str(taskgroups) == "2025/01/01, waffles\ngroup{\n2025/11/03, tea\n2024/02/29, coffee\n}\nempty group{\n}\n");
+		assert(taskgroups_to_str({}).empty());
+	}
 }
 
 
@@ -101,9 +325,16 @@ inline void test_suite_task_io(){
 	test_task_io_internal::test_get_raw_file__non_existent_file();
 	test_task_io_internal::test_get_raw_file();
 	test_task_io_internal::test_buffer_to_separated_lines();
+	test_task_io_internal::test_MappedFile();
+	test_task_io_internal::test_buffer_to_line_views();
 	
 	test_task_io_internal::test_lines_to_TaskStrGroup();
 	test_task_io_internal::test_TaskStrGroups_to_TaskGroups();
+	test_task_io_internal::test_TaskFileParser();
+	test_task_io_internal::test_split_at_lines();
+	test_task_io_internal::test_parse_tasks_parallel();
+	test_task_io_internal::test_parse_ymd();
+	test_task_io_internal::test_taskgroups_to_str();
 }
 
 #endif
\ No newline at end of file
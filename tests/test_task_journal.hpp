@@ -0,0 +1,367 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef test_task_journal_hpp
+#define test_task_journal_hpp
+
+#include "task_journal.hpp"
+#include "task_snapshot.hpp"
+#include "task_io.hpp"
+#include "parse_diagnostics.hpp"
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cassert>
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <optional>
+#include <filesystem>
+
+namespace test_task_journal_internal{
+	inline Task _test_task(const int year, const unsigned month, const unsigned day, const std::string& name){
+		return Task(std::chrono::year_month_day(std::chrono::year(year), std::chrono::month(month), std::chrono::day(day)), name);
+	}
+	
+	///The groups as saved by overwrite_taskfile(), already in the form they are loaded as.
+	inline std::vector<TaskGroup> _test_taskgroups(){
+		return {
+			{"group", {_test_task(2025, 5, 3, "cookies"), _test_task(2024, 12, 31, "")}},
+			{"", {_test_task(2025, 1, 1, "waffles")}},
+			{"another group", {_test_task(2025, 6, 7, "tea"), _test_task(2025, 6, 8, "coffee")}},
+		};
+	}
+	
+	///An edit of every type, including a merge of "another group" into "group".
+	inline std::vector<task_journal::Operation> _test_operations(){
+		using task_journal::Operation;
+		return {
+			Operation::add({"new group", {_test_task(2026, 1, 1, "fries"), _test_task(2026, 1, 2, "salad")}}),
+			Operation::rename(0, "renamed group"),
+			Operation::modify(0, {"renamed group", {_test_task(2025, 5, 3, "cookies"), _test_task(2024, 12, 31, ""),
+													_test_task(2025, 6, 7, "tea"), _test_task(2025, 6, 8, "coffee")}}),
+			Operation::erase(2),
+		};
+	}
+	
+	inline std::vector<TaskGroup> _test_taskgroups_after_operations(){
+		return {
+			{"renamed group", {_test_task(2025, 5, 3, "cookies"), _test_task(2024, 12, 31, ""),
+								_test_task(2025, 6, 7, "tea"), _test_task(2025, 6, 8, "coffee")}},
+			{"", {_test_task(2025, 1, 1, "waffles")}},
+			{"new group", {_test_task(2026, 1, 1, "fries"), _test_task(2026, 1, 2, "salad")}},
+		};
+	}
+	
+	inline std::string _read_file(const std::string& filename){
+		std::ifstream file(filename, std::ifstream::binary);
+		return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+	
+	inline void test_encode_and_decode(){
+		const std::vector<task_journal::Operation> operations = _test_operations();
+		const std::optional<std::vector<task_journal::Operation>> decoded_operations = task_journal::decode(task_journal::encode(operations));
+		assert(decoded_operations.has_value());
+		assert(*decoded_operations == operations);
+		
+		const std::string encoded_operations = task_journal::encode(operations);
+		assert(!task_journal::decode(std::string_view(encoded_operations).substr(0, encoded_operations.size() - 1)).has_value());
+		assert(task_journal::decode("")->empty());
+	}
+	
+	inline void test_apply(){
+		std::vector<TaskGroup> taskgroups = _test_taskgroups();
+		for(const task_journal::Operation& operation : _test_operations())
+			assert(task_journal::apply(taskgroups, operation));
+		assert(taskgroups == _test_taskgroups_after_operations());
+		
+		const std::vector<TaskGroup> taskgroups_before_invalid_operations = taskgroups;
+		assert(!task_journal::apply(taskgroups, task_journal::Operation::erase(3)));
+		assert(!task_journal::apply(taskgroups, task_journal::Operation::modify(3, {"", {_test_task(2025, 1, 1, "a")}})));
+		assert(!task_journal::apply(taskgroups, task_journal::Operation::rename(3, "a")));
+		assert(taskgroups == taskgroups_before_invalid_operations);
+	}
+	
+	inline void test_coalesce(){
+		using task_journal::Operation;
+		const TaskGroup edited_group = {"edited", {_test_task(2025, 1, 1, "a"), _test_task(2025, 1, 2, "b")}};
+		const TaskGroup edited_again_group = {"edited", {_test_task(2025, 1, 1, "a"), _test_task(2025, 1, 3, "c")}};
+		
+		const std::vector<Operation> operations = {
+			Operation::rename(0, "r"), Operation::rename(0, "re"), Operation::rename(0, "renamed"),
+			Operation::modify(1, edited_group), Operation::modify(1, edited_again_group), Operation::rename(1, "edited and renamed"),
+			Operation::modify(2, edited_group), Operation::erase(2),
+			//the index refers to another group after the Delete and the Add.
+			Operation::modify(2, edited_group), Operation::add(edited_group), Operation::modify(3, edited_again_group),
+		};
+		std::vector<Operation> coalesced_operations = task_journal::coalesce(std::vector<Operation>(operations));
+		
+		TaskGroup edited_and_renamed_group = edited_again_group;
+		edited_and_renamed_group.group_name = "edited and renamed";
+		const std::vector<Operation> expected_operations = {
+			Operation::rename(0, "renamed"), Operation::modify(1, edited_and_renamed_group), Operation::erase(2),
+			Operation::modify(2, edited_group), Operation::add(edited_group), Operation::modify(3, edited_again_group),
+		};
+		assert(coalesced_operations == expected_operations);
+		
+		std::vector<TaskGroup> taskgroups = _test_taskgroups();
+		taskgroups.push_back({"fourth group", {_test_task(2025, 2, 1, "d"), _test_task(2025, 2, 2, "e")}});
+		std::vector<TaskGroup> coalesced_taskgroups = taskgroups;
+		for(const Operation& operation : operations) assert(task_journal::apply(taskgroups, operation));
+		for(const Operation& operation : coalesced_operations) assert(task_journal::apply(coalesced_taskgroups, operation));
+		assert(taskgroups == coalesced_taskgroups);
+	}
+	
+	inline void test_as_loaded_from_task_file(){
+		std::vector<TaskGroup> taskgroups = {
+			{"single task group", {_test_task(2025, 1, 1, "waffles")}},
+			{"empty group", {}},
+			{"lent name", {_test_task(2026, 2, 28, "fries")}},
+			{"group", {_test_task(2025, 6, 7, "tea"), _test_task(2025, 6, 8, "coffee")}},
+			{"trailing empty group", {}},
+		};
+		const std::vector<TaskGroup> loaded_taskgroups = {
+			{"", {_test_task(2025, 1, 1, "waffles")}},
+			{"empty group", {_test_task(2026, 2, 28, "fries")}},
+			{"group", {_test_task(2025, 6, 7, "tea"), _test_task(2025, 6, 8, "coffee")}},
+		};
+		assert(task_journal::as_loaded_from_task_file(std::move(taskgroups)) == loaded_taskgroups);
+	}
+	
+	inline void test_append_and_replay(){
+		const std::filesystem::path directory = std::filesystem::temp_directory_path();
+		const std::string task_filename = (directory / "worktable_test_journal_tasks.txt").string();
+		const std::string journal_filename = (directory / "worktable_test_journal_tasks.journal").string();
+		task_journal::remove(journal_filename);
+		
+		std::ofstream(task_filename) << taskgroups_to_str(_test_taskgroups());
+		const task_snapshot::SourceStamp loaded_source = *task_snapshot::get_source_stamp(task_filename);
+		
+		task_journal::ReplayResult replayed = task_journal::replay_file(_test_taskgroups(), journal_filename, task_filename);
+		assert(replayed.status == task_journal::ReplayStatus::NoJournal);
+		assert(replayed.taskgroups == _test_taskgroups());
+		
+		//a save for each operation, so each is its own batch.
+		for(const task_journal::Operation& operation : _test_operations())
+			task_journal::append({operation}, journal_filename, task_filename, loaded_source);
+		
+		replayed = task_journal::replay_file(_test_taskgroups(), journal_filename, task_filename);
+		assert(replayed.status == task_journal::ReplayStatus::Replayed);
+		assert(replayed.taskgroups == _test_taskgroups_after_operations());
+		assert(!task_journal::should_compact(journal_filename, task_filename));
+		
+		const std::string journal = _read_file(journal_filename);
+		
+		//the last batch is cut short, the batches before it are still replayed.
+		std::vector<TaskGroup> taskgroups_before_last_batch = _test_taskgroups();
+		for(std::size_t i = 0; i + 1 < _test_operations().size(); ++i)
+			task_journal::apply(taskgroups_before_last_batch, _test_operations()[i]);
+		
+		replayed = task_journal::replay(_test_taskgroups(), std::string_view(journal).substr(0, journal.size() - 1), task_filename);
+		assert(replayed.status == task_journal::ReplayStatus::IncompleteBatch);
+		assert(replayed.taskgroups == taskgroups_before_last_batch);
+		
+		//a byte of the last batch changed.
+		std::string corrupted_journal = journal;
+		corrupted_journal.back() ^= 0x20;
+		replayed = task_journal::replay(_test_taskgroups(), corrupted_journal, task_filename);
+		assert(replayed.status == task_journal::ReplayStatus::CorruptedBatch);
+		assert(replayed.taskgroups == taskgroups_before_last_batch);
+		
+		//the task file changed outside of WorkTable after the journal was started.
+		std::ofstream(task_filename, std::ofstream::app) << "2025/01/01, added outside of WorkTable\n";
+		replayed = task_journal::replay_file(_test_taskgroups(), journal_filename, task_filename);
+		assert(replayed.status == task_journal::ReplayStatus::StaleJournal);
+		assert(replayed.taskgroups == _test_taskgroups());
+		
+		//appending to a stale journal starts a new one, once the changed task file is loaded.
+		task_journal::append({task_journal::Operation::erase(0)}, journal_filename, task_filename, *task_snapshot::get_source_stamp(task_filename));
+		replayed = task_journal::replay_file(_test_taskgroups(), journal_filename, task_filename);
+		assert(replayed.status == task_journal::ReplayStatus::Replayed);
+		std::vector<TaskGroup> taskgroups_without_first = _test_taskgroups();
+		taskgroups_without_first.erase(taskgroups_without_first.begin());
+		assert(replayed.taskgroups == taskgroups_without_first);
+		
+		task_journal::remove(journal_filename);
+		assert(!std::filesystem::exists(journal_filename));
+		std::filesystem::remove(task_filename);
+	}
+	
+	inline void test_replay__batch_with_invalid_index(){
+		const std::filesystem::path directory = std::filesystem::temp_directory_path();
+		const std::string task_filename = (directory / "worktable_test_journal_tasks.txt").string();
+		const std::string journal_filename = (directory / "worktable_test_journal_tasks.journal").string();
+		task_journal::remove(journal_filename);
+		
+		std::ofstream(task_filename) << taskgroups_to_str(_test_taskgroups());
+		
+		//the batch is rejected entirely, including the valid rename before the invalid index.
+		task_journal::append({task_journal::Operation::rename(0, "renamed group"), task_journal::Operation::erase(3)}, journal_filename, task_filename,
+							*task_snapshot::get_source_stamp(task_filename));
+		const task_journal::ReplayResult replayed = task_journal::replay_file(_test_taskgroups(), journal_filename, task_filename);
+		assert(replayed.status == task_journal::ReplayStatus::CorruptedBatch);
+		assert(replayed.taskgroups == _test_taskgroups());
+		
+		task_journal::remove(journal_filename);
+		std::filesystem::remove(task_filename);
+	}
+	
+	inline void test_append__task_file_changed_between_appends(){
+		const std::filesystem::path directory = std::filesystem::temp_directory_path();
+		const std::string task_filename = (directory / "worktable_test_journal_tasks.txt").string();
+		const std::string journal_filename = (directory / "worktable_test_journal_tasks.journal").string();
+		task_journal::remove(journal_filename);
+		
+		const std::vector<TaskGroup> loaded_taskgroups = {
+			{"", {_test_task(2025, 1, 1, "A")}}, {"", {_test_task(2025, 1, 2, "B")}}, {"", {_test_task(2025, 1, 3, "C")}}
+		};
+		std::ofstream(task_filename) << taskgroups_to_str(loaded_taskgroups);
+		const task_snapshot::SourceStamp loaded_source = *task_snapshot::get_source_stamp(task_filename);
+		
+		//A is deleted and saved, then a group is added in front of the others outside of WorkTable.
+		task_journal::append({task_journal::Operation::erase(0)}, journal_filename, task_filename, loaded_source);
+		std::vector<TaskGroup> changed_taskgroups = loaded_taskgroups;
+		changed_taskgroups.insert(changed_taskgroups.begin(), {"", {_test_task(2025, 1, 4, "X")}});
+		std::ofstream(task_filename) << taskgroups_to_str(changed_taskgroups);
+		const std::string journal = _read_file(journal_filename);
+		
+		//deleting C by its index among B and C would delete A from the changed task file, so the save is refused instead.
+		bool append_refused = false;
+		try{
+			task_journal::append({task_journal::Operation::erase(1)}, journal_filename, task_filename, loaded_source);
+		}catch(const std::ios_base::failure& task_file_changed){
+			append_refused = true;
+		}
+		assert(append_refused);
+		assert(_read_file(journal_filename) == journal);
+		
+		const task_journal::ReplayResult replayed = task_journal::replay_file(std::vector<TaskGroup>(changed_taskgroups), journal_filename, task_filename);
+		assert(replayed.status == task_journal::ReplayStatus::StaleJournal);
+		assert(replayed.taskgroups == changed_taskgroups);
+		
+		task_journal::remove(journal_filename);
+		std::filesystem::remove(task_filename);
+	}
+	
+	inline bool _test_alerted = false;
+	inline void _test_alert(const char* const message){
+		_test_alerted = true;
+	}
+	
+	///Compacts the journal of tasks.txt, and rejects it once tasks.txt is changed outside of WorkTable, in a directory of its own as both use tasks.txt.
+	inline void test_compact_and_reject(){
+		const std::filesystem::path working_directory = std::filesystem::current_path();
+		const std::filesystem::path directory = std::filesystem::temp_directory_path() / "worktable_test_compact";
+		std::filesystem::remove_all(directory);
+		std::filesystem::create_directory(directory);
+		std::filesystem::current_path(directory);
+		task_io_report::set_alert_function(_test_alert);
+		
+		std::ofstream("tasks.txt") << taskgroups_to_str(_test_taskgroups());
+		parse_diagnostics::Collector diagnostics;
+		assert(!compact_task_file(&diagnostics));
+		
+		task_journal::append(_test_operations(), task_journal_filename, "tasks.txt", *task_snapshot::get_source_stamp("tasks.txt"));
+		assert(compact_task_file(&diagnostics));
+		assert(!std::filesystem::exists(task_journal_filename));
+		assert(_read_file("tasks.txt") == taskgroups_to_str(_test_taskgroups_after_operations()));
+		
+		//the journal of a task file changed outside of WorkTable is kept aside once loaded, rather than compacted or started over.
+		task_journal::append({task_journal::Operation::erase(0)}, task_journal_filename, "tasks.txt", *task_snapshot::get_source_stamp("tasks.txt"));
+		const std::string journal = _read_file(task_journal_filename);
+		std::ofstream("tasks.txt", std::ofstream::app) << "2025/01/01, added outside of WorkTable\n";
+		const std::string changed_task_file = _read_file("tasks.txt");
+		assert(!compact_task_file(&diagnostics));
+		assert(_read_file("tasks.txt") == changed_task_file);
+		
+		//a load for reading only stores the status instead, leaving the journal as is.
+		task_journal::ReplayStatus replay_status = task_journal::ReplayStatus::Replayed;
+		get_tasks_parallel(1, task_io_internal::default_nested_group_callback, &diagnostics, &replay_status);
+		assert(replay_status == task_journal::ReplayStatus::StaleJournal);
+		assert(_read_file(task_journal_filename) == journal);
+		assert(!std::filesystem::exists(task_journal::rejected_filename(task_journal_filename)));
+		
+		assert(!_test_alerted);
+		get_tasks(task_io_internal::default_nested_group_callback, &diagnostics);
+		assert(_test_alerted);
+		assert(!std::filesystem::exists(task_journal_filename));
+		assert(_read_file(task_journal::rejected_filename(task_journal_filename)) == journal);
+		assert(_read_file("tasks.txt") == changed_task_file);
+		assert(diagnostics.empty());
+		
+		//nor is the task file written for a batch cut short.
+		_test_alerted = false;
+		task_journal::append(_test_operations(), task_journal_filename, "tasks.txt", *task_snapshot::get_source_stamp("tasks.txt"));
+		const std::string incomplete_journal = _read_file(task_journal_filename);
+		std::filesystem::resize_file(task_journal_filename, incomplete_journal.size() - 1);
+		get_tasks(task_io_internal::default_nested_group_callback, &diagnostics, &replay_status);
+		assert(replay_status == task_journal::ReplayStatus::IncompleteBatch);
+		assert(_read_file(task_journal_filename) == incomplete_journal.substr(0, incomplete_journal.size() - 1));
+		assert(_read_file("tasks.txt") == changed_task_file);
+		assert(!_test_alerted);
+		
+		task_io_report::set_alert_function([](const char* const message){std::cerr << message << '\n';});
+		std::filesystem::current_path(working_directory);
+		std::filesystem::remove_all(directory);
+	}
+	
+	///A group of only invalid due dates is parsed without tasks. The indices appended by every session are of the groups without it, as they are replayed over.
+	inline void test_replay__group_without_tasks(){
+		const std::filesystem::path directory = std::filesystem::temp_directory_path();
+		const std::string task_filename = (directory / "worktable_test_journal_tasks.txt").string();
+		const std::string journal_filename = (directory / "worktable_test_journal_tasks.journal").string();
+		task_journal::remove(journal_filename);
+		
+		const std::string task_file = "bad{\n2024/13/40, x\n2024/14/40, y\n}\n2030/01/01, A\n2030/01/02, B\n2030/01/03, C\n";
+		std::ofstream(task_filename) << task_file;
+		const task_snapshot::SourceStamp loaded_source = *task_snapshot::get_source_stamp(task_filename);
+		
+		parse_diagnostics::Collector diagnostics;
+		const auto load = [&](){
+			TaskFileParser parser(task_io_internal::default_nested_group_callback, &diagnostics);
+			parser.feed(task_file.data(), task_file.size());
+			return task_journal::replay_file(parser.finish(), journal_filename, task_filename).taskgroups;
+		};
+		
+		//each session erases the first task of the groups it loaded.
+		const std::vector<TaskGroup> first_session = load();
+		assert(first_session == std::vector<TaskGroup>({
+			{"bad", {_test_task(2030, 1, 1, "A")}}, {"", {_test_task(2030, 1, 2, "B")}}, {"", {_test_task(2030, 1, 3, "C")}}
+		}));
+		task_journal::append({task_journal::Operation::erase(0)}, journal_filename, task_filename, loaded_source);
+		
+		const std::vector<TaskGroup> second_session = load();
+		assert(second_session == std::vector<TaskGroup>({{"", {_test_task(2030, 1, 2, "B")}}, {"", {_test_task(2030, 1, 3, "C")}}}));
+		task_journal::append({task_journal::Operation::erase(0)}, journal_filename, task_filename, loaded_source);
+		
+		assert(load() == std::vector<TaskGroup>({{"", {_test_task(2030, 1, 3, "C")}}}));
+		
+		task_journal::remove(journal_filename);
+		std::filesystem::remove(task_filename);
+	}
+}
+
+inline void test_suite_task_journal(){
+	test_task_journal_internal::test_encode_and_decode();
+	test_task_journal_internal::test_apply();
+	test_task_journal_internal::test_coalesce();
+	test_task_journal_internal::test_as_loaded_from_task_file();
+	test_task_journal_internal::test_append_and_replay();
+	test_task_journal_internal::test_replay__batch_with_invalid_index();
+	test_task_journal_internal::test_append__task_file_changed_between_appends();
+	test_task_journal_internal::test_replay__group_without_tasks();
+	test_task_journal_internal::test_compact_and_reject();
+}
+
+#endif
@@ -0,0 +1,127 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef test_task_snapshot_hpp
+#define test_task_snapshot_hpp
+
+#include "task_snapshot.hpp"
+#include "task_io.hpp"
+#include "time_calc.hpp"
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cassert>
+#include <fstream>
+#include <optional>
+#include <filesystem>
+
+namespace test_task_snapshot_internal{
+	inline Task _test_task(const int year, const unsigned month, const unsigned day, const std::string& name){
+		return Task(std::chrono::year_month_day(std::chrono::year(year), std::chrono::month(month), std::chrono::day(day)), name);
+	}
+	
+	inline std::vector<TaskGroup> _test_taskgroups(){
+		return {
+			{"group", {_test_task(2025, 5, 3, "cookies"), _test_task(2024, 12, 31, "")}},
+			{"single task group", {_test_task(2025, 1, 1, "waffles")}},
+			{"empty group", {}},
+			{"lent name", {_test_task(2026, 2, 28, "fries")}},
+			{"", {_test_task(2025, 6, 7, "tea"), _test_task(2025, 6, 8, "coffee")}},
+			{"trailing empty group", {}},
+		};
+	}
+	
+	///The groups as they are loaded from the task file written by overwrite_taskfile().
+	inline std::vector<TaskGroup> _test_loaded_from_text(const std::vector<TaskGroup>& taskgroups){
+		const std::string buffer = taskgroups_to_str(taskgroups);
+		TaskFileParser parser;
+		parser.feed(buffer.data(), buffer.size());
+		return parser.finish();
+	}
+	
+	inline void test_serialize(){
+		const task_snapshot::SourceStamp stamp = {1234, 5678};
+		const std::vector<TaskGroup> taskgroups = _test_taskgroups();
+		const std::string snapshot = task_snapshot::serialize(taskgroups, stamp);
+		
+		const std::optional<std::vector<TaskGroup>> loaded_taskgroups = task_snapshot::deserialize(snapshot, stamp, get_current_ymd());
+		assert(loaded_taskgroups.has_value());
+		assert(*loaded_taskgroups == _test_loaded_from_text(taskgroups));
+		
+		const std::vector<TaskGroup> no_taskgroups;
+		assert(task_snapshot::deserialize(task_snapshot::serialize(no_taskgroups, stamp), stamp, get_current_ymd())->empty());
+	}
+	
+	inline void test_serialize__task_file_loads_differently(){
+		const task_snapshot::SourceStamp stamp = {1234, 5678};
+		
+		const std::vector<TaskGroup> task_name_ending_with_group_definition = {{"", {_test_task(2025, 1, 1, "task{")}}};
+		const std::vector<TaskGroup> name_with_newline = {{"group\nname", {_test_task(2025, 1, 1, "a"), _test_task(2025, 1, 2, "b")}}};
+		const std::vector<TaskGroup> year_of_3_digits = {{"", {_test_task(999, 1, 1, "task")}}};
+		
+		assert(task_snapshot::serialize(task_name_ending_with_group_definition, stamp).empty());
+		assert(task_snapshot::serialize(name_with_newline, stamp).empty());
+		assert(task_snapshot::serialize(year_of_3_digits, stamp).empty());
+	}
+	
+	inline void test_deserialize__invalid_snapshot(){
+		const task_snapshot::SourceStamp stamp = {1234, 5678};
+		const std::string snapshot = task_snapshot::serialize(_test_taskgroups(), stamp);
+		const auto current_date = get_current_ymd();
+		
+		assert(!task_snapshot::deserialize(snapshot, {1234, 5679}, current_date).has_value());
+		assert(!task_snapshot::deserialize(snapshot, {1235, 5678}, current_date).has_value());
+		assert(!task_snapshot::deserialize(std::string_view(snapshot).substr(0, snapshot.size() - 1), stamp, current_date).has_value());
+		assert(!task_snapshot::deserialize(std::string_view(snapshot).substr(0, 4), stamp, current_date).has_value());
+		
+		//a single byte changed anywhere is caught, by either the header checks or the checksum.
+		for(std::size_t i = 0; i < snapshot.size(); ++i){
+			std::string corrupted_snapshot = snapshot;
+			corrupted_snapshot[i] ^= 0x20;
+			assert(!task_snapshot::deserialize(corrupted_snapshot, stamp, current_date).has_value());
+		}
+	}
+	
+	inline void test_save_and_load(){
+		const std::filesystem::path directory = std::filesystem::temp_directory_path();
+		const std::string task_filename = (directory / "worktable_test_snapshot_tasks.txt").string();
+		const std::string snapshot_filename = (directory / "worktable_test_snapshot_tasks.snapshot").string();
+		
+		const std::vector<TaskGroup> taskgroups = _test_taskgroups();
+		std::ofstream(task_filename) << taskgroups_to_str(taskgroups);
+		
+		task_snapshot::save(taskgroups, snapshot_filename, task_filename);
+		const std::optional<std::vector<TaskGroup>> loaded_taskgroups = task_snapshot::load(snapshot_filename, task_filename);
+		assert(loaded_taskgroups.has_value());
+		assert(*loaded_taskgroups == _test_loaded_from_text(taskgroups));
+		
+		//the task file changed after the snapshot was made.
+		std::ofstream(task_filename, std::ofstream::app) << "2025/01/01, added outside of WorkTable\n";
+		assert(!task_snapshot::load(snapshot_filename, task_filename).has_value());
+		
+		task_snapshot::remove(snapshot_filename);
+		assert(!std::filesystem::exists(snapshot_filename));
+		assert(!task_snapshot::load(snapshot_filename, task_filename).has_value());
+		
+		std::filesystem::remove(task_filename);
+	}
+}
+
+inline void test_suite_task_snapshot(){
+	test_task_snapshot_internal::test_serialize();
+	test_task_snapshot_internal::test_serialize__task_file_loads_differently();
+	test_task_snapshot_internal::test_deserialize__invalid_snapshot();
+	test_task_snapshot_internal::test_save_and_load();
+}
+
+#endif
@@ -0,0 +1,229 @@
+/*
+Copyright 2024 Pawikan Boonnaum.
+
+This file is part of WorkTable.
+
+WorkTable is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+
+WorkTable is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with WorkTable. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef test_task_store_hpp
+#define test_task_store_hpp
+
+#include "Task.hpp"
+#include "task_store.hpp"
+
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+
+namespace test_task_store_internal{
+	inline std::chrono::year_month_day _test_ymd(const int year, const unsigned month, const unsigned day){
+		return std::chrono::year_month_day(std::chrono::year(year), std::chrono::month(month), std::chrono::day(day));
+	}
+	
+	inline const std::chrono::year_month_day _test_current_ymd = _test_ymd(2025, 1, 1);
+	
+	inline Task _test_task(const unsigned day, const char* const name){
+		return Task(_test_ymd(2025, 1, day), name, _test_current_ymd);
+	}
+	
+	inline void test_groups(){
+		TaskStore store(_test_current_ymd);
+		const TaskStore::GroupId chores = store.add_group({"chores", {_test_task(9, "mop"), _test_task(3, "dishes"), _test_task(9, "dust")}});
+		const TaskStore::GroupId single = store.add_group({"single", {_test_task(5, "single")}});
+		assert(store.group_count() == 2 && store.task_count() == 4);
+		
+		//sorted by due date, the tasks with the same due date in the order they were added.
+		const TaskGroup expected_chores{"chores", {_test_task(3, "dishes"), _test_task(9, "mop"), _test_task(9, "dust")}};
+		assert(store.taskgroup(chores) == expected_chores);
+		assert(store.taskgroups({single, chores}) == std::vector<TaskGroup>({{"single", {_test_task(5, "single")}}, expected_chores}));
+		
+		const TaskStore::TaskId dishes = store.group_tasks(chores).front();
+		assert(store.name(dishes) == "dishes" && store.group_of(dishes) == chores);
+		assert(store.due_date(dishes) == _test_ymd(2025, 1, 3) && store.days_remaining(dishes) == std::chrono::days(2));
+		assert(store.task(dishes) == _test_task(3, "dishes"));
+		
+		store.rename_group(single, "renamed");
+		store.merge_groups(chores, single);
+		assert(store.group_tasks(single).empty() && store.group_name(single) == "renamed");
+		assert(store.taskgroup(chores) == TaskGroup({"chores", {_test_task(3, "dishes"), _test_task(5, "single"), _test_task(9, "mop"), _test_task(9, "dust")}}));
+		//the IDs stay the same when the tasks are moved.
+		assert(store.group_tasks(chores).front() == dishes);
+		
+		store.erase_group(single);
+		store.erase_group(chores);
+		assert(store.group_count() == 0 && store.task_count() == 0);
+	}
+	
+	inline void test_tasks(){
+		TaskStore store(_test_current_ymd);
+		const TaskStore::GroupId group = store.add_group({"group", {}});
+		const TaskStore::GroupId other_group = store.add_group({"other", {}});
+		
+		const TaskStore::TaskId a = store.add_task(group, _test_task(2, "a"));
+		const TaskStore::TaskId b = store.add_task(group, _test_task(4, "b"));
+		const TaskStore::TaskId c = store.add_task(group, _test_task(6, "c"));
+		
+		store.set_task(a, _test_ymd(2025, 1, 5), "a2");
+		assert(store.group_tasks(group) == std::vector<TaskStore::TaskId>({b, a, c}));
+		assert(store.name(a) == "a2" && store.days_remaining(a) == std::chrono::days(4));
+		
+		store.move_task(c, other_group);
+		assert(store.group_tasks(group) == std::vector<TaskStore::TaskId>({b, a}));
+		assert(store.group_tasks(other_group) == std::vector<TaskStore::TaskId>({c}) && store.group_of(c) == other_group);
+		
+		store.erase_task(b);
+		assert(store.group_tasks(group) == std::vector<TaskStore::TaskId>({a}) && store.task_count() == 2);
+		assert(!store.contains_task(b) && store.contains_task(a) && !store.contains_task(TaskStore::no_id));
+		//the ID of an erased task is reused, the others are left as is.
+		assert(store.add_task(other_group, _test_task(1, "d")) == b);
+		assert(store.taskgroup(other_group) == TaskGroup({"other", {_test_task(1, "d"), _test_task(6, "c")}}));
+		assert(store.name(a) == "a2" && store.name(c) == "c");
+		
+		store.erase_group(group);
+		assert(store.add_group({"reused", {}}) == group);
+		
+		store.clear();
+		assert(store.task_count() == 0 && store.group_count() == 0);
+		assert(store.add_group({"group", {_test_task(2, "a")}}) == 0);
+	}
+	
+	inline void test_handles(){
+		TaskStore store(_test_current_ymd);
+		const TaskStore::GroupId group = store.add_group({"group", {}});
+		const TaskStore::TaskId a = store.add_task(group, _test_task(2, "a"));
+		const TaskStore::TaskHandle a_handle = store.task_handle(a);
+		const TaskStore::GroupHandle group_handle = store.group_handle(group);
+		assert(store.find_task(a_handle) == a && store.find_group(group_handle) == group);
+		assert(store.find_task(TaskStore::TaskHandle()) == TaskStore::no_id && store.find_group(TaskStore::GroupHandle()) == TaskStore::no_id);
+		
+		//the ID is reused by another task, which the handle of the erased one does not find.
+		store.erase_task(a);
+		assert(store.find_task(a_handle) == TaskStore::no_id);
+		const TaskStore::TaskId b = store.add_task(group, _test_task(4, "b"));
+		assert(b == a && store.find_task(a_handle) == TaskStore::no_id && store.find_task(store.task_handle(b)) == b);
+		
+		store.erase_group(group);
+		assert(store.find_group(group_handle) == TaskStore::no_id && store.find_task(store.task_handle(b)) == TaskStore::no_id);
+		assert(store.add_group({"reused", {}}) == group && store.find_group(group_handle) == TaskStore::no_id);
+		
+		//as when a task file is reloaded, the IDs start over but the handles taken before are not found.
+		const TaskStore::TaskHandle c_handle = store.task_handle(store.add_task(group, _test_task(6, "c")));
+		store.clear();
+		const TaskStore::GroupId new_group = store.add_group({"group", {_test_task(6, "c")}});
+		assert(new_group == group_handle.id && store.group_tasks(new_group).front() == c_handle.id);
+		assert(store.find_group(group_handle) == TaskStore::no_id && store.find_task(c_handle) == TaskStore::no_id);
+	}
+	
+	/**
+	Runs random operations on a TaskStore and after each one, compares the tasks of every group against a plain model of the same tasks.
+	In the model, each task carries the order it was last placed into its group, so the expected order of a group is
+	by due date, then by that order; this is the order the store has to keep without sorting.
+	*/
+	inline void test_random_operations(){
+		struct ModelTask{
+			TaskStore::GroupId group;
+			unsigned day;
+			std::uint64_t placed;
+		};
+		
+		TaskStore store(_test_current_ymd);
+		std::vector<TaskStore::GroupId> groups;
+		std::vector<TaskStore::TaskId> tasks;
+		std::vector<ModelTask> model;
+		std::uint64_t placed_count = 0;
+		
+		std::mt19937 rng(20250101);
+		const auto random_index = [&rng](const std::size_t size){return std::uniform_int_distribution<std::size_t>(0, size - 1)(rng);};
+		//only 8 days, so that many tasks share a due date.
+		const auto random_day = [&rng](){return std::uniform_int_distribution<unsigned>(1, 8)(rng);};
+		
+		const auto check_invariants = [&](){
+			assert(store.group_count() == groups.size() && store.task_count() == tasks.size());
+			for(const TaskStore::GroupId group : groups){
+				std::vector<std::size_t> expected;
+				for(std::size_t i = 0; i < tasks.size(); ++i){
+					if(model[i].group == group) expected.push_back(i);
+				}
+				std::sort(expected.begin(), expected.end(), [&model](const std::size_t lhs, const std::size_t rhs){
+					return (model[lhs].day != model[rhs].day) ? (model[lhs].day < model[rhs].day) : (model[lhs].placed < model[rhs].placed);
+				});
+				
+				const std::vector<TaskStore::TaskId>& group_tasks = store.group_tasks(group);
+				assert(group_tasks.size() == expected.size());
+				for(std::size_t i = 0; i < expected.size(); ++i){
+					assert(group_tasks[i] == tasks[expected[i]]);
+					assert(store.group_of(group_tasks[i]) == group);
+					assert(store.due_date(group_tasks[i]) == _test_ymd(2025, 1, model[expected[i]].day));
+				}
+				
+				//the nearest and furthest tasks are the ends of the group.
+				if(!expected.empty()){
+					assert(store.days_remaining(group_tasks.front()) == std::chrono::days(model[expected.front()].day - 1));
+					assert(store.days_remaining(group_tasks.back()) == std::chrono::days(model[expected.back()].day - 1));
+				}
+			}
+		};
+		
+		for(int step = 0; step < 2000; ++step){
+			const unsigned operation = groups.empty() ? 0 : std::uniform_int_distribution<unsigned>(0, 9)(rng);
+			
+			if(operation == 0 || (operation == 9 && groups.size() < 2)){
+				groups.push_back(store.add_group({"group", {}}));
+			}else if(operation <= 4 || tasks.empty()){
+				const TaskStore::GroupId group = groups[random_index(groups.size())];
+				const unsigned day = random_day();
+				tasks.push_back(store.add_task(group, _test_task(day, "task")));
+				model.push_back({group, day, placed_count++});
+			}else if(operation == 5){
+				const std::size_t i = random_index(tasks.size());
+				store.erase_task(tasks[i]);
+				tasks.erase(tasks.begin() + i);
+				model.erase(model.begin() + i);
+			}else if(operation <= 7){
+				const std::size_t i = random_index(tasks.size());
+				model[i].day = random_day();
+				model[i].placed = placed_count++;
+				store.set_task(tasks[i], _test_ymd(2025, 1, model[i].day), "edited");
+				assert(store.name(tasks[i]) == "edited");
+			}else if(operation == 8){
+				const std::size_t i = random_index(tasks.size());
+				model[i].group = groups[random_index(groups.size())];
+				model[i].placed = placed_count++;
+				store.move_task(tasks[i], model[i].group);
+			}else{
+				const std::size_t from_index = random_index(groups.size());
+				const TaskStore::GroupId from = groups[from_index];
+				const TaskStore::GroupId into = groups[(from_index + 1 + random_index(groups.size() - 1)) % groups.size()];
+				
+				//the moved tasks are placed after the tasks of into, keeping their own order.
+				for(const TaskStore::TaskId task : store.group_tasks(from)){
+					const std::size_t i = std::find(tasks.begin(), tasks.end(), task) - tasks.begin();
+					model[i].group = into;
+					model[i].placed = placed_count++;
+				}
+				store.merge_groups(into, from);
+				store.erase_group(from);
+				groups.erase(groups.begin() + from_index);
+			}
+			
+			check_invariants();
+		}
+	}
+}
+
+inline void test_suite_task_store(){
+	test_task_store_internal::test_groups();
+	test_task_store_internal::test_tasks();
+	test_task_store_internal::test_handles();
+	test_task_store_internal::test_random_operations();
+}
+
+#endif